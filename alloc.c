@@ -0,0 +1,710 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif // __linux__
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif // _WIN32
+
+#include "alloc.h"
+#include "arena.h"
+#include "allocstats.h"
+
+
+/* free block of pool */
+typedef struct AllocBlock_tag
+{
+    struct AllocBlock_tag* next;
+} AllocBlock;
+
+/* chunk is aligned to its size, so start of chunk with owner is found by any block in it */
+typedef struct AllocChunk_tag
+{
+    struct AllocPool_tag*  pool;        /* owner of blocks */
+    struct AllocChunk_tag* next;        /* chunks of pool */
+} AllocChunk;
+
+/* pools of size classes of one thread */
+typedef struct AllocPool_tag
+{
+    AllocBlock*  free[ALLOC_CLASSES];
+    AllocBlock*  remote;                /* blocks freed in other threads, taken by owner at once */
+    char*        chunk;                 /* rest of newest chunk */
+    size_t       chunkLeft;
+    AllocChunk*  chunks;
+    size_t       used;                  /* blocks given out and not returned to pool */
+    struct AllocPool_tag* next;         /* pools of exited threads */
+} AllocPool;
+
+/* blocks of chunk start after its header */
+#define ALLOC_CHUNK_HEADER  ALLOC_MIN_CLASS
+
+static AllocDestructor allocDestructors[ALLOC_MAX_TYPES];
+static unsigned        allocTypeCount = ALLOC_TYPE_USER;
+
+/* pool of thread, after exit of thread with used blocks it waits for next thread */
+static __thread AllocPool* allocPool      = NULL;
+static AllocPool*          allocAbandoned = NULL;
+static bool                allocPoolLock  = false;
+
+#ifdef _WIN32
+static DWORD         allocPoolKey = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t allocPoolKey;
+static bool          allocPoolKeyValid = false;
+#endif // _WIN32
+
+
+#ifdef __ALLOC_STATS
+    #define AllocTakeSite() AllocStatsTakeSite()
+#else
+    #define AllocTakeSite() 0
+#endif // __ALLOC_STATS
+
+static inline size_t AllocClassSize (unsigned sizeClass)
+{
+    return (size_t)ALLOC_MIN_CLASS << sizeClass;
+}
+
+static inline void* AllocAlignedBlock (size_t align, size_t size)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, align);
+#else
+    void* ptr = NULL;
+    return (posix_memalign(&ptr, align, size) == 0) ? ptr : NULL;
+#endif // _WIN32
+}
+
+static inline void AllocAlignedBlockFree (void* ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif // _WIN32
+}
+
+static inline AllocChunk* AllocChunkOf (void* block)
+{
+    return (AllocChunk*)((uintptr_t)block & ~(uintptr_t)(ALLOC_CHUNK_SIZE - 1));
+}
+
+static inline void AllocPoolLock ()
+{
+    while (__atomic_test_and_set(&allocPoolLock, __ATOMIC_ACQUIRE))
+        ;
+}
+
+static inline void AllocPoolUnlock ()
+{
+    __atomic_clear(&allocPoolLock, __ATOMIC_RELEASE);
+}
+
+/* blocks freed by other threads go to free lists of owner */
+static void AllocPoolTakeRemote (AllocPool* pool)
+{
+    AllocBlock* block = __atomic_exchange_n(&pool->remote, NULL, __ATOMIC_ACQUIRE);
+    while (block)
+    {
+        AllocBlock* next = block->next;
+        unsigned sizeClass = ((AllocHeader*)block)->sizeClass;
+
+        block->next = pool->free[sizeClass];
+        pool->free[sizeClass] = block;
+        --pool->used;
+
+        block = next;
+    }
+}
+
+/* thread exits: pool without used blocks is freed, else next thread takes it */
+static void AllocPoolRelease (void* object)
+{
+    AllocPool* pool = object;
+    if (pool == NULL)
+        return;
+
+    if (allocPool == pool)
+        allocPool = NULL;
+
+    AllocPoolTakeRemote(pool);
+    if (pool->used == 0)
+    {
+        AllocChunk* chunk = pool->chunks;
+        while (chunk)
+        {
+            AllocChunk* next = chunk->next;
+            AllocAlignedBlockFree(chunk);
+            chunk = next;
+        }
+        free (pool);
+        return;
+    }
+
+    AllocPoolLock();
+    pool->next = allocAbandoned;
+    allocAbandoned = pool;
+    AllocPoolUnlock();
+}
+
+#ifdef _WIN32
+static void WINAPI AllocPoolExit (void* object)
+{
+    AllocPoolRelease(object);
+}
+#endif // _WIN32
+
+static void __attribute__((constructor)) AllocPoolRegister ()
+{
+#ifdef _WIN32
+    allocPoolKey = FlsAlloc(AllocPoolExit);
+#else
+    allocPoolKeyValid = (pthread_key_create(&allocPoolKey, AllocPoolRelease) == 0);
+#endif // _WIN32
+}
+
+/* pool of exited thread or new one */
+static AllocPool* AllocPoolAttach ()
+{
+    AllocPoolLock();
+    AllocPool* pool = allocAbandoned;
+    if (pool)
+        allocAbandoned = pool->next;
+    AllocPoolUnlock();
+
+    if (pool == NULL)
+    {
+        pool = calloc(1, sizeof(AllocPool));
+        if (pool == NULL)
+            return NULL;
+    }
+    pool->next = NULL;
+
+    /* pool is released at exit of thread */
+#ifdef _WIN32
+    if (allocPoolKey != FLS_OUT_OF_INDEXES)
+        FlsSetValue(allocPoolKey, pool);
+#else
+    if (allocPoolKeyValid)
+        pthread_setspecific(allocPoolKey, pool);
+#endif // _WIN32
+
+    allocPool = pool;
+    return pool;
+}
+
+static void* AllocFromPool (unsigned sizeClass)
+{
+    AllocPool* pool = allocPool;
+    if (pool == NULL && (pool = AllocPoolAttach()) == NULL)
+        return NULL;
+
+    AllocBlock* block = pool->free[sizeClass];
+    if (block == NULL && __atomic_load_n(&pool->remote, __ATOMIC_RELAXED))
+    {
+        AllocPoolTakeRemote(pool);
+        block = pool->free[sizeClass];
+    }
+    if (block)
+    {
+        pool->free[sizeClass] = block->next;
+        ++pool->used;
+        return block;
+    }
+
+    size_t size = AllocClassSize(sizeClass);
+    if (pool->chunkLeft < size)
+    {
+        /* rest of old chunk goes to pools of smaller blocks */
+        for (unsigned i = ALLOC_CLASSES; i > 0 && pool->chunkLeft >= ALLOC_MIN_CLASS; --i)
+        {
+            while (pool->chunkLeft >= AllocClassSize(i - 1))
+            {
+                block = (AllocBlock*)pool->chunk;
+                block->next = pool->free[i - 1];
+                pool->free[i - 1] = block;
+
+                pool->chunk     += AllocClassSize(i - 1);
+                pool->chunkLeft -= AllocClassSize(i - 1);
+            }
+        }
+
+        AllocChunk* chunk = AllocAlignedBlock(ALLOC_CHUNK_SIZE, ALLOC_CHUNK_SIZE);
+        if (chunk == NULL)
+        {
+            pool->chunkLeft = 0;
+            return NULL;
+        }
+        chunk->pool  = pool;
+        chunk->next  = pool->chunks;
+        pool->chunks = chunk;
+
+        pool->chunk     = (char*)chunk + ALLOC_CHUNK_HEADER;
+        pool->chunkLeft = ALLOC_CHUNK_SIZE - ALLOC_CHUNK_HEADER;
+    }
+
+    void* ptr = pool->chunk;
+    pool->chunk     += size;
+    pool->chunkLeft -= size;
+    ++pool->used;
+
+    return ptr;
+}
+
+/* block goes to pool of thread which took it */
+static void AllocToPool (AllocHeader* header)
+{
+    AllocBlock* block = (AllocBlock*)header;
+    AllocPool*  pool  = AllocChunkOf(block)->pool;
+
+    if (pool == allocPool)
+    {
+        block->next = pool->free[header->sizeClass];
+        pool->free[header->sizeClass] = block;
+        --pool->used;
+        return;
+    }
+
+    block->next = __atomic_load_n(&pool->remote, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&pool->remote, &block->next, block, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+}
+
+/* memory of aligned kinds starts pad bytes after start of block, header is in pad */
+static inline size_t AllocAlignedPad (unsigned alignLog)
+{
+    size_t align = (size_t)1 << alignLog;
+    return (sizeof(AllocHeader) + align - 1) & ~(align - 1);
+}
+
+/* bytes of mapping of huge pages */
+static inline size_t AllocHugeLength (size_t bytes)
+{
+    return (bytes + ALLOC_HUGE_PAGE - 1) & ~(size_t)(ALLOC_HUGE_PAGE - 1);
+}
+
+/* fill header in front of memory of new() */
+static void* AllocSetHeader (AllocHeader* header, unsigned type, size_t size,
+                             uint8_t kind, uint8_t sizeClass, unsigned site)
+{
+    header->size      = size;
+    header->magic     = ALLOC_MAGIC;
+    header->type      = type;
+    header->kind      = kind;
+    header->sizeClass = sizeClass;
+
+    #ifdef __ALLOC_STATS
+    header->site = site;
+    if (kind == ALLOC_KIND_ARENA)
+        AllocStatsRecordArenaAlloc(site, size);
+    else
+        AllocStatsRecordAlloc(site, size);
+    #else
+    (void)site;
+    #endif // __ALLOC_STATS
+
+    return header + 1;
+}
+
+static void* AllocMemoryZeroed (unsigned type, size_t size, size_t count, bool zeroed)
+{
+    unsigned site = AllocTakeSite();
+
+    if (size == 0 || count == 0 || count > (SIZE_MAX - sizeof(AllocHeader)) / size)
+        return NULL;
+
+    size *= count;
+    size_t total = sizeof(AllocHeader) + size;
+
+    AllocHeader* header = NULL;
+    uint8_t kind = ALLOC_KIND_POOL;
+    uint8_t sizeClass = 0;
+
+    Arena* arena = ArenaCurrent();
+    if (arena)
+    {
+        kind   = ALLOC_KIND_ARENA;
+        header = (zeroed) ? ArenaAlloc(arena, total) : ArenaAllocUninit(arena, total);
+    }
+    else
+    {
+        while (sizeClass < ALLOC_CLASSES && AllocClassSize(sizeClass) < total)
+            ++sizeClass;
+
+        if (sizeClass < ALLOC_CLASSES)
+        {
+            header = AllocFromPool(sizeClass);
+            if (header)
+                memset(header, 0, (zeroed) ? total : sizeof(AllocHeader));
+        }
+        else
+        {
+            kind   = ALLOC_KIND_HEAP;
+            header = (zeroed) ? calloc(1, total) : malloc(total);
+        }
+    }
+
+    if (header == NULL)
+        return NULL;
+
+    return AllocSetHeader(header, type, size, kind, sizeClass, site);
+}
+
+void* AllocMemoryAligned (unsigned type, size_t size, size_t count, size_t align)
+{
+    unsigned site = AllocTakeSite();
+
+    if (align < ALLOC_MIN_ALIGN)
+        align = ALLOC_MIN_ALIGN;
+    if ((align & (align - 1)) != 0 || align > ALLOC_HUGE_PAGE)
+        return NULL;
+
+    unsigned alignLog = __builtin_ctzll(align);
+    size_t pad = AllocAlignedPad(alignLog);
+    if (size == 0 || count == 0 || count > (SIZE_MAX - pad) / size)
+        return NULL;
+
+    size *= count;
+    char* block = AllocAlignedBlock(align, pad + size);
+    if (block == NULL)
+        return NULL;
+    memset(block + pad, 0, size);
+
+    AllocHeader* header = (AllocHeader*)(block + pad) - 1;
+    return AllocSetHeader(header, type, size, ALLOC_KIND_ALIGNED, alignLog, site);
+}
+
+void* AllocMemoryHuge (unsigned type, size_t size, size_t count, unsigned pages)
+{
+#ifdef __linux__
+    unsigned site = AllocTakeSite();
+
+    unsigned alignLog = __builtin_ctz(ALLOC_CACHE_LINE);
+    size_t pad = AllocAlignedPad(alignLog);
+    if (size == 0 || count == 0 || count > (SIZE_MAX - pad - 2 * ALLOC_HUGE_PAGE) / size)
+        return NULL;
+
+    size *= count;
+    size_t length = AllocHugeLength(pad + size);
+    char* base = MAP_FAILED;
+
+    #ifdef MAP_HUGETLB
+    if (pages == ALLOC_HUGE_EXPLICIT)
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    #endif // MAP_HUGETLB
+
+    if (base == MAP_FAILED)
+    {
+        /* transparent huge pages are used only for whole aligned pages */
+        char* map = mmap(NULL, length + ALLOC_HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED)
+            return NULL;
+
+        base = (char*)(((uintptr_t)map + ALLOC_HUGE_PAGE - 1) & ~(uintptr_t)(ALLOC_HUGE_PAGE - 1));
+        if (base > map)
+            munmap(map, base - map);
+        munmap(base + length, map + ALLOC_HUGE_PAGE - base);
+
+        #ifdef MADV_HUGEPAGE
+        madvise(base, length, MADV_HUGEPAGE);
+        #endif // MADV_HUGEPAGE
+    }
+
+    /* memory of mmap is zeroed */
+    AllocHeader* header = (AllocHeader*)(base + pad) - 1;
+    return AllocSetHeader(header, type, size, ALLOC_KIND_HUGE, alignLog, site);
+#else
+    (void)pages;
+    return AllocMemoryAligned(type, size, count, ALLOC_CACHE_LINE);
+#endif // __linux__
+}
+
+void* AllocMemory (unsigned type, size_t size, size_t count)
+{
+    return AllocMemoryZeroed(type, size, count, true);
+}
+
+void* AllocMemoryUninit (unsigned type, size_t size, size_t count)
+{
+    return AllocMemoryZeroed(type, size, count, false);
+}
+
+void AllocFree (void* ptr)
+{
+    if (!ptr)
+        return;
+
+    AllocHeader* header = (AllocHeader*)ptr - 1;
+    /* already freed? */
+    if (header->magic != ALLOC_MAGIC)
+        return;
+    header->magic = ALLOC_FREED;
+
+    #ifdef __ALLOC_STATS
+    /* memory of arena is not live memory of its site */
+    if (header->kind != ALLOC_KIND_ARENA)
+        AllocStatsRecordFree(header->site, header->size);
+    #endif // __ALLOC_STATS
+
+    switch (header->kind)
+    {
+        case ALLOC_KIND_POOL:
+            AllocToPool(header);
+            break;
+
+        case ALLOC_KIND_HEAP:
+            free (header);
+            break;
+
+        case ALLOC_KIND_ALIGNED:
+            AllocAlignedBlockFree((char*)ptr - AllocAlignedPad(header->sizeClass));
+            break;
+
+        #ifdef __linux__
+        case ALLOC_KIND_HUGE:
+        {
+            size_t pad = AllocAlignedPad(header->sizeClass);
+            munmap((char*)ptr - pad, AllocHugeLength(pad + header->size));
+            break;
+        }
+        #endif // __linux__
+
+        /* memory of arena is released with arena */
+        case ALLOC_KIND_ARENA:
+        default:
+            break;
+    }
+}
+
+void AllocDelete (void** ptr)
+{
+    if (!ptr || !(*ptr))
+        return;
+
+    /* header is only in front of memory of new(), deleted again it is ALLOC_FREED */
+    AllocHeader* header = (AllocHeader*)(*ptr) - 1;
+    if (header->magic == ALLOC_MAGIC)
+    {
+        AllocDestructor destructor = allocDestructors[header->type];
+        if (destructor)
+            destructor(*ptr);
+
+        AllocFree(*ptr);
+    }
+
+    *ptr = NULL;
+}
+
+unsigned AllocRegisterType (AllocDestructor destructor)
+{
+    unsigned type = __atomic_fetch_add(&allocTypeCount, 1, __ATOMIC_RELAXED);
+    if (type >= ALLOC_MAX_TYPES)
+        return ALLOC_TYPE_NONE;
+
+    allocDestructors[type] = destructor;
+    return type;
+}
+
+void AllocSetDestructor (unsigned type, AllocDestructor destructor)
+{
+    if (type > ALLOC_TYPE_NONE && type < ALLOC_MAX_TYPES)
+        allocDestructors[type] = destructor;
+}
+
+unsigned AllocGetType (const void* ptr)
+{
+    if (!ptr)
+        return ALLOC_TYPE_NONE;
+
+    return ((const AllocHeader*)ptr - 1)->type;
+}
+
+size_t AllocGetSize (const void* ptr)
+{
+    if (!ptr)
+        return 0;
+
+    return ((const AllocHeader*)ptr - 1)->size;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+static unsigned allocTestDestroyed = 0;
+
+static void AllocTestDestructor (void* object)
+{
+    allocTestDestroyed += *(int*)object;
+}
+
+#ifndef _WIN32
+typedef struct
+{
+    void*      blocks[16];
+    AllocPool* pool;
+    size_t     used;
+} AllocTestThreadData;
+
+/* takes blocks and exits, they are freed by main thread */
+static void* AllocTestOwner (void* arg)
+{
+    AllocTestThreadData* data = arg;
+    for (unsigned i = 0; i < 16; ++i)
+        data->blocks[i] = AllocMemory(ALLOC_TYPE_NONE, 100, 1);
+    data->pool = allocPool;
+    return NULL;
+}
+
+/* takes pool of exited thread with blocks freed in other thread */
+static void* AllocTestHeir (void* arg)
+{
+    AllocTestThreadData* data = arg;
+    void* block = AllocMemory(ALLOC_TYPE_NONE, 100, 1);
+    data->pool = allocPool;
+    AllocFree(block);
+    AllocPoolTakeRemote(allocPool);
+    data->used = allocPool->used;
+    return NULL;
+}
+#endif // _WIN32
+
+void AllocTest()
+{
+    printf ("Alloc's tests started!!!\n");
+
+    /* test1 : size classes and heap */
+    printf ("--------test1--------\n");
+    char* small = AllocMemory(ALLOC_TYPE_NONE, 1, 10);
+    char* big   = AllocMemory(ALLOC_TYPE_NONE, 1, 100000);
+    assert(small && big);
+    assert(((uintptr_t)small % 16) == 0 && ((uintptr_t)big % 16) == 0);
+    assert(AllocGetSize(small) == 10 && AllocGetSize(big) == 100000);
+    assert(((AllocHeader*)small - 1)->kind == ALLOC_KIND_POOL);
+    assert(((AllocHeader*)big - 1)->kind == ALLOC_KIND_HEAP);
+    assert(small[9] == 0 && big[99999] == 0);
+    assert(AllocMemory(ALLOC_TYPE_NONE, 4, 0) == NULL);
+    assert(AllocMemory(ALLOC_TYPE_NONE, SIZE_MAX / 2, 4) == NULL);
+    printf ("passed!\n");
+
+    /* test2 : freed blocks are reused zeroed */
+    printf ("--------test2--------\n");
+    memset(small, 1, 10);
+    AllocFree(small);
+    char* again = AllocMemory(ALLOC_TYPE_NONE, 1, 12);
+    assert(again == small);
+    assert(again[0] == 0);
+    AllocFree(again);
+    AllocFree(big);
+    printf ("passed!\n");
+
+    /* test3 : destructor of registered type */
+    printf ("--------test3--------\n");
+    unsigned type = AllocRegisterType(AllocTestDestructor);
+    assert(type >= ALLOC_TYPE_USER);
+    int* object = AllocMemory(type, sizeof(int), 1);
+    *object = 5;
+    assert(AllocGetType(object) == type);
+    int* copy = object;
+    AllocDelete((void**)&object);
+    assert(object == NULL);
+    assert(allocTestDestroyed == 5);
+    /* second delete of block of pool is ignored */
+    *copy = 6;
+    AllocDelete((void**)&copy);
+    assert(copy == NULL && allocTestDestroyed == 5);
+    printf ("passed!\n");
+
+    /* test4 : aligned memory */
+    printf ("--------test4--------\n");
+    size_t aligns[] = {1, 16, 64, 256, 4096};
+    for (unsigned i = 0; i < sizeof(aligns) / sizeof(aligns[0]); ++i)
+    {
+        float* floats = AllocMemoryAligned(ALLOC_TYPE_NONE, sizeof(float), 1000, aligns[i]);
+        assert(floats != NULL);
+        assert(((uintptr_t)floats % aligns[i]) == 0 && ((uintptr_t)floats % ALLOC_MIN_ALIGN) == 0);
+        assert(((AllocHeader*)floats - 1)->kind == ALLOC_KIND_ALIGNED);
+        assert(AllocGetSize(floats) == 1000 * sizeof(float));
+        assert(floats[0] == 0 && floats[999] == 0);
+        floats[999] = 1.0f;
+        AllocDelete((void**)&floats);
+        assert(floats == NULL);
+    }
+    assert(AllocMemoryAligned(ALLOC_TYPE_NONE, 4, 10, 48) == NULL);
+    assert(AllocMemoryAligned(ALLOC_TYPE_NONE, 4, 0, 64) == NULL);
+    object = AllocMemoryAligned(type, sizeof(int), 1, 64);
+    *object = 3;
+    AllocDelete((void**)&object);
+    assert(allocTestDestroyed == 8);
+    printf ("passed!\n");
+
+    /* test5 : huge pages */
+    printf ("--------test5--------\n");
+    for (unsigned pages = ALLOC_HUGE_TRANSPARENT; pages <= ALLOC_HUGE_EXPLICIT; ++pages)
+    {
+        size_t count = ALLOC_HUGE_PAGE / sizeof(float) + 1000;
+        float* floats = AllocMemoryHuge(ALLOC_TYPE_NONE, sizeof(float), count, pages);
+        assert(floats != NULL);
+        assert(((uintptr_t)floats % ALLOC_CACHE_LINE) == 0);
+        assert(AllocGetSize(floats) == count * sizeof(float));
+        for (size_t i = 0; i < count; ++i)
+            assert(floats[i] == 0);
+        floats[count - 1] = 1.0f;
+        AllocDelete((void**)&floats);
+        assert(floats == NULL);
+    }
+    printf ("passed!\n");
+
+#ifndef _WIN32
+    /* test6 : blocks freed in other thread return to pool of owner */
+    printf ("--------test6--------\n");
+    AllocTestThreadData owner = {0}, heir = {0};
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, AllocTestOwner, &owner) == 0);
+    pthread_join(thread, NULL);
+    assert(owner.pool != NULL && owner.pool != allocPool);
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        assert(AllocChunkOf(owner.blocks[i])->pool == owner.pool);
+        AllocFree(owner.blocks[i]);
+    }
+    assert(pthread_create(&thread, NULL, AllocTestHeir, &heir) == 0);
+    pthread_join(thread, NULL);
+    assert(heir.pool == owner.pool && heir.used == 0);
+    printf ("passed!\n");
+#endif // _WIN32
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all alloc's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,125 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __ALLOC_H
+#define __ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+#define ALLOC_MAGIC       0x436f624a    /* 'J' 'b' 'o' 'C' - header is valid */
+#define ALLOC_FREED       0x65657246    /* 'F' 'r' 'e' 'e' - memory is freed, header is kept by pool or arena */
+#define ALLOC_MAX_TYPES   256           /* count of types with destructors */
+#define ALLOC_MIN_CLASS   32            /* smallest block of pools with header */
+#define ALLOC_CLASSES     8             /* pools of 32, 64 ... 4096 bytes */
+#define ALLOC_CHUNK_SIZE  (64 * 1024)   /* pools take memory by chunks of this size aligned to it */
+#define ALLOC_MIN_ALIGN   16            /* alignment of every memory of new() */
+#define ALLOC_CACHE_LINE  64            /* alignment of memory in huge pages */
+#define ALLOC_HUGE_PAGE   (2 * 1024 * 1024)
+
+/* where memory is taken from */
+enum
+{
+    ALLOC_KIND_POOL = 0,                /* size-class pool of thread */
+    ALLOC_KIND_HEAP,                    /* calloc */
+    ALLOC_KIND_ARENA,                   /* current arena, released with it */
+    ALLOC_KIND_ALIGNED,                 /* aligned heap memory, sizeClass is log2 of alignment */
+    ALLOC_KIND_HUGE                     /* mmap in huge pages, sizeClass is log2 of alignment */
+};
+
+/* pages of AllocMemoryHuge */
+enum
+{
+    ALLOC_HUGE_TRANSPARENT = 0,         /* madvise of transparent huge pages */
+    ALLOC_HUGE_EXPLICIT                 /* reserved huge pages (MAP_HUGETLB), transparent ones if there are none */
+};
+
+/* types of objects, destructor of type is called by delete() */
+enum
+{
+    ALLOC_TYPE_NONE = 0,                /* plain memory */
+    ALLOC_TYPE_LIST,
+    ALLOC_TYPE_ULIST,
+    ALLOC_TYPE_TREELIST,
+    ALLOC_TYPE_VECTOR,
+    ALLOC_TYPE_ILIST,
+    ALLOC_TYPE_CLIST,
+    ALLOC_TYPE_STRING,
+    ALLOC_TYPE_WSTRING,
+    ALLOC_TYPE_STRBUILDER,
+    ALLOC_TYPE_ROPE,
+    ALLOC_TYPE_DICTIONARY,
+    ALLOC_TYPE_DEQUE,
+
+    ALLOC_TYPE_USER                     /* first type for AllocRegisterType */
+};
+
+/* header in front of every memory of new() */
+typedef struct
+{
+    size_t   size;                      /* requested bytes */
+    uint32_t magic;
+    uint16_t type;
+    uint8_t  kind;
+    uint8_t  sizeClass;                 /* pool for ALLOC_KIND_POOL */
+#ifdef __ALLOC_STATS
+    uint32_t site;                      /* call site of new() */
+    uint32_t reserved[3];               /* keeps size of header multiple of 16 */
+#endif // __ALLOC_STATS
+} AllocHeader;
+
+/* releases resources of object, memory of object itself is freed after it */
+typedef void (*AllocDestructor)(void* object);
+
+/** allocate zeroed memory for count objects of size bytes with header of type */
+void* AllocMemory (unsigned type, size_t size, size_t count);
+/** same as AllocMemory, but memory is not zeroed - for arrays which are filled at once */
+void* AllocMemoryUninit (unsigned type, size_t size, size_t count);
+/** allocate zeroed memory aligned to align bytes (power of two up to ALLOC_HUGE_PAGE),
+    it is taken from heap even if arena is current */
+void* AllocMemoryAligned (unsigned type, size_t size, size_t count, size_t align);
+/** allocate zeroed memory in huge pages aligned to ALLOC_CACHE_LINE, pages - ALLOC_HUGE_xxx.
+    Without mmap it is same as AllocMemoryAligned */
+void* AllocMemoryHuge (unsigned type, size_t size, size_t count, unsigned pages);
+/** return memory to its pool, heap or arena, destructor is not called */
+void AllocFree (void* ptr);
+/** call destructor of type of object, free memory and set pointer to NULL.
+    Only memory of new() or AllocMemory, memory of malloc is given to free() or XxxDestroy */
+void AllocDelete (void** ptr);
+
+/** register new type with destructor, return type or ALLOC_TYPE_NONE if table is full */
+unsigned AllocRegisterType (AllocDestructor destructor);
+/** set destructor of type */
+void AllocSetDestructor (unsigned type, AllocDestructor destructor);
+
+/** type of memory from AllocMemory */
+unsigned AllocGetType (const void* ptr);
+/** requested size of memory from AllocMemory */
+size_t AllocGetSize (const void* ptr);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void AllocTest();
+#endif // _DEBUG
+
+#endif // __ALLOC_H
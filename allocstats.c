@@ -0,0 +1,403 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "allocstats.h"
+
+/* counters of site in one thread */
+typedef struct
+{
+    uint64_t count;
+    uint64_t frees;
+    uint64_t bytes;
+    int64_t  liveBytes;
+    int64_t  peakBytes;
+    uint64_t arenaBytes;
+    uint64_t histogram[ALLOC_STATS_BUCKETS];
+} AllocSiteCounters;
+
+/* counters of thread, they are kept after end of thread for report */
+typedef struct AllocStatsThread_tag
+{
+    struct AllocStatsThread_tag* next;
+    AllocSiteCounters sites[ALLOC_STATS_MAX_SITES];
+} AllocStatsThread;
+
+typedef struct
+{
+    const char* file;
+    unsigned    line;
+    const char* type;
+} AllocSite;
+
+static AllocSite         allocSites[ALLOC_STATS_MAX_SITES] = {{"(AllocMemory without new)", 0, ""}};
+static unsigned          allocSiteCount    = 1;
+static AllocStatsThread* allocStatsThreads = NULL;
+static bool              allocStatsLock    = false;
+
+/* only owner thread writes its counters, report reads them without lock */
+static __thread AllocStatsThread* allocStatsLocal   = NULL;
+static __thread unsigned          allocStatsPending = 0;
+
+#define ALLOC_STATS_ADD(counter, value) \
+        __atomic_store_n(&(counter), (counter) + (value), __ATOMIC_RELAXED)
+
+
+static inline void AllocStatsLock ()
+{
+    while (__atomic_test_and_set(&allocStatsLock, __ATOMIC_ACQUIRE))
+        ;
+}
+
+static inline void AllocStatsUnlock ()
+{
+    __atomic_clear(&allocStatsLock, __ATOMIC_RELEASE);
+}
+
+unsigned AllocStatsSite (const char* file, unsigned line, const char* type)
+{
+    if (!file || !type)
+        return 0;
+
+    AllocStatsLock();
+
+    unsigned site = 1;
+    while (site < allocSiteCount &&
+           !(allocSites[site].line == line &&
+             strcmp(allocSites[site].file, file) == 0 &&
+             strcmp(allocSites[site].type, type) == 0))
+        ++site;
+
+    if (site == allocSiteCount)
+    {
+        if (site < ALLOC_STATS_MAX_SITES)
+        {
+            allocSites[site].file = file;
+            allocSites[site].line = line;
+            allocSites[site].type = type;
+            __atomic_store_n(&allocSiteCount, site + 1, __ATOMIC_RELEASE);
+        }
+        else
+            site = 0;
+    }
+
+    AllocStatsUnlock();
+
+    return site;
+}
+
+void AllocStatsSetSite (unsigned site)
+{
+    allocStatsPending = site;
+}
+
+unsigned AllocStatsTakeSite ()
+{
+    unsigned site = allocStatsPending;
+    allocStatsPending = 0;
+    return site;
+}
+
+size_t AllocStatsBucketSize (unsigned bucket)
+{
+    return (bucket < ALLOC_STATS_BUCKETS - 1) ? (size_t)16 << bucket : 0;
+}
+
+static inline unsigned AllocStatsBucket (size_t size)
+{
+    if (size <= 16)
+        return 0;
+
+    unsigned bucket = (unsigned)(sizeof(unsigned long long) * 8 - __builtin_clzll(size - 1)) - 4;
+    return (bucket < ALLOC_STATS_BUCKETS - 1) ? bucket : ALLOC_STATS_BUCKETS - 1;
+}
+
+static AllocSiteCounters* AllocStatsGetCounters (unsigned site)
+{
+    AllocStatsThread* thread = allocStatsLocal;
+    if (thread == NULL)
+    {
+        thread = calloc(1, sizeof(AllocStatsThread));
+        if (thread == NULL)
+            return NULL;
+
+        AllocStatsLock();
+        thread->next = allocStatsThreads;
+        __atomic_store_n(&allocStatsThreads, thread, __ATOMIC_RELEASE);
+        AllocStatsUnlock();
+
+        allocStatsLocal = thread;
+    }
+
+    return &thread->sites[(site < ALLOC_STATS_MAX_SITES) ? site : 0];
+}
+
+void AllocStatsRecordAlloc (unsigned site, size_t size)
+{
+    AllocSiteCounters* counters = AllocStatsGetCounters(site);
+    if (!counters)
+        return;
+
+    ALLOC_STATS_ADD(counters->count, 1);
+    ALLOC_STATS_ADD(counters->bytes, size);
+    ALLOC_STATS_ADD(counters->liveBytes, (int64_t)size);
+    ALLOC_STATS_ADD(counters->histogram[AllocStatsBucket(size)], 1);
+    if (counters->liveBytes > counters->peakBytes)
+        __atomic_store_n(&counters->peakBytes, counters->liveBytes, __ATOMIC_RELAXED);
+}
+
+void AllocStatsRecordArenaAlloc (unsigned site, size_t size)
+{
+    AllocSiteCounters* counters = AllocStatsGetCounters(site);
+    if (!counters)
+        return;
+
+    /* memory returns with arena, not by delete() - it is not live memory of site */
+    ALLOC_STATS_ADD(counters->count, 1);
+    ALLOC_STATS_ADD(counters->bytes, size);
+    ALLOC_STATS_ADD(counters->arenaBytes, size);
+    ALLOC_STATS_ADD(counters->histogram[AllocStatsBucket(size)], 1);
+}
+
+void AllocStatsRecordFree (unsigned site, size_t size)
+{
+    AllocSiteCounters* counters = AllocStatsGetCounters(site);
+    if (!counters)
+        return;
+
+    ALLOC_STATS_ADD(counters->frees, 1);
+    ALLOC_STATS_ADD(counters->liveBytes, -(int64_t)size);
+}
+
+void AllocStatsResetSite (unsigned site)
+{
+    if (site >= ALLOC_STATS_MAX_SITES)
+        return;
+
+    AllocStatsThread* thread = __atomic_load_n(&allocStatsThreads, __ATOMIC_ACQUIRE);
+    for (; thread; thread = thread->next)
+        memset(&thread->sites[site], 0, sizeof(AllocSiteCounters));
+}
+
+unsigned AllocStatsGetSites (AllocSiteStats* stats, unsigned maxCount)
+{
+    if (!stats)
+        return 0;
+
+    unsigned siteCount = __atomic_load_n(&allocSiteCount, __ATOMIC_ACQUIRE);
+    unsigned count = 0;
+
+    for (unsigned site = 0; site < siteCount && count < maxCount; ++site)
+    {
+        AllocSiteStats* s = &stats[count];
+        memset(s, 0, sizeof(AllocSiteStats));
+
+        AllocStatsThread* thread = __atomic_load_n(&allocStatsThreads, __ATOMIC_ACQUIRE);
+        for (; thread; thread = thread->next)
+        {
+            AllocSiteCounters* c = &thread->sites[site];
+            s->count     += __atomic_load_n(&c->count,     __ATOMIC_RELAXED);
+            s->frees     += __atomic_load_n(&c->frees,     __ATOMIC_RELAXED);
+            s->bytes     += __atomic_load_n(&c->bytes,     __ATOMIC_RELAXED);
+            s->liveBytes += __atomic_load_n(&c->liveBytes, __ATOMIC_RELAXED);
+            s->peakBytes += __atomic_load_n(&c->peakBytes, __ATOMIC_RELAXED);
+            s->arenaBytes += __atomic_load_n(&c->arenaBytes, __ATOMIC_RELAXED);
+            for (unsigned i = 0; i < ALLOC_STATS_BUCKETS; ++i)
+                s->histogram[i] += __atomic_load_n(&c->histogram[i], __ATOMIC_RELAXED);
+        }
+
+        if (s->count == 0 && s->frees == 0)
+            continue;
+
+        s->file = allocSites[site].file;
+        s->line = allocSites[site].line;
+        s->type = allocSites[site].type;
+        ++count;
+    }
+
+    return count;
+}
+
+static int AllocStatsCompare (const void* a, const void* b)
+{
+    uint64_t x = ((const AllocSiteStats*)a)->count;
+    uint64_t y = ((const AllocSiteStats*)b)->count;
+    return (x < y) - (x > y);
+}
+
+void AllocStatsDump (FILE* file)
+{
+    if (!file)
+        return;
+
+    AllocSiteStats* stats = malloc(sizeof(AllocSiteStats) * ALLOC_STATS_MAX_SITES);
+    if (stats == NULL)
+        return;
+
+    unsigned count = AllocStatsGetSites(stats, ALLOC_STATS_MAX_SITES);
+    qsort(stats, count, sizeof(AllocSiteStats), AllocStatsCompare);
+
+    fprintf(file, "alloc stats: %u sites\n", count);
+    fprintf(file, "%12s %12s %14s %14s %14s %14s  %s\n", "count", "frees", "live bytes", "peak bytes", "arena bytes", "total bytes", "site");
+    for (unsigned i = 0; i < count; ++i)
+    {
+        AllocSiteStats* s = &stats[i];
+        fprintf(file, "%12llu %12llu %14lld %14lld %14llu %14llu  ",
+                (unsigned long long)s->count, (unsigned long long)s->frees,
+                (long long)s->liveBytes, (long long)s->peakBytes,
+                (unsigned long long)s->arenaBytes, (unsigned long long)s->bytes);
+        if (s->line)
+            fprintf(file, "%s:%u new(%s)\n", s->file, s->line, s->type);
+        else
+            fprintf(file, "%s\n", s->file);
+
+        fprintf(file, "%12s sizes:", "");
+        for (unsigned b = 0; b < ALLOC_STATS_BUCKETS; ++b)
+        {
+            if (s->histogram[b] == 0)
+                continue;
+            if (AllocStatsBucketSize(b))
+                fprintf(file, " <=%zu x%llu", AllocStatsBucketSize(b), (unsigned long long)s->histogram[b]);
+            else
+                fprintf(file, " >%zu x%llu", AllocStatsBucketSize(b - 1), (unsigned long long)s->histogram[b]);
+        }
+        fprintf(file, "\n");
+    }
+
+    free(stats);
+}
+
+#ifdef __ALLOC_STATS
+static void AllocStatsReport ()
+{
+    AllocStatsDump(stderr);
+}
+
+static void __attribute__((constructor)) AllocStatsRegister ()
+{
+    atexit(AllocStatsReport);
+}
+#endif // __ALLOC_STATS
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#include "cext.h"
+
+static AllocSiteStats* AllocStatsTestFind (AllocSiteStats* stats, unsigned count, unsigned line, const char* type)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (stats[i].line == line && strcmp(stats[i].type, type) == 0)
+            return &stats[i];
+    }
+    return NULL;
+}
+
+void AllocStatsTest()
+{
+    printf ("AllocStats's tests started!!!\n");
+
+    AllocSiteStats* stats = malloc(sizeof(AllocSiteStats) * ALLOC_STATS_MAX_SITES);
+    unsigned count;
+
+    /* test1 : same site has same index */
+    printf ("--------test1--------\n");
+    unsigned site = AllocStatsSite("test.c", 10, "int, 4");
+    assert(site > 0);
+    assert(AllocStatsSite("test.c", 10, "int, 4") == site);
+    assert(AllocStatsSite("test.c", 11, "int, 4") != site);
+    assert(AllocStatsSite(NULL, 0, "int") == 0);
+    AllocStatsSetSite(site);
+    assert(AllocStatsTakeSite() == site);
+    assert(AllocStatsTakeSite() == 0);
+    printf ("passed!\n");
+
+    /* test2 : counters and histogram */
+    printf ("--------test2--------\n");
+    AllocStatsRecordAlloc(site, 16);
+    AllocStatsRecordAlloc(site, 100);
+    AllocStatsRecordAlloc(site, 1 << 20);
+    AllocStatsRecordFree(site, 1 << 20);
+    AllocStatsRecordAlloc(site, 17);
+    count = AllocStatsGetSites(stats, ALLOC_STATS_MAX_SITES);
+    AllocSiteStats* s = AllocStatsTestFind(stats, count, 10, "int, 4");
+    assert(s != NULL);
+    assert(s->count == 4 && s->frees == 1);
+    assert(s->bytes == 16 + 100 + (1 << 20) + 17);
+    assert(s->liveBytes == 16 + 100 + 17);
+    assert(s->peakBytes == 16 + 100 + (1 << 20));
+    assert(s->histogram[0] == 1 && s->histogram[1] == 1 && s->histogram[3] == 1);
+    assert(s->histogram[ALLOC_STATS_BUCKETS - 1] == 1);
+    assert(AllocStatsBucketSize(0) == 16 && AllocStatsBucketSize(ALLOC_STATS_BUCKETS - 1) == 0);
+    assert(AllocStatsTestFind(stats, count, 11, "int, 4") == NULL);
+    /* site of test is not shown in report at exit */
+    AllocStatsResetSite(site);
+    count = AllocStatsGetSites(stats, ALLOC_STATS_MAX_SITES);
+    assert(AllocStatsTestFind(stats, count, 10, "int, 4") == NULL);
+    printf ("passed!\n");
+
+    /* test3 : new and delete record their call sites */
+    printf ("--------test3--------\n");
+    #ifdef __ALLOC_STATS
+    unsigned line = __LINE__ + 3;
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        int* ints = new(int, 100);
+        List* list = (i & 1) ? new(List) : NULL;
+        delete(ints);
+        delete(list);
+    }
+    count = AllocStatsGetSites(stats, ALLOC_STATS_MAX_SITES);
+    s = AllocStatsTestFind(stats, count, line, "int, 100");
+    assert(s && s->count == 10 && s->frees == 10 && s->liveBytes == 0);
+    assert(s->peakBytes == 400 && s->histogram[5] == 10);
+    s = AllocStatsTestFind(stats, count, line + 1, "List");
+    assert(s && s->count == 5 && s->frees == 5 && s->bytes == 5 * sizeof(List));
+    /* memory of arena is not live, it returns with arena */
+    Arena* arena = ArenaCreate(0);
+    ARENA_SCOPE(arena)
+    {
+        line = __LINE__ + 1;
+        int* ints = new(int, 10);
+        delete(ints);
+    }
+    ArenaDestroy(&arena);
+    count = AllocStatsGetSites(stats, ALLOC_STATS_MAX_SITES);
+    s = AllocStatsTestFind(stats, count, line, "int, 10");
+    assert(s && s->count == 1 && s->frees == 0 && s->liveBytes == 0 && s->arenaBytes == 40);
+    /* new() without allocation does not give its site to next one */
+    assert(new(int, 0) == NULL);
+    assert(AllocStatsTakeSite() == 0);
+    #endif // __ALLOC_STATS
+    printf ("passed!\n");
+
+    free(stats);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all alloc stats's tests are passed!\n");
+}
+#endif // _DEBUG
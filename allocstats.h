@@ -0,0 +1,98 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __ALLOCSTATS_H
+#define __ALLOCSTATS_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+#define ALLOC_STATS_MAX_SITES 1024      /* call sites of new(), site 0 - memory not from new() */
+#define ALLOC_STATS_BUCKETS   16        /* sizes up to 16, 32 ... 256K bytes and bigger */
+
+/* counters of one call site, summed over threads */
+typedef struct
+{
+    const char* file;
+    unsigned    line;
+    const char* type;               /* arguments of new() */
+
+    uint64_t count;                 /* allocations */
+    uint64_t frees;
+    uint64_t bytes;                 /* bytes of all allocations */
+    int64_t  liveBytes;             /* allocated and not deleted yet */
+    int64_t  peakBytes;             /* max of liveBytes, with many threads - sum of max of every thread */
+    uint64_t arenaBytes;            /* allocated in arenas, they return with arena and are not in liveBytes */
+    uint64_t histogram[ALLOC_STATS_BUCKETS];
+} AllocSiteStats;
+
+/** return index of call site, same site gets same index (0 - table is full) */
+unsigned AllocStatsSite (const char* file, unsigned line, const char* type);
+/** next allocation of this thread belongs to site */
+void AllocStatsSetSite (unsigned site);
+/** take and forget site of next allocation of this thread */
+unsigned AllocStatsTakeSite ();
+
+/** count allocation and deletion of size bytes of site in counters of this thread */
+void AllocStatsRecordAlloc (unsigned site, size_t size);
+void AllocStatsRecordFree (unsigned site, size_t size);
+/** count allocation in arena, it is released with arena and is not counted as live */
+void AllocStatsRecordArenaAlloc (unsigned site, size_t size);
+
+/** zero counters of site in all threads, for tests - site must not be used meanwhile */
+void AllocStatsResetSite (unsigned site);
+
+/** copy counters of sites with allocations to stats, return count of copied sites */
+unsigned AllocStatsGetSites (AllocSiteStats* stats, unsigned maxCount);
+/** print sites sorted by count of allocations */
+void AllocStatsDump (FILE* file);
+/** upper bound of size in bytes of histogram bucket (0 - no bound) */
+size_t AllocStatsBucketSize (unsigned bucket);
+
+/** new() and delete() of cext.h record call sites when __ALLOC_STATS is defined,
+    report is printed to stderr at exit */
+#ifdef __ALLOC_STATS
+#define ALLOC_STATS_SITE(...)                                                           \
+        ({  static unsigned __alloc_site = 0;                                           \
+            unsigned __site = __atomic_load_n(&__alloc_site, __ATOMIC_RELAXED);         \
+            if (!__site)                                                                \
+            {                                                                           \
+                __site = AllocStatsSite(__FILE__, __LINE__, #__VA_ARGS__);              \
+                __atomic_store_n(&__alloc_site, __site, __ATOMIC_RELAXED);              \
+            }                                                                           \
+            AllocStatsSetSite(__site);                                                  \
+         })
+/* creator of new() may not allocate (e.g. for 0 objects), then site must not go to next allocation */
+#define ALLOC_STATS_SITE_END()  AllocStatsSetSite(0)
+#else
+#define ALLOC_STATS_SITE(...)
+#define ALLOC_STATS_SITE_END()
+#endif // __ALLOC_STATS
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void AllocStatsTest();
+#endif // _DEBUG
+
+#endif // __ALLOCSTATS_H
@@ -0,0 +1,279 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "arena.h"
+
+/* blocks grow twice up to this size */
+#define ARENA_MAX_BLOCK_SIZE (ARENA_BLOCK_SIZE * 1024)
+
+/* allocations start after header of block */
+#define ARENA_HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+static inline char* ArenaBlockData (ArenaBlock* block)
+{
+    return (char*)block + ARENA_HEADER_SIZE;
+}
+
+/* stack of current arenas of thread */
+static __thread Arena*   arenaStack[ARENA_MAX_DEPTH];
+static __thread unsigned arenaDepth = 0;
+
+
+Arena* ArenaCreate (size_t blockSize)
+{
+    Arena* arena = calloc(1, sizeof(Arena));
+    if (arena == NULL)
+        return NULL;
+
+    arena->blockSize = (blockSize) ? blockSize : ARENA_BLOCK_SIZE;
+
+    return arena;
+}
+
+void ArenaDestroy (Arena** arena)
+{
+    if (!arena || !(*arena))
+        return;
+
+    ArenaBlock* block = (**arena).first;
+    while (block)
+    {
+        ArenaBlock* next = block->next;
+        free (block);
+        block = next;
+    }
+
+    free (*arena);
+    *arena = NULL;
+}
+
+void ArenaReset (Arena* arena)
+{
+    if (!arena)
+        return;
+
+    for (ArenaBlock* block = arena->first; block; block = block->next)
+        block->used = 0;
+
+    arena->current = arena->first;
+}
+
+void* ArenaAllocUninit (Arena* arena, size_t size)
+{
+    if (!arena || size == 0)
+        return NULL;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    /* blocks after current one are free since last reset */
+    ArenaBlock* last  = NULL;
+    ArenaBlock* block = arena->current;
+    while (block && block->used + size > block->size)
+    {
+        last  = block;
+        block = block->next;
+    }
+
+    if (block == NULL)
+    {
+        size_t blockSize = arena->blockSize;
+        while (blockSize < size)
+            blockSize *= 2;
+
+        block = malloc(ARENA_HEADER_SIZE + blockSize);
+        if (block == NULL)
+            return NULL;
+
+        block->next = NULL;
+        block->size = blockSize;
+        block->used = 0;
+
+        if (last)
+            last->next = block;
+        else
+            arena->first = block;
+
+        if (blockSize < ARENA_MAX_BLOCK_SIZE)
+            arena->blockSize = blockSize * 2;
+    }
+    arena->current = block;
+
+    void* ptr = ArenaBlockData(block) + block->used;
+    block->used += size;
+
+    return ptr;
+}
+
+void* ArenaAlloc (Arena* arena, size_t size)
+{
+    void* ptr = ArenaAllocUninit(arena, size);
+    if (ptr)
+        memset(ptr, 0, size);
+
+    return ptr;
+}
+
+bool ArenaOwns (Arena* arena, const void* ptr)
+{
+    if (!arena || !ptr)
+        return false;
+
+    for (ArenaBlock* block = arena->first; block; block = block->next)
+    {
+        const char* data = ArenaBlockData(block);
+        if ((const char*)ptr >= data && (const char*)ptr < data + block->size)
+            return true;
+    }
+
+    return false;
+}
+
+bool ArenaPush (Arena* arena)
+{
+    if (!arena || arenaDepth >= ARENA_MAX_DEPTH)
+        return false;
+
+    arenaStack[arenaDepth++] = arena;
+    return true;
+}
+
+void ArenaPop ()
+{
+    if (arenaDepth > 0)
+        --arenaDepth;
+}
+
+Arena* ArenaCurrent ()
+{
+    return (arenaDepth) ? arenaStack[arenaDepth - 1] : NULL;
+}
+
+Arena* ArenaFind (const void* ptr)
+{
+    for (unsigned i = arenaDepth; i > 0; --i)
+    {
+        if (ArenaOwns(arenaStack[i - 1], ptr))
+            return arenaStack[i - 1];
+    }
+
+    return NULL;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#include "cext.h"
+
+void ArenaTest()
+{
+    printf ("Arena's tests started!!!\n");
+
+    Arena* arena = ArenaCreate(1024);
+
+    /* test1 : allocations are aligned and zeroed */
+    printf ("--------test1--------\n");
+    char* a = ArenaAlloc(arena, 3);
+    char* b = ArenaAlloc(arena, 100);
+    assert(a && b && a != b);
+    assert(((uintptr_t)b % ARENA_ALIGN) == 0);
+    assert(b[0] == 0 && b[99] == 0);
+    assert(ArenaOwns(arena, b));
+    assert(ArenaAlloc(arena, 0) == NULL);
+    printf ("passed!\n");
+
+    /* test2 : big allocations make new blocks */
+    printf ("--------test2--------\n");
+    char* big = ArenaAlloc(arena, 5000);
+    assert(big != NULL);
+    assert(ArenaOwns(arena, big + 4999));
+    assert(arena->first->next != NULL);
+    printf ("passed!\n");
+
+    /* test3 : reset keeps memory */
+    printf ("--------test3--------\n");
+    memset(a, 1, 3);
+    ArenaReset(arena);
+    char* c = ArenaAlloc(arena, 3);
+    assert(c == a);
+    assert(c[0] == 0);
+    printf ("passed!\n");
+
+    /* test4 : new() in arena */
+    printf ("--------test4--------\n");
+    int* ints = NULL;
+    List* list = NULL;
+    ARENA_SCOPE(arena)
+    {
+        assert(ArenaCurrent() == arena);
+        ints = new(int, 100);
+        assert(ArenaOwns(arena, ints));
+        list = new(List);
+        assert(ArenaOwns(arena, list));
+        for (int i = 0; i < 100; ++i)
+            list->push_back(list, &ints[i]);
+        assert(ArenaOwns(arena, list->first));
+        assert(list->at(list, 50) == &ints[50]);
+        list->pop_back(list);
+        float* aligned = new_aligned(float, 100, 64);
+        assert(!ArenaOwns(arena, aligned) && ((uintptr_t)aligned % 64) == 0);
+        delete(aligned);
+        assert(aligned == NULL);
+        delete(ints);
+        assert(ints == NULL);
+        delete(list);
+        assert(list == NULL);
+    }
+    assert(ArenaCurrent() == NULL);
+    /* scope without room for arena keeps arenas of caller */
+    Arena* other = ArenaCreate(0);
+    for (unsigned i = 0; i < ARENA_MAX_DEPTH; ++i)
+        assert(ArenaPush(arena));
+    ARENA_SCOPE(other)
+    {
+        assert(ArenaCurrent() == arena);
+    }
+    for (unsigned i = 1; i < ARENA_MAX_DEPTH; ++i)
+        ArenaPop();
+    assert(ArenaCurrent() == arena);
+    ArenaPop();
+    assert(ArenaCurrent() == NULL);
+    ArenaDestroy(&other);
+    ints = new(int, 10);
+    assert(!ArenaOwns(arena, ints));
+    delete(ints);
+    printf ("passed!\n");
+
+    /* test5 : destroy */
+    printf ("--------test5--------\n");
+    ArenaDestroy(&arena);
+    assert(arena == NULL);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all arena's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,87 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define ARENA_BLOCK_SIZE (64 * 1024)    /* bytes in first block of arena */
+#define ARENA_ALIGN      16             /* alignment of every allocation */
+#define ARENA_MAX_DEPTH  16             /* max count of nested current arenas */
+
+/* block of memory, allocations are cut from it one by one */
+typedef struct ArenaBlock_tag
+{
+    struct ArenaBlock_tag* next;
+    size_t size;                /* bytes for allocations */
+    size_t used;
+} ArenaBlock;
+
+/* region of memory - many allocations, one reset */
+typedef struct
+{
+    ArenaBlock* first;
+    ArenaBlock* current;        /* allocations are taken from it */
+    size_t      blockSize;      /* size of next new block */
+} Arena;
+
+/** make arena current for new() in this thread until end of block:
+        ARENA_SCOPE(arena)
+        {
+            int* tmp = new(int, 100);
+        }
+    Block must end normally - break, return or goto out of it leave arena current.
+    If arena can not be pushed (too deep) the block runs with previous current arena */
+#define ARENA_SCOPE(arena)                                                          \
+        for (bool __arena_pushed = ArenaPush(arena), __arena_scope = true;          \
+             __arena_scope;                                                         \
+             __arena_scope = false, (__arena_pushed) ? ArenaPop() : (void)0)
+
+/** create arena, blockSize - size of first block (0 - default) */
+Arena* ArenaCreate (size_t blockSize);
+/** free all memory of arena */
+void ArenaDestroy (Arena** arena);
+/** release all allocations at once, memory is kept for next ones */
+void ArenaReset (Arena* arena);
+
+/** allocate zeroed memory in arena */
+void* ArenaAlloc (Arena* arena, size_t size);
+/** allocate memory in arena without zeroing */
+void* ArenaAllocUninit (Arena* arena, size_t size);
+/** check that memory is allocated in arena */
+bool ArenaOwns (Arena* arena, const void* ptr);
+
+/** make arena current for new() in this thread */
+bool ArenaPush (Arena* arena);
+/** restore previous current arena */
+void ArenaPop ();
+/** current arena of this thread or NULL */
+Arena* ArenaCurrent ();
+/** find current or previous current arena of this thread with memory */
+Arena* ArenaFind (const void* ptr);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void ArenaTest();
+#endif // _DEBUG
+
+#endif // __ARENA_H
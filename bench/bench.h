@@ -0,0 +1,292 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif // __linux__
+
+/* monotonic time in nanoseconds */
+static inline uint64_t BenchNow (void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* xorshift generator, so every run uses the same sequence */
+static inline uint32_t BenchRandom (uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/* keep result of benchmarked code alive */
+#define BenchUse(X) __asm__ __volatile__ ("" : : "g"(X) : "memory")
+
+
+/* STATISTICS */
+/* summary of samples of one measurement, in nanoseconds per operation */
+typedef struct
+{
+    double   min;
+    double   median;
+    double   p99;
+    double   mean;
+    unsigned count;
+} BenchStats;
+
+static inline int BenchCompareDouble (const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* samples are sorted, p99 is nearest rank */
+static inline BenchStats BenchStatsCompute (double* samples, unsigned count)
+{
+    BenchStats stats = {0};
+    if (count == 0)
+        return stats;
+
+    qsort(samples, count, sizeof(double), BenchCompareDouble);
+
+    double sum = 0;
+    for (unsigned i = 0; i < count; ++i)
+        sum += samples[i];
+
+    unsigned rank = (count * 99 + 99) / 100;
+    stats.min    = samples[0];
+    stats.median = (count & 1) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+    stats.p99    = samples[rank - 1];
+    stats.mean   = sum / count;
+    stats.count  = count;
+
+    return stats;
+}
+
+
+/* HARDWARE COUNTERS */
+/* cycles and cache misses through perf_event_open, disabled if kernel does not allow */
+typedef struct
+{
+    bool     enabled;
+    int      cyclesFd;
+    int      missesFd;
+    uint64_t cycles;            /* values of last BenchCountersStop */
+    uint64_t misses;
+} BenchCounters;
+
+#ifdef __linux__
+static inline int BenchCounterOpen (uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static inline uint64_t BenchCounterRead (int fd)
+{
+    uint64_t value = 0;
+    if (read(fd, &value, sizeof(value)) != sizeof(value))
+        return 0;
+    return value;
+}
+#endif // __linux__
+
+/* return false if counters are not available */
+static inline bool BenchCountersOpen (BenchCounters* counters)
+{
+    counters->enabled  = false;
+    counters->cyclesFd = -1;
+    counters->missesFd = -1;
+    counters->cycles   = 0;
+    counters->misses   = 0;
+
+    #ifdef __linux__
+    counters->cyclesFd = BenchCounterOpen(PERF_COUNT_HW_CPU_CYCLES);
+    counters->missesFd = BenchCounterOpen(PERF_COUNT_HW_CACHE_MISSES);
+    if (counters->cyclesFd < 0 || counters->missesFd < 0)
+    {
+        if (counters->cyclesFd >= 0)
+            close(counters->cyclesFd);
+        if (counters->missesFd >= 0)
+            close(counters->missesFd);
+        counters->cyclesFd = counters->missesFd = -1;
+        return false;
+    }
+    counters->enabled = true;
+    #endif // __linux__
+
+    return counters->enabled;
+}
+
+static inline void BenchCountersClose (BenchCounters* counters)
+{
+    #ifdef __linux__
+    if (counters->enabled)
+    {
+        close(counters->cyclesFd);
+        close(counters->missesFd);
+    }
+    #endif // __linux__
+    counters->enabled = false;
+}
+
+static inline void BenchCountersStart (BenchCounters* counters)
+{
+    #ifdef __linux__
+    if (counters->enabled)
+    {
+        ioctl(counters->cyclesFd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->missesFd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->cyclesFd, PERF_EVENT_IOC_ENABLE, 0);
+        ioctl(counters->missesFd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    #else
+    (void)counters;
+    #endif // __linux__
+}
+
+static inline void BenchCountersStop (BenchCounters* counters)
+{
+    #ifdef __linux__
+    if (counters->enabled)
+    {
+        ioctl(counters->cyclesFd, PERF_EVENT_IOC_DISABLE, 0);
+        ioctl(counters->missesFd, PERF_EVENT_IOC_DISABLE, 0);
+        counters->cycles = BenchCounterRead(counters->cyclesFd);
+        counters->misses = BenchCounterRead(counters->missesFd);
+    }
+    #else
+    (void)counters;
+    #endif // __linux__
+}
+
+
+/* REPORT */
+typedef enum
+{
+    BENCH_FORMAT_TEXT,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+} BenchFormat;
+
+/* one row of report, cycles and misses are per operation (negative - not measured) */
+typedef struct
+{
+    const char* container;
+    const char* operation;
+    const char* distribution;
+    unsigned    size;
+    BenchStats  stats;
+    double      cycles;
+    double      misses;
+} BenchResult;
+
+static inline void BenchReportBegin (BenchFormat format)
+{
+    switch (format)
+    {
+        case BENCH_FORMAT_CSV:
+            printf("container,operation,distribution,size,runs,min_ns,median_ns,p99_ns,mean_ns,cycles,cache_misses\n");
+            break;
+        case BENCH_FORMAT_JSON:
+            printf("[");
+            break;
+        default:
+            printf("%-10s %-16s %-10s %10s %10s %10s %10s %10s %10s\n",
+                   "container", "operation", "values", "size", "min", "median", "p99", "cycles", "misses");
+            break;
+    }
+}
+
+/* number - index of row from 0 */
+static inline void BenchReportRow (BenchFormat format, unsigned number, const BenchResult* result)
+{
+    const BenchStats* stats = &result->stats;
+
+    switch (format)
+    {
+        case BENCH_FORMAT_CSV:
+            printf("%s,%s,%s,%u,%u,%.2f,%.2f,%.2f,%.2f,",
+                   result->container, result->operation, result->distribution, result->size,
+                   stats->count, stats->min, stats->median, stats->p99, stats->mean);
+            if (result->cycles >= 0)
+                printf("%.2f,%.4f\n", result->cycles, result->misses);
+            else
+                printf(",\n");
+            break;
+
+        case BENCH_FORMAT_JSON:
+            printf("%s\n  {\"container\": \"%s\", \"operation\": \"%s\", \"distribution\": \"%s\", \"size\": %u, "
+                   "\"runs\": %u, \"min_ns\": %.2f, \"median_ns\": %.2f, \"p99_ns\": %.2f, \"mean_ns\": %.2f",
+                   (number) ? "," : "",
+                   result->container, result->operation, result->distribution, result->size,
+                   stats->count, stats->min, stats->median, stats->p99, stats->mean);
+            if (result->cycles >= 0)
+                printf(", \"cycles\": %.2f, \"cache_misses\": %.4f}", result->cycles, result->misses);
+            else
+                printf(", \"cycles\": null, \"cache_misses\": null}");
+            break;
+
+        default:
+            printf("%-10s %-16s %-10s %10u %10.1f %10.1f %10.1f ",
+                   result->container, result->operation, result->distribution, result->size,
+                   stats->min, stats->median, stats->p99);
+            if (result->cycles >= 0)
+                printf("%10.1f %10.3f\n", result->cycles, result->misses);
+            else
+                printf("%10s %10s\n", "-", "-");
+            break;
+    }
+    fflush(stdout);
+}
+
+static inline void BenchReportEnd (BenchFormat format)
+{
+    if (format == BENCH_FORMAT_JSON)
+        printf("\n]\n");
+}
+
+#endif // __BENCH_H
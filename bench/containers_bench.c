@@ -0,0 +1,597 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+/*
+    Suite of containers for tracking of regressions between releases:
+    push_back, pop_back, at, search, delete by value, clear, destroy of
+    List, UList, TreeList and Vector, and new()/delete() of objects.
+
+    Every case is measured on some sizes and distributions of values,
+    after warm-up runs, and reported as min/median/p99 of ns per operation.
+    With --perf cycles and cache misses per operation are read through perf_event_open
+    (kernel.perf_event_paranoid must allow it, else columns are empty).
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. containers_bench.c ../list.c ../ulist.c ../treelist.c ../vector.c ../ilist.c ../clist.c ../str.c ../strbuilder.c ../rope.c ../intern.c ../utf8.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c -o containers_bench -lpthread
+
+    Usage:
+        containers_bench [--format text|csv|json] [--runs N] [--warmup N] [--sizes N,N,...]
+                         [--filter TEXT] [--seed N] [--cpu N] [--perf]
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif // __linux__
+
+#include "bench.h"
+#include "cext.h"
+
+#define BENCH_RUNS      11          /* measured runs of every case */
+#define BENCH_WARMUP    2           /* runs before measurement */
+#define BENCH_MIN_OPS   100000      /* one run repeats case until this count of operations ... */
+#define BENCH_RUN_NS    (20 * 1000000ull)   /* ... or this time with setup of case */
+#define BENCH_QUERIES   4096        /* max count of at, search and delete in one run */
+#define BENCH_WORK      4000000     /* max count of visited elements by linear operations in one run */
+#define BENCH_MAX_SIZES 16
+
+/* options of command line */
+typedef struct
+{
+    BenchFormat format;
+    unsigned    runs;
+    unsigned    warmup;
+    unsigned    sizes[BENCH_MAX_SIZES];
+    unsigned    sizeCount;
+    const char* filter;
+    uint32_t    seed;
+    int         cpu;
+    bool        perf;
+} BenchOptions;
+
+/* values for one size and distribution */
+typedef struct
+{
+    const char* distribution;
+    unsigned    size;
+    void**      values;         /* in order of adding */
+    unsigned*   numbers;        /* positions for at */
+    void**      queries;        /* values for search */
+    void**      victims;        /* different values for delete */
+    unsigned    queryCount;
+} BenchData;
+
+/* time and counters of timed parts of one run */
+typedef struct
+{
+    BenchCounters* counters;
+    uint64_t       start;
+    uint64_t       elapsed;
+    uint64_t       cycles;
+    uint64_t       misses;
+} BenchTimer;
+
+static inline void BenchTimerStart (BenchTimer* timer)
+{
+    BenchCountersStart(timer->counters);
+    timer->start = BenchNow();
+}
+
+static inline void BenchTimerStop (BenchTimer* timer)
+{
+    timer->elapsed += BenchNow() - timer->start;
+    BenchCountersStop(timer->counters);
+    timer->cycles += timer->counters->cycles;
+    timer->misses += timer->counters->misses;
+}
+
+
+/* CONTAINERS */
+/* container with same signatures of methods */
+typedef struct
+{
+    const char* name;
+    bool        linearAt;       /* at walks elements */
+    void* (*create) (void);
+    void  (*destroy)(void* container);
+    bool  (*add)    (void* container, void* value);
+    void  (*pop)    (void* container);
+    void* (*at)     (void* container, unsigned number);
+    int   (*find)   (void* container, void* value);
+    void  (*remove) (void* container, void* value);
+    void  (*clear)  (void* container);
+} BenchContainer;
+
+#define BENCH_CONTAINER(T)                                                                          \
+        static void* T##BenchCreate (void)                    { return T##Create(); }               \
+        static void  T##BenchDestroy (void* c)                { T* t = c; T##Destroy(&t); }         \
+        static bool  T##BenchAdd (void* c, void* value)       { return T##AddElement(c, value); }   \
+        static void  T##BenchPop (void* c)                    { T##PopBack(c); }                    \
+        static void* T##BenchAt (void* c, unsigned number)    { return T##GetValueByNumber(c, number); } \
+        static int   T##BenchFind (void* c, void* value)      { return T##GetNumberByValue(c, value); }  \
+        static void  T##BenchRemove (void* c, void* value)    { T##DeleteElementByValue(c, value); } \
+        static void  T##BenchClear (void* c)                  { T##Clear(c); }
+
+#define BENCH_CONTAINER_DESC(T, LINEAR_AT)                                                          \
+        { #T, LINEAR_AT, T##BenchCreate, T##BenchDestroy, T##BenchAdd, T##BenchPop,                 \
+          T##BenchAt, T##BenchFind, T##BenchRemove, T##BenchClear }
+
+BENCH_CONTAINER(List)
+BENCH_CONTAINER(UList)
+BENCH_CONTAINER(TreeList)
+BENCH_CONTAINER(Vector)
+
+static const BenchContainer benchContainers[] =
+{
+    BENCH_CONTAINER_DESC(List,     true),
+    BENCH_CONTAINER_DESC(UList,    true),
+    BENCH_CONTAINER_DESC(TreeList, false),
+    BENCH_CONTAINER_DESC(Vector,   false)
+};
+
+
+/* CASES */
+/* run case once, return count of operations in timed parts */
+typedef unsigned (*BenchCase)(const BenchContainer* c, const BenchData* data, BenchTimer* timer);
+
+static void* BenchFill (const BenchContainer* c, const BenchData* data)
+{
+    void* container = c->create();
+    for (unsigned i = 0; i < data->size; ++i)
+        c->add(container, data->values[i]);
+    return container;
+}
+
+/* count of queries for operations with cost of size */
+static unsigned BenchLinearCount (const BenchData* data)
+{
+    unsigned count = BENCH_WORK / data->size;
+    if (count < 16)
+        count = 16;
+    return (count < data->queryCount) ? count : data->queryCount;
+}
+
+static unsigned BenchPushBack (const BenchContainer* c, const BenchData* data, BenchTimer* timer)
+{
+    void* container = c->create();
+    BenchTimerStart(timer);
+    for (unsigned i = 0; i < data->size; ++i)
+        c->add(container, data->values[i]);
+    BenchTimerStop(timer);
+    c->destroy(container);
+    return data->size;
+}
+
+static unsigned BenchPopBack (const BenchContainer* c, const BenchData* data, BenchTimer* timer)
+{
+    void* container = BenchFill(c, data);
+    BenchTimerStart(timer);
+    for (unsigned i = 0; i < data->size; ++i)
+        c->pop(container);
+    BenchTimerStop(timer);
+    c->destroy(container);
+    return data->size;
+}
+
+static unsigned BenchAt (const BenchContainer* c, const BenchData* data, BenchTimer* timer)
+{
+    unsigned count = (c->linearAt) ? BenchLinearCount(data) : data->queryCount;
+    void* container = BenchFill(c, data);
+    BenchTimerStart(timer);
+    for (unsigned i = 0; i < count; ++i)
+        BenchUse(c->at(container, data->numbers[i]));
+    BenchTimerStop(timer);
+    c->destroy(container);
+    return count;
+}
+
+static unsigned BenchSearch (const BenchContainer* c, const BenchData* data, BenchTimer* timer)
+{
+    unsigned count = BenchLinearCount(data);
+    void* container = BenchFill(c, data);
+    BenchTimerStart(timer);
+    for (unsigned i = 0; i < count; ++i)
+        BenchUse(c->find(container, data->queries[i]));
+    BenchTimerStop(timer);
+    c->destroy(container);
+    return count;
+}
+
+static unsigned BenchDeleteByValue (const BenchContainer* c, const BenchData* data, BenchTimer* timer)
+{
+    unsigned count = BenchLinearCount(data);
+    if (count > data->size)
+        count = data->size;
+    void* container = BenchFill(c, data);
+    BenchTimerStart(timer);
+    for (unsigned i = 0; i < count; ++i)
+        c->remove(container, data->victims[i]);
+    BenchTimerStop(timer);
+    c->destroy(container);
+    return count;
+}
+
+static unsigned BenchClear (const BenchContainer* c, const BenchData* data, BenchTimer* timer)
+{
+    void* container = BenchFill(c, data);
+    BenchTimerStart(timer);
+    c->clear(container);
+    BenchTimerStop(timer);
+    c->destroy(container);
+    return data->size;
+}
+
+static unsigned BenchDestroy (const BenchContainer* c, const BenchData* data, BenchTimer* timer)
+{
+    void* container = BenchFill(c, data);
+    BenchTimerStart(timer);
+    c->destroy(container);
+    BenchTimerStop(timer);
+    return data->size;
+}
+
+typedef struct
+{
+    const char* name;
+    BenchCase   run;
+} BenchCaseDesc;
+
+static const BenchCaseDesc benchCases[] =
+{
+    {"push_back",       BenchPushBack},
+    {"pop_back",        BenchPopBack},
+    {"at",              BenchAt},
+    {"search",          BenchSearch},
+    {"delete_by_value", BenchDeleteByValue},
+    {"clear",           BenchClear},
+    {"destroy",         BenchDestroy}
+};
+
+
+/* NEW AND DELETE */
+/* objects are deleted in order of data->values, it is order of distribution */
+typedef struct
+{
+    float position[3];
+    float velocity[3];
+    int   flags;
+    void* owner;
+    char  name[16];
+} BenchObject;
+
+static const char* benchObjectNames[] = {"int", "BenchObject", "int[64]", "List"};
+
+static unsigned BenchNewDelete (unsigned kind, const BenchData* data, void** objects, BenchTimer* timer)
+{
+    BenchTimerStart(timer);
+    for (unsigned i = 0; i < data->size; ++i)
+    {
+        switch (kind)
+        {
+            case 0:  objects[i] = new(int);         break;
+            case 1:  objects[i] = new(BenchObject); break;
+            case 2:  objects[i] = new(int, 64);     break;
+            default: objects[i] = new(List);        break;
+        }
+    }
+    /* values of data are addresses in objects[] in order of distribution */
+    for (unsigned i = 0; i < data->size; ++i)
+        delete(*(void**)data->values[i]);
+    BenchTimerStop(timer);
+
+    return data->size * 2;
+}
+
+
+/* DATA */
+static void BenchShuffle (void** values, unsigned count, uint32_t* seed)
+{
+    for (unsigned i = count; i > 1; --i)
+    {
+        unsigned j = BenchRandom(seed) % i;
+        void* tmp = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = tmp;
+    }
+}
+
+/*  seq    - values are ascending addresses, queries are uniform
+    random - values are shuffled addresses, queries are uniform
+    hot    - values are ascending addresses, 90% of queries are in first 10% of values */
+static void BenchDataMake (BenchData* data, const char* distribution, unsigned size, void** base, uint32_t seed)
+{
+    data->distribution = distribution;
+    data->size         = size;
+    data->queryCount   = BENCH_QUERIES;
+    data->values       = malloc(sizeof(void*) * size);
+    data->numbers      = malloc(sizeof(unsigned) * BENCH_QUERIES);
+    data->queries      = malloc(sizeof(void*) * BENCH_QUERIES);
+    data->victims      = malloc(sizeof(void*) * size);
+
+    for (unsigned i = 0; i < size; ++i)
+        data->values[i] = &base[i];
+    if (strcmp(distribution, "random") == 0)
+        BenchShuffle(data->values, size, &seed);
+
+    bool hot = (strcmp(distribution, "hot") == 0);
+    unsigned hotSize = (size >= 10) ? size / 10 : 1;
+    for (unsigned i = 0; i < BENCH_QUERIES; ++i)
+    {
+        uint32_t r = BenchRandom(&seed);
+        unsigned number = (hot && r % 10 != 0) ? BenchRandom(&seed) % hotSize : BenchRandom(&seed) % size;
+        data->numbers[i] = number;
+        data->queries[i] = data->values[number];
+    }
+
+    /* victims of delete are different, hot ones first */
+    memcpy(data->victims, data->values, sizeof(void*) * size);
+    if (hot)
+    {
+        BenchShuffle(data->victims, hotSize, &seed);
+        BenchShuffle(data->victims + hotSize, size - hotSize, &seed);
+    }
+    else
+        BenchShuffle(data->victims, size, &seed);
+}
+
+static void BenchDataFree (BenchData* data)
+{
+    free(data->values);
+    free(data->numbers);
+    free(data->queries);
+    free(data->victims);
+}
+
+
+/* HARNESS */
+static bool BenchSelected (const BenchOptions* options, const char* container, const char* operation)
+{
+    if (!options->filter)
+        return true;
+
+    char name[128];
+    snprintf(name, sizeof(name), "%s/%s", container, operation);
+    return strstr(name, options->filter) != NULL;
+}
+
+/* case of measurement, return count of operations in timed parts */
+typedef unsigned (*BenchRunner)(const void* arg, const BenchData* data, BenchTimer* timer);
+
+static void BenchMeasure (const BenchOptions* options, BenchCounters* counters, unsigned* row,
+                          const char* container, const char* operation, const BenchData* data,
+                          BenchRunner runner, const void* arg)
+{
+    double samples[options->runs];
+    double cycles = 0;
+    double misses = 0;
+    uint64_t totalOps = 0;
+
+    for (unsigned run = 0; run < options->warmup + options->runs; ++run)
+    {
+        BenchTimer timer = {counters, 0, 0, 0, 0};
+        uint64_t ops = 0;
+        uint64_t start = BenchNow();
+        do
+            ops += runner(arg, data, &timer);
+        while (ops < BENCH_MIN_OPS && BenchNow() - start < BENCH_RUN_NS);
+
+        if (run < options->warmup)
+            continue;
+
+        samples[run - options->warmup] = (double)timer.elapsed / ops;
+        cycles   += timer.cycles;
+        misses   += timer.misses;
+        totalOps += ops;
+    }
+
+    BenchResult result;
+    result.container    = container;
+    result.operation    = operation;
+    result.distribution = data->distribution;
+    result.size         = data->size;
+    result.stats        = BenchStatsCompute(samples, options->runs);
+    result.cycles       = (counters->enabled) ? cycles / totalOps : -1;
+    result.misses       = (counters->enabled) ? misses / totalOps : -1;
+
+    BenchReportRow(options->format, (*row)++, &result);
+}
+
+typedef struct
+{
+    const BenchContainer* container;
+    BenchCase             run;
+} BenchContainerCase;
+
+static unsigned BenchRunContainerCase (const void* arg, const BenchData* data, BenchTimer* timer)
+{
+    const BenchContainerCase* cc = arg;
+    return cc->run(cc->container, data, timer);
+}
+
+typedef struct
+{
+    unsigned kind;
+    void**   objects;
+} BenchNewCase;
+
+static unsigned BenchRunNewCase (const void* arg, const BenchData* data, BenchTimer* timer)
+{
+    const BenchNewCase* nc = arg;
+    return BenchNewDelete(nc->kind, data, nc->objects, timer);
+}
+
+static void BenchUsage (const char* program)
+{
+    fprintf(stderr, "usage: %s [--format text|csv|json] [--runs N] [--warmup N] [--sizes N,N,...]\n"
+                    "          [--filter TEXT] [--seed N] [--cpu N] [--perf]\n", program);
+    exit(1);
+}
+
+static void BenchParseOptions (BenchOptions* options, int argc, char** argv)
+{
+    options->format    = BENCH_FORMAT_TEXT;
+    options->runs      = BENCH_RUNS;
+    options->warmup    = BENCH_WARMUP;
+    options->sizes[0]  = 100;
+    options->sizes[1]  = 10000;
+    options->sizes[2]  = 100000;
+    options->sizeCount = 3;
+    options->filter    = NULL;
+    options->seed      = 2463534242u;
+    options->cpu       = -1;
+    options->perf      = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg   = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--perf") == 0)
+        {
+            options->perf = true;
+            continue;
+        }
+        if (!value)
+            BenchUsage(argv[0]);
+        ++i;
+
+        if (strcmp(arg, "--format") == 0)
+        {
+            if (strcmp(value, "csv") == 0)
+                options->format = BENCH_FORMAT_CSV;
+            else if (strcmp(value, "json") == 0)
+                options->format = BENCH_FORMAT_JSON;
+            else if (strcmp(value, "text") == 0)
+                options->format = BENCH_FORMAT_TEXT;
+            else
+                BenchUsage(argv[0]);
+        }
+        else if (strcmp(arg, "--runs") == 0)
+            options->runs = (unsigned)strtoul(value, NULL, 10);
+        else if (strcmp(arg, "--warmup") == 0)
+            options->warmup = (unsigned)strtoul(value, NULL, 10);
+        else if (strcmp(arg, "--filter") == 0)
+            options->filter = value;
+        else if (strcmp(arg, "--seed") == 0)
+            options->seed = (uint32_t)strtoul(value, NULL, 10);
+        else if (strcmp(arg, "--cpu") == 0)
+            options->cpu = atoi(value);
+        else if (strcmp(arg, "--sizes") == 0)
+        {
+            options->sizeCount = 0;
+            char* end = (char*)value;
+            while (*end && options->sizeCount < BENCH_MAX_SIZES)
+            {
+                unsigned long size = strtoul(end, &end, 10);
+                if (size > 0)
+                    options->sizes[options->sizeCount++] = (unsigned)size;
+                if (*end == ',')
+                    ++end;
+                else if (*end)
+                    BenchUsage(argv[0]);
+            }
+        }
+        else
+            BenchUsage(argv[0]);
+    }
+
+    if (options->runs == 0 || options->sizeCount == 0 || options->seed == 0)
+        BenchUsage(argv[0]);
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    BenchParseOptions(&options, argc, argv);
+
+    /* fixed cpu makes results more stable */
+    if (options.cpu >= 0)
+    {
+        #ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(options.cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+            fprintf(stderr, "can't pin to cpu %d\n", options.cpu);
+        #else
+        fprintf(stderr, "pinning to cpu is not supported\n");
+        #endif // __linux__
+    }
+
+    BenchCounters counters = {0};
+    if (options.perf && !BenchCountersOpen(&counters))
+        fprintf(stderr, "hardware counters are not available\n");
+
+    const char* distributions[] = {"seq", "random", "hot"};
+    const unsigned distributionCount = sizeof(distributions) / sizeof(distributions[0]);
+    unsigned row = 0;
+
+    BenchReportBegin(options.format);
+    for (unsigned s = 0; s < options.sizeCount; ++s)
+    {
+        unsigned size = options.sizes[s];
+        void** base = calloc(size, sizeof(void*));
+
+        for (unsigned d = 0; d < distributionCount; ++d)
+        {
+            BenchData data;
+            BenchDataMake(&data, distributions[d], size, base, options.seed);
+
+            for (unsigned c = 0; c < sizeof(benchContainers) / sizeof(benchContainers[0]); ++c)
+            {
+                for (unsigned k = 0; k < sizeof(benchCases) / sizeof(benchCases[0]); ++k)
+                {
+                    const BenchContainer* container = &benchContainers[c];
+                    if (!BenchSelected(&options, container->name, benchCases[k].name))
+                        continue;
+
+                    BenchContainerCase cc = {container, benchCases[k].run};
+                    BenchMeasure(&options, &counters, &row, container->name, benchCases[k].name,
+                                 &data, BenchRunContainerCase, &cc);
+                }
+            }
+
+            /* objects are deleted in order of distribution */
+            for (unsigned kind = 0; kind < sizeof(benchObjectNames) / sizeof(benchObjectNames[0]); ++kind)
+            {
+                if (!BenchSelected(&options, "new", benchObjectNames[kind]))
+                    continue;
+
+                BenchNewCase nc = {kind, base};
+                BenchMeasure(&options, &counters, &row, "new", benchObjectNames[kind],
+                             &data, BenchRunNewCase, &nc);
+            }
+
+            BenchDataFree(&data);
+        }
+
+        free(base);
+    }
+    BenchReportEnd(options.format);
+
+    BenchCountersClose(&counters);
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+/*
+    Queue: List with push_back and ListDeleteElementByNumber(list, 0) against Deque
+    (ring buffer). Steady queue of fixed depth, filling and draining, access by number.
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. deque_bench.c ../deque.c ../list.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c -o deque_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "list.h"
+#include "deque.h"
+
+#define BENCH_RUNS    5
+#define BENCH_OPS     1000000
+#define BENCH_QUERIES 100000
+#define BENCH_WORK    20000000      /* max count of visited elements by access in List */
+
+/* nanoseconds per operation: steady queue, fill and drain, access by number */
+static void BenchRun (unsigned depth, bool list, int* values, const unsigned* queries, double* results)
+{
+    double samples[3][BENCH_RUNS];
+    unsigned queryCount = (list && BENCH_WORK / depth < BENCH_QUERIES) ? BENCH_WORK / depth + 1 : BENCH_QUERIES;
+
+    for (unsigned run = 0; run < BENCH_RUNS; ++run)
+    {
+        uint64_t start;
+        uintptr_t found = 0;
+
+        if (list)
+        {
+            List* queue = ListCreate();
+            for (unsigned i = 0; i < depth; ++i)
+                ListAddElement(queue, &values[i]);
+
+            start = BenchNow();
+            for (unsigned i = 0; i < BENCH_OPS; ++i)
+            {
+                found += (uintptr_t)ListGetFirstValue(queue);
+                ListDeleteElementByNumber(queue, 0);
+                ListAddElement(queue, &values[i & 1023]);
+            }
+            samples[0][run] = (double)(BenchNow() - start) / BENCH_OPS;
+
+            start = BenchNow();
+            for (unsigned i = 0; i < queryCount; ++i)
+                found += (uintptr_t)ListGetValueByNumber(queue, queries[i]);
+            samples[2][run] = (double)(BenchNow() - start) / queryCount;
+
+            ListClear(queue);
+            start = BenchNow();
+            for (unsigned i = 0; i < BENCH_OPS; ++i)
+                ListAddElement(queue, &values[i & 1023]);
+            for (unsigned i = 0; i < BENCH_OPS; ++i)
+            {
+                found += (uintptr_t)ListGetFirstValue(queue);
+                ListDeleteElementByNumber(queue, 0);
+            }
+            samples[1][run] = (double)(BenchNow() - start) / (2 * BENCH_OPS);
+
+            ListDestroy(&queue);
+        }
+        else
+        {
+            Deque* queue = DequeCreate();
+            for (unsigned i = 0; i < depth; ++i)
+                DequePushBack(queue, &values[i]);
+
+            start = BenchNow();
+            for (unsigned i = 0; i < BENCH_OPS; ++i)
+            {
+                found += (uintptr_t)DequePopFront(queue);
+                DequePushBack(queue, &values[i & 1023]);
+            }
+            samples[0][run] = (double)(BenchNow() - start) / BENCH_OPS;
+
+            start = BenchNow();
+            for (unsigned i = 0; i < queryCount; ++i)
+                found += (uintptr_t)DequeGetValueByNumber(queue, queries[i]);
+            samples[2][run] = (double)(BenchNow() - start) / queryCount;
+
+            DequeClear(queue);
+            start = BenchNow();
+            for (unsigned i = 0; i < BENCH_OPS; ++i)
+                DequePushBack(queue, &values[i & 1023]);
+            for (unsigned i = 0; i < BENCH_OPS; ++i)
+                found += (uintptr_t)DequePopFront(queue);
+            samples[1][run] = (double)(BenchNow() - start) / (2 * BENCH_OPS);
+
+            DequeDestroy(&queue);
+        }
+
+        BenchUse(found);
+    }
+
+    for (unsigned k = 0; k < 3; ++k)
+        results[k] = BenchStatsCompute(samples[k], BENCH_RUNS).median;
+}
+
+int main()
+{
+    unsigned depths[] = {16, 256, 4096, 65536};
+    unsigned maxDepth = depths[sizeof(depths) / sizeof(depths[0]) - 1];
+
+    int*      values  = malloc(sizeof(int) * maxDepth);
+    unsigned* queries = malloc(sizeof(unsigned) * BENCH_QUERIES);
+    for (unsigned i = 0; i < maxDepth; ++i)
+        values[i] = i;
+
+    uint32_t seed = 2463534242u;
+    printf("%-8s %-8s %14s %14s %14s\n", "depth", "queue", "steady", "fill+drain", "at");
+    for (unsigned d = 0; d < sizeof(depths) / sizeof(depths[0]); ++d)
+    {
+        unsigned depth = depths[d];
+        for (unsigned i = 0; i < BENCH_QUERIES; ++i)
+            queries[i] = BenchRandom(&seed) % depth;
+
+        for (unsigned m = 0; m < 2; ++m)
+        {
+            bool list = (m == 0);
+            double results[3];
+            BenchRun(depth, list, values, queries, results);
+            printf("%-8u %-8s %14.1f %14.1f %14.1f\n", depth, (list) ? "List" : "Deque",
+                   results[0], results[1], results[2]);
+        }
+    }
+
+    free(values);
+    free(queries);
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+/*
+    Map from key to value: List of pairs with linear search by key against Dictionary
+    (open addressing, Robin Hood). Integer and string keys, lookups of present and
+    absent keys, erase.
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. dict_bench.c ../dict.c ../list.c ../str.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c -o dict_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "list.h"
+#include "dict.h"
+
+#define BENCH_RUNS    5
+#define BENCH_QUERIES 100000
+#define BENCH_WORK    20000000      /* max count of visited pairs by lookups in List */
+
+/* pair of key and value in List */
+typedef struct
+{
+    const void* key;
+    void*       value;
+} BenchPair;
+
+/* map by List of pairs, like code without dictionary */
+typedef struct
+{
+    List*      list;
+    BenchPair* pairs;
+    bool       strings;
+} BenchPairs;
+
+static ListElement* BenchPairsFind (BenchPairs* map, const void* key)
+{
+    for (ListElement* element = map->list->first; element; element = element->next)
+    {
+        BenchPair* pair = element->value;
+        if ((map->strings) ? strcmp(pair->key, key) == 0 : pair->key == key)
+            return element;
+    }
+    return NULL;
+}
+
+static void BenchPairsSet (BenchPairs* map, unsigned number, const void* key, void* value)
+{
+    ListElement* element = BenchPairsFind(map, key);
+    if (element)
+    {
+        ((BenchPair*)element->value)->value = value;
+        return;
+    }
+    map->pairs[number].key   = key;
+    map->pairs[number].value = value;
+    ListAddElement(map->list, &map->pairs[number]);
+}
+
+/* queries for count of keys */
+static unsigned BenchQueryCount (unsigned count, bool list)
+{
+    if (!list)
+        return BENCH_QUERIES;
+
+    unsigned queries = BENCH_WORK / count;
+    if (queries < 64)
+        queries = 64;
+    return (queries < BENCH_QUERIES) ? queries : BENCH_QUERIES;
+}
+
+/* nanoseconds per operation: set of all keys, get of present keys, get of absent keys, erase of all keys */
+static void BenchRun (unsigned count, bool strings, bool list, const void** keys, const void** absent,
+                      const unsigned* queries, double* results)
+{
+    double samples[4][BENCH_RUNS];
+    unsigned queryCount = BenchQueryCount(count, list);
+    unsigned setCount   = (list && count > 20000) ? 20000 : count;
+
+    for (unsigned run = 0; run < BENCH_RUNS; ++run)
+    {
+        uint64_t start;
+        uintptr_t found = 0;
+
+        if (list)
+        {
+            BenchPairs map = {ListCreate(), malloc(sizeof(BenchPair) * count), strings};
+
+            start = BenchNow();
+            for (unsigned i = 0; i < setCount; ++i)
+                BenchPairsSet(&map, i, keys[i], (void*)(uintptr_t)(i + 1));
+            samples[0][run] = (double)(BenchNow() - start) / setCount;
+            for (unsigned i = setCount; i < count; ++i)
+            {
+                map.pairs[i].key   = keys[i];
+                map.pairs[i].value = (void*)(uintptr_t)(i + 1);
+                ListAddElement(map.list, &map.pairs[i]);
+            }
+
+            start = BenchNow();
+            for (unsigned i = 0; i < queryCount; ++i)
+                found += (uintptr_t)BenchPairsFind(&map, keys[queries[i]]);
+            samples[1][run] = (double)(BenchNow() - start) / queryCount;
+
+            unsigned absentCount = (queryCount > 64) ? queryCount / 8 : queryCount;
+            start = BenchNow();
+            for (unsigned i = 0; i < absentCount; ++i)
+                found += (uintptr_t)BenchPairsFind(&map, absent[i]);
+            samples[2][run] = (double)(BenchNow() - start) / absentCount;
+
+            unsigned eraseCount = (count < queryCount) ? count : queryCount;
+            start = BenchNow();
+            for (unsigned i = 0; i < eraseCount; ++i)
+            {
+                ListElement* element = BenchPairsFind(&map, keys[i]);
+                ListDeleteElement(map.list, element);
+            }
+            samples[3][run] = (double)(BenchNow() - start) / eraseCount;
+
+            ListDestroy(&map.list);
+            free(map.pairs);
+        }
+        else
+        {
+            Dictionary* dict = DictionaryCreateWithKeys((strings) ? DICTIONARY_KEY_STRING : DICTIONARY_KEY_INTEGER);
+
+            start = BenchNow();
+            for (unsigned i = 0; i < count; ++i)
+                DictionarySet(dict, keys[i], (void*)(uintptr_t)(i + 1));
+            samples[0][run] = (double)(BenchNow() - start) / count;
+
+            start = BenchNow();
+            for (unsigned i = 0; i < queryCount; ++i)
+                found += (uintptr_t)DictionaryGet(dict, keys[queries[i]]);
+            samples[1][run] = (double)(BenchNow() - start) / queryCount;
+
+            start = BenchNow();
+            for (unsigned i = 0; i < queryCount; ++i)
+                found += (uintptr_t)DictionaryGet(dict, absent[i]);
+            samples[2][run] = (double)(BenchNow() - start) / queryCount;
+
+            start = BenchNow();
+            for (unsigned i = 0; i < count; ++i)
+                DictionaryErase(dict, keys[i]);
+            samples[3][run] = (double)(BenchNow() - start) / count;
+
+            DictionaryDestroy(&dict);
+        }
+
+        BenchUse(found);
+    }
+
+    for (unsigned k = 0; k < 4; ++k)
+        results[k] = BenchStatsCompute(samples[k], BENCH_RUNS).median;
+}
+
+int main()
+{
+    unsigned counts[] = {16, 256, 4096, 65536, 1000000};
+    unsigned maxCount = counts[sizeof(counts) / sizeof(counts[0]) - 1];
+
+    /* integer keys are spread, string keys look like names */
+    const void** intKeys    = malloc(sizeof(void*) * maxCount);
+    const void** intAbsent  = malloc(sizeof(void*) * BENCH_QUERIES);
+    const void** strKeys    = malloc(sizeof(void*) * maxCount);
+    const void** strAbsent  = malloc(sizeof(void*) * BENCH_QUERIES);
+    unsigned*    queries    = malloc(sizeof(unsigned) * BENCH_QUERIES);
+    char*        names      = malloc((size_t)(maxCount + BENCH_QUERIES) * 24);
+
+    uint32_t seed = 2463534242u;
+    for (unsigned i = 0; i < maxCount; ++i)
+    {
+        intKeys[i] = DICTIONARY_INT((intptr_t)i * 2654435761u + 1);
+        sprintf(names + (size_t)i * 24, "object_%u_%u", i, BenchRandom(&seed) % 1000);
+        strKeys[i] = names + (size_t)i * 24;
+    }
+    for (unsigned i = 0; i < BENCH_QUERIES; ++i)
+    {
+        intAbsent[i] = DICTIONARY_INT((intptr_t)i * 2654435761u + 2);
+        sprintf(names + (size_t)(maxCount + i) * 24, "missing_%u", i);
+        strAbsent[i] = names + (size_t)(maxCount + i) * 24;
+    }
+
+    printf("%-8s %-8s %-12s %12s %12s %12s %12s\n", "keys", "count", "map", "set", "get", "get absent", "erase");
+    for (unsigned s = 0; s < 2; ++s)
+    {
+        bool strings = (s == 1);
+        for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+        {
+            unsigned count = counts[c];
+            for (unsigned i = 0; i < BENCH_QUERIES; ++i)
+                queries[i] = BenchRandom(&seed) % count;
+
+            for (unsigned m = 0; m < 2; ++m)
+            {
+                bool list = (m == 0);
+                double results[4];
+                BenchRun(count, strings, list, (strings) ? strKeys : intKeys, (strings) ? strAbsent : intAbsent,
+                         queries, results);
+                printf("%-8s %-8u %-12s %12.1f %12.1f %12.1f %12.1f\n", (strings) ? "string" : "integer", count,
+                       (list) ? "List pairs" : "Dictionary", results[0], results[1], results[2], results[3]);
+            }
+        }
+    }
+
+    free(intKeys);
+    free(intAbsent);
+    free(strKeys);
+    free(strAbsent);
+    free(queries);
+    free(names);
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+/*
+    Construction of arrays of structs with default values: calloc and assignment
+    of every element (old __create) against uninitialized memory filled by ArrayFill.
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. fill_bench.c ../list.c ../ulist.c ../treelist.c ../vector.c ../ilist.c ../clist.c ../str.c ../strbuilder.c ../rope.c ../intern.c ../utf8.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c -o fill_bench -lpthread
+    Fill in threads (first touch of pages of big arrays):
+        gcc -std=gnu99 -O2 -D__MULTITHREADS -I.. fill_bench.c ../list.c ../ulist.c ../treelist.c ../vector.c ../ilist.c ../clist.c ../str.c ../strbuilder.c ../rope.c ../intern.c ../utf8.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c ../thrdpool.c ../tinycthread.c -o fill_bench -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "cext.h"
+
+#define BENCH_RUNS 7
+
+/* like parameters of effects of WS3D */
+typedef struct
+{
+    float density;
+    float diffusion;
+    float gain;
+    float gainHF;
+    float decayTime;
+    float decayHFRatio;
+    float reflectionsGain;
+    float reflectionsDelay;
+    float lateReverbGain;
+    float lateReverbDelay;
+    float airAbsorptionGainHF;
+    float roomRolloffFactor;
+    int   decayHFLimit;
+    float pan[3];
+} BenchParameters;
+
+static const BenchParameters BenchParameters_c =
+{
+    .density             = 1.0f,
+    .diffusion           = 1.0f,
+    .gain                = 0.32f,
+    .gainHF              = 0.89f,
+    .decayTime           = 1.49f,
+    .decayHFRatio        = 0.83f,
+    .reflectionsGain     = 0.05f,
+    .reflectionsDelay    = 0.007f,
+    .lateReverbGain      = 1.26f,
+    .lateReverbDelay     = 0.011f,
+    .airAbsorptionGainHF = 0.994f,
+    .decayHFLimit        = 1
+};
+
+/* old template: zeroed memory, then element by element */
+static BenchParameters* BenchCreateByElements (size_t count)
+{
+    BenchParameters* p = AllocMemory(ALLOC_TYPE_NONE, sizeof(BenchParameters), count);
+    if (p != NULL)
+    {
+        for (size_t i = 0; i < count; ++i)
+            p[i] = BenchParameters_c;
+    }
+    return p;
+}
+
+static BenchParameters* BenchCreateByFill (size_t count)
+{
+    return __create(BenchParameters, count);
+}
+
+/* return median of nanoseconds per element, with allocation and free */
+static double BenchRun (BenchParameters* (*create)(size_t), size_t count)
+{
+    double samples[BENCH_RUNS];
+    for (unsigned run = 0; run < BENCH_RUNS; ++run)
+    {
+        uint64_t start = BenchNow();
+        BenchParameters* p = create(count);
+        BenchUse(p[count - 1].gain);
+        delete(p);
+        samples[run] = (double)(BenchNow() - start) / count;
+    }
+    return BenchStatsCompute(samples, BENCH_RUNS).median;
+}
+
+int main()
+{
+    size_t counts[] = {1000, 100000, 1000000, 4000000};
+
+    printf("%-10s %12s %16s %16s\n", "count", "MB", "by elements", "ArrayFill");
+    for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        size_t count = counts[c];
+        printf("%-10zu %12.1f %16.2f %16.2f\n", count, (double)count * sizeof(BenchParameters) / (1 << 20),
+               BenchRun(BenchCreateByElements, count), BenchRun(BenchCreateByFill, count));
+    }
+
+    return 0;
+}
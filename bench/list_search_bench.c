@@ -0,0 +1,77 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+/*
+    Search by value in List: walk over elements against vector scan
+    of snapshot (ListEnableSnapshot).
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. list_search_bench.c ../list.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c -o list_search_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "list.h"
+#include "ptrscan.h"
+
+#define BENCH_SEARCHES 2000
+
+/* return microseconds per search of random values in list of size elements */
+static double BenchRun (bool snapshot, unsigned size)
+{
+    int* array = malloc(size * sizeof(int));
+    List* list = ListCreate();
+    for (unsigned i = 0; i < size; ++i)
+        ListAddElement(list, &array[i]);
+    ListEnableSnapshot(list, snapshot);
+
+    /* first search builds snapshot */
+    BenchUse(ListGetNumberByValue(list, &array[0]));
+
+    uint32_t seed = 2463534242u;
+    uint64_t start = BenchNow();
+    for (unsigned i = 0; i < BENCH_SEARCHES; ++i)
+        BenchUse(ListGetNumberByValue(list, &array[BenchRandom(&seed) % size]));
+    uint64_t total = BenchNow() - start;
+
+    ListDestroy(&list);
+    free(array);
+
+    return (double)total / BENCH_SEARCHES / 1000.0;
+}
+
+int main()
+{
+    unsigned sizes[] = {1000, 10000, 100000, 1000000};
+
+    printf("kernel: %s\n", PtrScanGetKernel());
+    printf("%-10s %-12s %12s\n", "size", "method", "us/search");
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        unsigned size = sizes[s];
+        printf("%-10u %-12s %12.3f\n", size, "scan", BenchRun(false, size));
+        printf("%-10u %-12s %12.3f\n", size, "snapshot", BenchRun(true, size));
+    }
+
+    return 0;
+}
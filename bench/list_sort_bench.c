@@ -0,0 +1,114 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+/*
+    Sort of List: ListSort (merge sort, relinks elements) against
+    copy of values to array, qsort and rebuild of list.
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. list_sort_bench.c ../list.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c -o list_sort_bench
+    Sort in threads:
+        gcc -std=gnu99 -O2 -D__MULTITHREADS -I.. list_sort_bench.c ../list.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c ../thrdpool.c ../tinycthread.c -o list_sort_bench -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "list.h"
+
+/* every measurement repeats sort until this time is reached */
+#define BENCH_TIME_NS (500 * 1000000ull)
+
+static int CompareValues (const void* a, const void* b)
+{
+    return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+}
+
+/* qsort gets pointers to values */
+static int CompareItems (const void* a, const void* b)
+{
+    return CompareValues(*(void* const*)a, *(void* const*)b);
+}
+
+static void SortList (List* list)
+{
+    ListSort(list, CompareValues);
+}
+
+static void SortArray (List* list)
+{
+    unsigned size = ListGetSize(list);
+    void** values = malloc(size * sizeof(void*));
+
+    unsigned i = 0;
+    for (ListElement* element = list->first; element; element = element->next)
+        values[i++] = element->value;
+
+    qsort(values, size, sizeof(void*), CompareItems);
+
+    ListClear(list);
+    for (i = 0; i < size; ++i)
+        ListAddElement(list, values[i]);
+
+    free(values);
+}
+
+/* return milliseconds per sort of list filled with random values */
+static double BenchRun (void (*sort)(List*), unsigned size)
+{
+    List* list = ListCreate();
+    uint64_t total = 0;
+    unsigned runs  = 0;
+    do
+    {
+        uint32_t seed = 2463534242u;
+        ListClear(list);
+        for (unsigned i = 0; i < size; ++i)
+            ListAddElement(list, (void*)(uintptr_t)BenchRandom(&seed));
+
+        uint64_t start = BenchNow();
+        sort(list);
+        total += BenchNow() - start;
+        ++runs;
+
+        BenchUse(list->first->value);
+    }
+    while (total < BENCH_TIME_NS);
+    ListDestroy(&list);
+
+    return (double)total / runs / 1000000.0;
+}
+
+int main()
+{
+    unsigned sizes[] = {1000, 100000, 1000000, 10000000};
+
+    printf("%-10s %-24s %12s\n", "size", "method", "ms/sort");
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        unsigned size = sizes[s];
+        printf("%-10u %-24s %12.3f\n", size, "ListSort", BenchRun(SortList, size));
+        printf("%-10u %-24s %12.3f\n", size, "copy + qsort + rebuild", BenchRun(SortArray, size));
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+/*
+    Building of text: strcat/sprintf into one buffer against StringBuilder,
+    and inserts in the middle of text: memmove of array against Rope.
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. text_bench.c ../strbuilder.c ../rope.c ../str.c ../alloc.c ../arena.c -o text_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "strbuilder.h"
+#include "rope.h"
+
+#define BENCH_LINES   20000
+#define BENCH_INSERTS 20000
+
+/* every line is "name=<number>;" like in log */
+static double BenchStrcat (void)
+{
+    char* text = malloc(BENCH_LINES * 32);
+    char  line[32];
+    text[0] = '\0';
+
+    uint64_t start = BenchNow();
+    for (unsigned i = 0; i < BENCH_LINES; ++i)
+    {
+        sprintf(line, "%d;", (int)(i * 7919));
+        strcat(text, "name=");
+        strcat(text, line);
+    }
+    uint64_t total = BenchNow() - start;
+
+    BenchUse(text[0]);
+    free(text);
+
+    return (double)total / 1000000.0;
+}
+
+static double BenchBuilder (void)
+{
+    StringBuilder* builder = StringBuilderCreate();
+
+    uint64_t start = BenchNow();
+    for (unsigned i = 0; i < BENCH_LINES; ++i)
+    {
+        StringBuilderAppendChars(builder, "name=", 5);
+        StringBuilderAppendInt(builder, (int)(i * 7919));
+        StringBuilderAddChar(builder, ';');
+    }
+    size_t length;
+    char* text = StringBuilderDetach(builder, &length);
+    uint64_t total = BenchNow() - start;
+
+    BenchUse(text[0]);
+    free(text);
+    StringBuilderDestroy(&builder);
+
+    return (double)total / 1000000.0;
+}
+
+/* insert of short piece at random position of growing text */
+static double BenchArrayInsert (void)
+{
+    char*  text   = malloc(BENCH_INSERTS * 16);
+    size_t length = 0;
+    uint32_t seed = 2463534242u;
+
+    uint64_t start = BenchNow();
+    for (unsigned i = 0; i < BENCH_INSERTS; ++i)
+    {
+        size_t position = BenchRandom(&seed) % (length + 1);
+        memmove(text + position + 16, text + position, length - position);
+        memcpy(text + position, "0123456789abcdef", 16);
+        length += 16;
+    }
+    uint64_t total = BenchNow() - start;
+
+    BenchUse(text[0]);
+    free(text);
+
+    return (double)total / 1000000.0;
+}
+
+static double BenchRopeInsert (void)
+{
+    Rope* rope = RopeCreate();
+    uint32_t seed = 2463534242u;
+
+    uint64_t start = BenchNow();
+    for (unsigned i = 0; i < BENCH_INSERTS; ++i)
+    {
+        size_t position = BenchRandom(&seed) % (RopeGetLength(rope) + 1);
+        RopeInsert(rope, position, "0123456789abcdef", 16);
+    }
+    uint64_t total = BenchNow() - start;
+
+    BenchUse(RopeGetChar(rope, 0));
+    RopeDestroy(&rope);
+
+    return (double)total / 1000000.0;
+}
+
+int main()
+{
+    printf("%-28s %12s\n", "method", "ms");
+    printf("%-28s %12.3f\n", "sprintf + strcat",   BenchStrcat());
+    printf("%-28s %12.3f\n", "StringBuilder",      BenchBuilder());
+    printf("%-28s %12.3f\n", "array insert",       BenchArrayInsert());
+    printf("%-28s %12.3f\n", "Rope insert",        BenchRopeInsert());
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+/*
+    Access by position: List (walk from head or tail) against TreeList (AVL-tree with counts).
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. treelist_bench.c ../list.c ../arena.c ../alloc.c ../parallel.c ../ptrscan.c ../treelist.c -o treelist_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "list.h"
+#include "treelist.h"
+
+/* every measurement runs until this time or count of operations is reached */
+#define BENCH_TIME_NS (200 * 1000000ull)
+#define BENCH_MAX_OPS 1000000
+
+typedef void (*BenchOp)(void* container, unsigned size, uint32_t* seed);
+
+static void ListAt (void* container, unsigned size, uint32_t* seed)
+{
+    BenchUse(ListGetValueByNumber(container, BenchRandom(seed) % size));
+}
+
+static void ListDeleteAt (void* container, unsigned size, uint32_t* seed)
+{
+    /* keep size of list - delete at random position and append again */
+    ListDeleteElementByNumber(container, BenchRandom(seed) % size);
+    ListAddElement(container, (void*)(uintptr_t)size);
+}
+
+static void TreeListAt (void* container, unsigned size, uint32_t* seed)
+{
+    BenchUse(TreeListGetValueByNumber(container, BenchRandom(seed) % size));
+}
+
+static void TreeListInsertDeleteAt (void* container, unsigned size, uint32_t* seed)
+{
+    TreeListInsertElement(container, BenchRandom(seed) % size, (void*)(uintptr_t)size);
+    TreeListDeleteElementByNumber(container, BenchRandom(seed) % size);
+}
+
+/* return nanoseconds per operation */
+static double BenchRun (BenchOp op, void* container, unsigned size)
+{
+    uint32_t seed = 2463534242u;
+    unsigned ops  = 0;
+    uint64_t start = BenchNow();
+    uint64_t elapsed = 0;
+    do
+    {
+        op(container, size, &seed);
+        ++ops;
+        /* check timer not too often */
+        if ((ops & 15) == 0 || size > 100000)
+            elapsed = BenchNow() - start;
+    }
+    while (elapsed < BENCH_TIME_NS && ops < BENCH_MAX_OPS);
+
+    return (double)(BenchNow() - start) / ops;
+}
+
+int main()
+{
+    unsigned sizes[] = {1000, 100000, 10000000};
+
+    printf("%-10s %-8s %-22s %12s\n", "size", "list", "operation", "ns/op");
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        unsigned size = sizes[s];
+
+        List* list = ListCreateWithPool(NULL);
+        for (unsigned i = 0; i < size; ++i)
+            ListAddElement(list, (void*)(uintptr_t)(i + 1));
+        printf("%-10u %-8s %-22s %12.1f\n", size, "List", "at", BenchRun(ListAt, list, size));
+        printf("%-10u %-8s %-22s %12.1f\n", size, "List", "delete-at + push_back", BenchRun(ListDeleteAt, list, size));
+        ListDestroy(&list);
+
+        TreeList* tlist = TreeListCreate();
+        for (unsigned i = 0; i < size; ++i)
+            TreeListAddElement(tlist, (void*)(uintptr_t)(i + 1));
+        printf("%-10u %-8s %-22s %12.1f\n", size, "TreeList", "at", BenchRun(TreeListAt, tlist, size));
+        printf("%-10u %-8s %-22s %12.1f\n", size, "TreeList", "insert-at + delete-at", BenchRun(TreeListInsertDeleteAt, tlist, size));
+        TreeListDestroy(&tlist);
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+/*
+    UTF-8 to wchar_t and back: Utf8Decode/Utf8Encode against mbstowcs/wcstombs
+    of libc with UTF-8 locale, on ASCII text and on mixed Cyrillic text.
+
+    Build:
+        gcc -std=gnu99 -O2 -I.. utf8_bench.c ../utf8.c ../str.c ../alloc.c ../arena.c -o utf8_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <wchar.h>
+
+#include "bench.h"
+#include "utf8.h"
+
+#define BENCH_TEXT_SIZE (4 * 1024 * 1024)
+#define BENCH_RUNS      20
+
+/* text from repeated line, ends with zero for libc */
+static char* BenchMakeText (const char* line)
+{
+    char* text = malloc(BENCH_TEXT_SIZE + 64);
+    size_t lineLength = strlen(line);
+    size_t length = 0;
+    while (length + lineLength < BENCH_TEXT_SIZE)
+    {
+        memcpy(text + length, line, lineLength);
+        length += lineLength;
+    }
+    text[length] = '\0';
+
+    return text;
+}
+
+/* return MB of UTF-8 per second */
+static double BenchSpeed (size_t bytes, uint64_t ns)
+{
+    return (double)bytes * BENCH_RUNS / (1024.0 * 1024.0) / ((double)ns / 1000000000.0);
+}
+
+static void BenchRun (const char* name, const char* line)
+{
+    char*    text   = BenchMakeText(line);
+    size_t   length = strlen(text);
+    wchar_t* wide   = malloc((length + 1) * sizeof(wchar_t));
+    char*    back   = malloc(length * 4 + 1);
+
+    uint64_t start = BenchNow();
+    size_t count = 0;
+    for (unsigned i = 0; i < BENCH_RUNS; ++i)
+        count = mbstowcs(wide, text, length + 1);
+    uint64_t libcDecode = BenchNow() - start;
+
+    start = BenchNow();
+    for (unsigned i = 0; i < BENCH_RUNS; ++i)
+        BenchUse(wcstombs(back, wide, length * 4 + 1));
+    uint64_t libcEncode = BenchNow() - start;
+
+    start = BenchNow();
+    for (unsigned i = 0; i < BENCH_RUNS; ++i)
+    {
+        Utf8Decoder decoder;
+        Utf8DecoderInit(&decoder, false);
+        const char* s = text;
+        wchar_t*    d = wide;
+        Utf8Decode(&decoder, &s, text + length, &d, wide + length, true);
+        BenchUse(d);
+        if ((size_t)(d - wide) != count)
+            printf("wrong count of chars!\n");
+    }
+    uint64_t decode = BenchNow() - start;
+
+    start = BenchNow();
+    for (unsigned i = 0; i < BENCH_RUNS; ++i)
+    {
+        Utf8Encoder encoder;
+        Utf8EncoderInit(&encoder, false);
+        const wchar_t* s = wide;
+        char*          d = back;
+        Utf8Encode(&encoder, &s, wide + count, &d, back + length * 4, true);
+        BenchUse(d);
+    }
+    uint64_t encode = BenchNow() - start;
+
+    printf("%-10s %-10s %12.1f %12.1f\n", name, "libc",  BenchSpeed(length, libcDecode), BenchSpeed(length, libcEncode));
+    printf("%-10s %-10s %12.1f %12.1f\n", name, "utf8",  BenchSpeed(length, decode),     BenchSpeed(length, encode));
+
+    free(text);
+    free(wide);
+    free(back);
+}
+
+int main()
+{
+    if (setlocale(LC_ALL, "C.UTF-8") == NULL && setlocale(LC_ALL, "en_US.UTF-8") == NULL)
+        printf("no UTF-8 locale, libc numbers are wrong\n");
+
+    printf("%-10s %-10s %12s %12s\n", "text", "method", "decode MB/s", "encode MB/s");
+    BenchRun("ascii",    "The quick brown fox jumps over the lazy dog; id=12345, name=player\n");
+    BenchRun("cyrillic", "Съешь же ещё этих мягких французских булок, да выпей чаю. id=12345\n");
+
+    return 0;
+}
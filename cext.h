@@ -47,6 +47,64 @@
             List* list = new(List);
             list->push_back(list, some_value);
             list->back(list);  // == some_value
+
+         Много значений добавляются за раз, списки с общим пулом
+         передают друг другу элементы за O(1):
+            ListAddElements(list, values, count);
+            ListSplice(list, other);            // все элементы other в конец list
+            ListSplit(list, element, tail);     // element и все после него в конец tail
+            ListSort(list, compare);            // устойчивая сортировка без копирования
+
+         Обход, map и reduce длинных списков и массивов из new(T, n) идут в потоках
+         (при __MULTITHREADS), потоки берут части работы по очереди:
+            ListForEach(list, func, context);
+            ListMap(list, func, context);       // значения заменяются результатом func
+            void* sum = ListReduce(list, add, combine, NULL, context);
+            int* array = new(int, 100000);
+            ArrayForEach(array, ARRAY_COUNT(array), sizeof(int), func, context);
+            ArrayFill(array, ARRAY_COUNT(array), sizeof(int), &value);  // копиями блоков
+
+         Поиск по значению в списке, который редко меняется, идет по копии значений
+         векторными командами (AVX2/SSE2), добавление в конец копию не сбрасывает:
+            ListEnableSnapshot(list, true);
+            ListGetNumberByValue(list, some_value);
+
+         Создание развернутого списка (несколько значений в одном узле):
+            UList* ulist = new(UList);
+            ulist->push_back(ulist, some_value);
+
+         Создание списка с доступом по номеру за O(log n):
+            TreeList* tlist = new(TreeList);
+            tlist->at(tlist, 1000);
+
+         Создание динамического массива:
+            Vector* vector = new(Vector);
+            vector->reserve(vector, 100);
+            vector->push_back(vector, some_value);
+            VectorAt(vector, 0);  // == some_value, без проверок
+
+         Интрузивный список создается функцией, ему нужно смещение связей в структуре.
+         Он ничего не выделяет и удаляет значение за O(1), удаляется через delete:
+            typedef struct
+            {
+                int   x, y;
+                ILink link;
+            } item_s;
+
+            IList* ilist = IListCreateFor(item_s, link);
+            ilist->push_back(ilist, item);
+            IListDeleteElement(ilist, item);
+
+         Список для многих потоков: добавление и удаление без блокировок,
+         читающие потоки обходят его внутри CLIST_READ_SCOPE и никого не ждут:
+            CList* clist = new(CList);
+            clist->push_back(clist, value);         // из любого потока
+            CLIST_READ_SCOPE()
+            {
+                for (CListElement* e = CListGetFirst(clist); e; e = CListGetNext(e))
+                    use(e->value);
+            }
+            void* first = clist->pop_front(clist);
           
 
          --------------------------
@@ -64,24 +122,123 @@
             delete(list);
             assert(list == NULL);
 
+         Перед памятью от new лежит заголовок с типом объекта, delete по нему
+         за O(1) вызывает деструктор типа. Удалять можно только созданное через new
+         или функции XxxCreate. Объект, которому XxxInit разметил память malloc,
+         удаляется функцией XxxDestroy - она вернет память через free().
+         Свой тип с деструктором регистрируется так:
+            unsigned type = AllocRegisterType(&ExampleFinalize);
+            example_s* ex = AllocMemory(type, sizeof(example_s), 1);
+            delete(ex);   // вызовет ExampleFinalize(ex)
+
+         Массивы для векторных команд выделяются с выравниванием, большие - в огромных
+         страницах (transparent через madvise или явные MAP_HUGETLB), delete освобождает их так же:
+            float* samples = new_aligned(float, 4096, 64);
+            float* volume  = new_huge(float, 1 << 24, ALLOC_HUGE_TRANSPARENT);
+            delete(samples);
+            delete(volume);
+         Память всегда обнулена, структуры со значениями по умолчанию (X##_c) заполняются отдельно:
+            ArrayFill(params, n, sizeof(wEqualizerParameters), &wEqualizerParameters_c);
+
          --------------------------
-         Также в этом заголовке определены два типа строк:
-            String  = string_t
-            WString = wstring_t
+         Объекты можно создавать в арене - области памяти, которая освобождается целиком.
+         Пока арена текущая, new берет память из нее, списки берут из нее и элементы.
+         delete внутри блока только обнуляет указатель, память вернется при сбросе арены:
+            Arena* arena = ArenaCreate(0);
+            ARENA_SCOPE(arena)
+            {
+                int*  tmp  = new(int, 1000);
+                List* list = new(List);
+                ...               // без break, return и goto из блока - арена останется текущей
+            }
+            ArenaReset(arena);    // все объекты кадра освобождены разом
+            ArenaDestroy(&arena);
+
+         --------------------------
+         С __ALLOC_STATS в config.h new и delete считают выделения по месту вызова
+         (файл, строка, тип): число, живые и пиковые байты, гистограмма размеров.
+         Память арен идет отдельной колонкой - она вернется с ареной, а не через delete.
+         Счетчики у каждого потока свои, отчет печатается в stderr при выходе:
+            AllocStatsDump(stdout);                   // отчет в любой момент
+            AllocSiteStats sites[64];
+            unsigned count = AllocStatsGetSites(sites, 64);
+
+         --------------------------
+         Строки String и WString растут сами и помнят свою длину. Короткий текст
+         (до 23 символов String) хранится внутри строки без выделения памяти:
 
          Примеры:
             // создадим строку, выведем, а потом удалим
-            char* str0 = new(String);
-            sprintf(str0, "Привет, мир!\n");
-            printf(str0);
+            String* str0 = new(String);
+            StringFormat(str0, "Привет, %s!\n", "мир");
+            StringAppend(str0, "текст любой длины\n");
+            printf("%s", StringGetChars(str0));
             delete(str0);
 
             // хм, а что насчет широкой строки?
-            wchar_t* str1 = new(WString);
-            swprintf(str1, L"Привет, широкий мир!\n");
-            wprintf(str1);
+            WString* str1 = new(WString);
+            WStringFormat(str1, L"Привет, широкий мир!\n");
+            wprintf(L"%ls", WStringGetChars(str1));
             delete(str1);
 
+         Массивы символов фиксированной длины остались как string_t и wstring_t.
+
+         Длинный текст собирается в StringBuilder без повторного strlen, числа
+         печатаются без printf, готовый буфер отдается без копии:
+            StringBuilder* out = new(StringBuilder);
+            StringBuilderAppend(out, "count = ");
+            StringBuilderAppendInt(out, count);
+            StringBuilderAddChar(out, '\n');
+            char* text = StringBuilderDetach(out, &length);   // освобождается free()
+            delete(out);
+
+         Rope хранит текст деревом кусков, вставка в середину и склейка
+         больших текстов не двигают весь текст:
+            Rope* rope = new(Rope);
+            RopeAppend(rope, "hello world");
+            RopeInsert(rope, 5, ",", 1);
+            RopeConcat(rope, other);                          // other становится пустым
+            char* flat = RopeFlatten(rope);
+
+         Одинаковый текст можно превратить в одну неизменяемую строку, тогда строки
+         сравниваются по указателю, и поиск имени в List идет без strcmp:
+            String* name = InternString(NULL, "player");      // общая потокобезопасная таблица
+            name == InternString(NULL, buf);                  // true, если в buf "player"
+            ListGetElementByValue(list, name);
+
+         UTF-8 переводится в wchar_t и обратно без локали, ASCII идет по 16 символов
+         (SSE2). Текст можно подавать частями, разрезанный символ ждет в Utf8Decoder:
+            Utf8ToWString(wstr, text, length);                // ошибки заменяются на U+FFFD
+            Utf8FromWString(str, WStringGetChars(wstr), WStringGetLength(wstr));
+            Utf8Decode(&decoder, &src, srcEnd, &dst, dstEnd, last);
+
+         --------------------------
+         Dictionary - хеш-таблица с открытой адресацией (Robin Hood), ключи - указатели,
+         целые или строки (словарь хранит свои копии строк). Вместо List из пар с поиском перебором:
+            Dictionary* dict = new(Dictionary);
+            DictionarySetKeyType(dict, DICTIONARY_KEY_STRING);   // пока словарь пуст
+            DictionaryReserve(dict, 1000);
+            dict->set(dict, "player", player);
+            Player* p = dict->get(dict, "player");
+            dict->erase(dict, "player");
+
+            unsigned position = 0;
+            void *key, *value;
+            while (DictionaryIterate(dict, &position, &key, &value))
+                if (value == NULL)
+                    DictionaryEraseIterated(dict, &position);     // обход продолжается
+            delete(dict);
+
+         --------------------------
+         Deque - кольцевой буфер, добавление и удаление с обоих концов и доступ по номеру за O(1),
+         емкость растет степенями двойки. Вместо List как очереди (push_back + ListDeleteElementByNumber(list, 0)):
+            Deque* queue = new(Deque);
+            queue->push_back(queue, task);
+            queue->push_front(queue, urgent_task);
+            Task* next = queue->pop_front(queue);    // NULL, если очередь пуста
+            DequeAt(queue, 0);                       // без проверок
+            delete(queue);
+
          --------------------------
 
          --------------------------
@@ -113,6 +270,64 @@
             list->push_back(list, some_value);
             list->back(list);  // == some_value
 
+         Many values are added at once, lists with shared pool
+         give elements to each other in O(1):
+            ListAddElements(list, values, count);
+            ListSplice(list, other);            // all elements of other to the end of list
+            ListSplit(list, element, tail);     // element and all after it to the end of tail
+            ListSort(list, compare);            // stable sort without copying
+
+         For each, map and reduce of long lists and arrays from new(T, n) run in threads
+         (with __MULTITHREADS), threads take chunks of work one by one:
+            ListForEach(list, func, context);
+            ListMap(list, func, context);       // values are replaced with result of func
+            void* sum = ListReduce(list, add, combine, NULL, context);
+            int* array = new(int, 100000);
+            ArrayForEach(array, ARRAY_COUNT(array), sizeof(int), func, context);
+            ArrayFill(array, ARRAY_COUNT(array), sizeof(int), &value);  // by copies of blocks
+
+         Search by value in list which is rarely changed goes over copy of values
+         with vector instructions (AVX2/SSE2), append to the end keeps the copy:
+            ListEnableSnapshot(list, true);
+            ListGetNumberByValue(list, some_value);
+
+         Creating of unrolled list (several values in one node):
+            UList* ulist = new(UList);
+            ulist->push_back(ulist, some_value);
+
+         Creating of list with access by position in O(log n):
+            TreeList* tlist = new(TreeList);
+            tlist->at(tlist, 1000);
+
+         Creating of dynamic array:
+            Vector* vector = new(Vector);
+            vector->reserve(vector, 100);
+            vector->push_back(vector, some_value);
+            VectorAt(vector, 0);  // == some_value, without checks
+
+         Intrusive list is created by function, it needs offset of links in struct.
+         It allocates nothing and unlinks value in O(1), it is deleted with delete:
+            typedef struct
+            {
+                int   x, y;
+                ILink link;
+            } item_s;
+
+            IList* ilist = IListCreateFor(item_s, link);
+            ilist->push_back(ilist, item);
+            IListDeleteElement(ilist, item);
+
+         List for many threads: append and removal are lock-free,
+         readers walk it inside CLIST_READ_SCOPE and wait for nobody:
+            CList* clist = new(CList);
+            clist->push_back(clist, value);         // from any thread
+            CLIST_READ_SCOPE()
+            {
+                for (CListElement* e = CListGetFirst(clist); e; e = CListGetNext(e))
+                    use(e->value);
+            }
+            void* first = clist->pop_front(clist);
+
          --------------------------
          Deleting objects is done through a macro
             delete(Object)
@@ -127,24 +342,123 @@
             delete(list);
             assert(list == NULL);
 
+         Memory of new has header with type of object in front of it, delete calls
+         destructor of type by it in O(1). Only objects created by new or by XxxCreate
+         functions may be deleted. Object set up by XxxInit in memory of malloc
+         is released by XxxDestroy - it gives memory back to free().
+         Own type with destructor is registered so:
+            unsigned type = AllocRegisterType(&ExampleFinalize);
+            example_s* ex = AllocMemory(type, sizeof(example_s), 1);
+            delete(ex);   // calls ExampleFinalize(ex)
+
+         Arrays for vector instructions are allocated aligned, big ones - in huge pages
+         (transparent by madvise or explicit MAP_HUGETLB), delete frees them as usual:
+            float* samples = new_aligned(float, 4096, 64);
+            float* volume  = new_huge(float, 1 << 24, ALLOC_HUGE_TRANSPARENT);
+            delete(samples);
+            delete(volume);
+         Memory is always zeroed, structs with default values (X##_c) are filled separately:
+            ArrayFill(params, n, sizeof(wEqualizerParameters), &wEqualizerParameters_c);
+
          --------------------------
-         Also in this header, there are two types of strings:
-            String  = string_t
-            WString = wstring_t
+         Objects may be created in arena - region of memory which is released at once.
+         While arena is current, new takes memory from it, lists take their elements from it too.
+         delete inside the block only sets pointer to NULL, memory returns on reset of arena:
+            Arena* arena = ArenaCreate(0);
+            ARENA_SCOPE(arena)
+            {
+                int*  tmp  = new(int, 1000);
+                List* list = new(List);
+                ...               // no break, return or goto out of block - arena stays current
+            }
+            ArenaReset(arena);    // all objects of frame are released at once
+            ArenaDestroy(&arena);
+
+         --------------------------
+         With __ALLOC_STATS in config.h new and delete count allocations by call site
+         (file, line, type): count, live and peak bytes, histogram of sizes.
+         Memory of arenas has its own column - it returns with arena, not by delete.
+         Every thread has own counters, report is printed to stderr at exit:
+            AllocStatsDump(stdout);                   // report at any moment
+            AllocSiteStats sites[64];
+            unsigned count = AllocStatsGetSites(sites, 64);
+
+         --------------------------
+         Strings String and WString grow by themselves and keep their length. Short text
+         (up to 23 chars of String) is kept inside of string without allocation:
 
          Examples:
             // create a string, print it, and then delete it
-            char* str0 = new(String);
-            sprintf(str0, "Hello world!\n");
-            printf(str0);
+            String* str0 = new(String);
+            StringFormat(str0, "Hello %s!\n", "world");
+            StringAppend(str0, "text of any length\n");
+            printf("%s", StringGetChars(str0));
             delete(str0);
 
             // hmm, what about the wide string?
-            wchar_t* str1 = new(WString);
-            swprintf(str1, L"Hello, Wide World!\n");
-            wprintf(str1);
+            WString* str1 = new(WString);
+            WStringFormat(str1, L"Hello, Wide World!\n");
+            wprintf(L"%ls", WStringGetChars(str1));
             delete(str1);
 
+         Arrays of chars with fixed length are still there as string_t and wstring_t.
+
+         Long text is built in StringBuilder without repeated strlen, numbers
+         are printed without printf, ready buffer is given without copy:
+            StringBuilder* out = new(StringBuilder);
+            StringBuilderAppend(out, "count = ");
+            StringBuilderAppendInt(out, count);
+            StringBuilderAddChar(out, '\n');
+            char* text = StringBuilderDetach(out, &length);   // released with free()
+            delete(out);
+
+         Rope keeps text as tree of pieces, insert in the middle and concatenation
+         of big texts don't move whole text:
+            Rope* rope = new(Rope);
+            RopeAppend(rope, "hello world");
+            RopeInsert(rope, 5, ",", 1);
+            RopeConcat(rope, other);                          // other becomes empty
+            char* flat = RopeFlatten(rope);
+
+         Equal text can be turned into one immutable string, then strings are compared
+         by pointer, and search of name in List goes without strcmp:
+            String* name = InternString(NULL, "player");      // shared thread-safe table
+            name == InternString(NULL, buf);                  // true if buf has "player"
+            ListGetElementByValue(list, name);
+
+         UTF-8 is converted to wchar_t and back without locale, ASCII goes by 16 chars
+         (SSE2). Text may be given by parts, cut char waits in Utf8Decoder:
+            Utf8ToWString(wstr, text, length);                // errors are replaced with U+FFFD
+            Utf8FromWString(str, WStringGetChars(wstr), WStringGetLength(wstr));
+            Utf8Decode(&decoder, &src, srcEnd, &dst, dstEnd, last);
+
+         --------------------------
+         Dictionary is hash map with open addressing (Robin Hood), keys are pointers,
+         integers or strings (dictionary keeps own copies of strings). Instead of List of pairs with linear search:
+            Dictionary* dict = new(Dictionary);
+            DictionarySetKeyType(dict, DICTIONARY_KEY_STRING);   // while dictionary is empty
+            DictionaryReserve(dict, 1000);
+            dict->set(dict, "player", player);
+            Player* p = dict->get(dict, "player");
+            dict->erase(dict, "player");
+
+            unsigned position = 0;
+            void *key, *value;
+            while (DictionaryIterate(dict, &position, &key, &value))
+                if (value == NULL)
+                    DictionaryEraseIterated(dict, &position);     // iteration goes on
+            delete(dict);
+
+         --------------------------
+         Deque is ring buffer, push and pop at both ends and access by number take O(1),
+         capacity grows by powers of two. Instead of List as queue (push_back + ListDeleteElementByNumber(list, 0)):
+            Deque* queue = new(Deque);
+            queue->push_back(queue, task);
+            queue->push_front(queue, urgent_task);
+            Task* next = queue->pop_front(queue);    // NULL if queue is empty
+            DequeAt(queue, 0);                       // without checks
+            delete(queue);
+
          --------------------------
 */
 
@@ -158,6 +472,40 @@
 
 /* doubly-linked list */
 #include "list.h"
+/* unrolled doubly-linked list */
+#include "ulist.h"
+/* list with access by position in O(log n) */
+#include "treelist.h"
+/* dynamic array */
+#include "vector.h"
+/* ring buffer with push and pop at both ends */
+#include "deque.h"
+/* intrusive doubly-linked list */
+#include "ilist.h"
+/* lock-free list for many threads */
+#include "clist.h"
+/* for each, map and reduce in threads */
+#include "parallel.h"
+/* search of pointer in array by vector instructions */
+#include "ptrscan.h"
+/* growable strings with short text inside */
+#include "str.h"
+/* building of long text by appends */
+#include "strbuilder.h"
+/* text as tree of pieces for inserts in the middle */
+#include "rope.h"
+/* one immutable string for every text */
+#include "intern.h"
+/* UTF-8 to wchar_t and back */
+#include "utf8.h"
+/* hash map with open addressing */
+#include "dict.h"
+/* region of memory with one release */
+#include "arena.h"
+/* typed memory of new() and delete() */
+#include "alloc.h"
+/* counters of new() by call sites */
+#include "allocstats.h"
 
 /*
     ---------------------------------------
@@ -196,15 +544,6 @@
 typedef    char string_t [MAX_STRING_LENGTH];
 typedef wchar_t wstring_t[MAX_STRING_LENGTH];
 
-/*
-    ---------------------------------------
-    (RU) синонимы строковых типов
-    (EN) synonims of string-types
-    ---------------------------------------
-*/
-#define  String string_t
-#define WString wstring_t
-
 
 /*
     ---------------------------------------
@@ -367,18 +706,14 @@ const wEqualizerParameters wEqualizerParameters_c =
 
 #define __create(X, N)                                                      \
         ({                                                                  \
-            int __i_create;                                                 \
+            size_t __n_create = (N);                                        \
             __typeof__(X)* __p_create = NULL;                               \
-            if (N > 0)                                                      \
+            if (__n_create > 0)                                             \
             {                                                               \
-                __p_create = calloc(sizeof(X), N);                          \
+                __p_create = AllocMemoryUninit(ALLOC_TYPE_NONE, sizeof(X),  \
+                                               __n_create);                 \
                 if (__p_create != NULL)                                     \
-                {                                                           \
-                    for (__i_create = 0; __i_create < N; ++__i_create)      \
-                    {                                                       \
-                        __p_create[__i_create] = X ## _c;                   \
-                    }                                                       \
-                }                                                           \
+                    ArrayFill(__p_create, __n_create, sizeof(X), &X ## _c); \
             }                                                               \
             __p_create;                                                     \
          })
@@ -497,7 +832,8 @@ void* __new_wEqualizerParameters(size_t cnt)
             __tmp_new_2;                                                            \
          })
 #else*/
-    #define __new_2(X, N) calloc(sizeof(X), N)
+    #define __new_2(X, N)                                                       \
+            AllocMemory(ALLOC_TYPE_NONE, sizeof(X), N)
 /*#endif // _GCC_VERSION
 */
 
@@ -506,6 +842,26 @@ void* __new_wEqualizerParameters(size_t cnt)
             ({  void* __tmp_new_1 = NULL;                           \
                 if (__builtin_types_compatible_p (X, List))         \
                     __tmp_new_1 = ListCreate();                     \
+                else if (__builtin_types_compatible_p (X, UList))   \
+                    __tmp_new_1 = UListCreate();                    \
+                else if (__builtin_types_compatible_p (X, TreeList))\
+                    __tmp_new_1 = TreeListCreate();                 \
+                else if (__builtin_types_compatible_p (X, Vector))  \
+                    __tmp_new_1 = VectorCreate();                   \
+                else if (__builtin_types_compatible_p (X, Deque))   \
+                    __tmp_new_1 = DequeCreate();                    \
+                else if (__builtin_types_compatible_p (X, CList))   \
+                    __tmp_new_1 = CListCreate();                    \
+                else if (__builtin_types_compatible_p (X, String))  \
+                    __tmp_new_1 = StringCreate();                   \
+                else if (__builtin_types_compatible_p (X, WString)) \
+                    __tmp_new_1 = WStringCreate();                  \
+                else if (__builtin_types_compatible_p (X, StringBuilder)) \
+                    __tmp_new_1 = StringBuilderCreate();            \
+                else if (__builtin_types_compatible_p (X, Rope))    \
+                    __tmp_new_1 = RopeCreate();                     \
+                else if (__builtin_types_compatible_p (X, Dictionary)) \
+                    __tmp_new_1 = DictionaryCreate();               \
                 else                                                \
                     __tmp_new_1 = __new_2(X, 1);                    \
                 __tmp_new_1;                                        \
@@ -516,19 +872,34 @@ void* __new_wEqualizerParameters(size_t cnt)
         ({                                                                      \
             void* __tmp_new = NULL;                                             \
             if (NUM_ARGS(__VA_ARGS__) == 1 || NUM_ARGS(__VA_ARGS__) == 2)       \
+            {                                                                   \
+                ALLOC_STATS_SITE(__VA_ARGS__);                                  \
                 __tmp_new = CAT(__new_, NUM_ARGS(__VA_ARGS__))(__VA_ARGS__);    \
+                ALLOC_STATS_SITE_END();                                         \
+            }                                                                   \
             __tmp_new;                                                          \
          })
          
+/** new(T, n) aligned to ALIGN bytes (power of two): new_aligned(float, 1024, 64).
+    Memory is zeroed, defaults of X##_c are not copied as by __create */
+#define new_aligned(X, N, ALIGN)                                                \
+        ({  ALLOC_STATS_SITE(X, N, ALIGN);                                      \
+            void* __tmp_new = AllocMemoryAligned(ALLOC_TYPE_NONE, sizeof(X), N, ALIGN); \
+            ALLOC_STATS_SITE_END();                                             \
+            __tmp_new;                                                          \
+         })
+
+/** new(T, n) in huge pages: new_huge(float, 1 << 24, ALLOC_HUGE_TRANSPARENT).
+    Memory is zeroed, defaults of X##_c are not copied as by __create */
+#define new_huge(X, N, PAGES)                                                   \
+        ({  ALLOC_STATS_SITE(X, N, PAGES);                                      \
+            void* __tmp_new = AllocMemoryHuge(ALLOC_TYPE_NONE, sizeof(X), N, PAGES); \
+            ALLOC_STATS_SITE_END();                                             \
+            __tmp_new;                                                          \
+         })
+
 #define delete(X)                                                               \
-        ({  unsigned id = *(unsigned*)(X);                                      \
-            if (id == __LIST_ID)                                                \
-                ListDestroy(&(X));                                                \
-            else                                                                \
-            {                                                                    \
-                free(X);                                                        \
-                (X) = NULL;                                                     \
-            }                                                                   \
+        ({  AllocDelete((void**)&(X));                                          \
          })
          
 
@@ -0,0 +1,696 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "clist.h"
+#include "alloc.h"
+#include "config.h"
+
+#ifdef __MULTITHREADS
+    #include "thrdpool.h"
+#endif // __MULTITHREADS
+
+
+#define CLIST_CHECK_VALID                           \
+                if (!list) return 0;                \
+                unsigned id = *(unsigned*)list;     \
+                if (id != __CLIST_ID) return 0;
+
+/* low bit of next - element is deleted, its next will not change anymore */
+#define CLIST_MARK ((uintptr_t)1)
+
+/*
+    Removed elements are released by epochs. Thread in read section announces
+    the global epoch, the epoch moves on only when all such threads have seen it.
+    Element removed in epoch E is not seen by anybody when epoch is E + 2.
+*/
+typedef struct CListEpochRecord_tag
+{
+    struct CListEpochRecord_tag* next;
+    unsigned long epoch;                    /* 0 - thread is outside of read section */
+} CListEpochRecord;
+
+static unsigned long     clistEpoch   = 1;
+/* records of all threads ever entered, never released */
+static CListEpochRecord* clistRecords = NULL;
+
+static __thread CListEpochRecord* clistRecord = NULL;
+static __thread unsigned          clistDepth  = 0;
+
+
+static inline bool CListIsMarked (CListElement* next)
+{
+    return ((uintptr_t)next & CLIST_MARK) != 0;
+}
+
+static inline CListElement* CListPointer (CListElement* next)
+{
+    return (CListElement*)((uintptr_t)next & ~CLIST_MARK);
+}
+
+static inline CListElement* CListLoadNext (CListElement* element)
+{
+    return __atomic_load_n(&element->next, __ATOMIC_ACQUIRE);
+}
+
+static inline bool CListCasNext (CListElement** next, CListElement* expected, CListElement* desired)
+{
+    return __atomic_compare_exchange_n(next, &expected, desired, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static CListEpochRecord* CListGetRecord ()
+{
+    if (clistRecord)
+        return clistRecord;
+
+    CListEpochRecord* record = calloc(1, sizeof(CListEpochRecord));
+    if (record == NULL)
+        return NULL;
+
+    record->next = __atomic_load_n(&clistRecords, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&clistRecords, &record->next, record, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+        ;
+
+    clistRecord = record;
+    return record;
+}
+
+bool CListEnter ()
+{
+    if (clistDepth > 0)
+    {
+        ++clistDepth;
+        return true;
+    }
+
+    CListEpochRecord* record = CListGetRecord();
+    if (record == NULL)
+        return false;
+
+    /* epoch may move on between load and store - announce it again */
+    unsigned long epoch;
+    do
+    {
+        epoch = __atomic_load_n(&clistEpoch, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&record->epoch, epoch, __ATOMIC_SEQ_CST);
+    }
+    while (__atomic_load_n(&clistEpoch, __ATOMIC_SEQ_CST) != epoch);
+
+    clistDepth = 1;
+    return true;
+}
+
+void CListLeave ()
+{
+    if (clistDepth == 0)
+        return;
+
+    if (--clistDepth == 0)
+        __atomic_store_n(&clistRecord->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/* move epoch on if all threads in read sections have seen it, return current epoch */
+static unsigned long CListAdvanceEpoch ()
+{
+    unsigned long epoch = __atomic_load_n(&clistEpoch, __ATOMIC_SEQ_CST);
+
+    CListEpochRecord* record = __atomic_load_n(&clistRecords, __ATOMIC_ACQUIRE);
+    for (; record; record = record->next)
+    {
+        unsigned long seen = __atomic_load_n(&record->epoch, __ATOMIC_SEQ_CST);
+        if (seen != 0 && seen != epoch)
+            return epoch;
+    }
+
+    __atomic_compare_exchange_n(&clistEpoch, &epoch, epoch + 1, false,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&clistEpoch, __ATOMIC_SEQ_CST);
+}
+
+/* element is unlinked from list, release it later */
+static void CListRetire (CList* list, CListElement* element)
+{
+    element->retireStage = 0;
+    element->retireEpoch = __atomic_load_n(&clistEpoch, __ATOMIC_SEQ_CST);
+
+    element->retiredNext = __atomic_load_n(&list->retired, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&list->retired, &element->retiredNext, element, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+        ;
+
+    __atomic_fetch_add(&list->retiredCount, 1, __ATOMIC_RELAXED);
+}
+
+/* tail must not point to deleted element - chain of deleted elements may lead to released ones */
+static void CListResetTail (CList* list)
+{
+    CListElement* tail = __atomic_load_n(&list->tail, __ATOMIC_ACQUIRE);
+    if (tail != &list->head && CListIsMarked(CListLoadNext(tail)))
+        __atomic_compare_exchange_n(&list->tail, &tail, &list->head, false,
+                                    __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+/*
+    Release retired elements nobody can see. Tail is the only way to removed
+    element besides the list itself, so element is kept for two grace periods:
+    after the first one tail is moved away from deleted elements,
+    after the second one threads which have read old tail are gone.
+*/
+static void CListReclaim (CList* list)
+{
+    unsigned long epoch = CListAdvanceEpoch();
+    bool tailReset = false;
+
+    CListElement* element = __atomic_exchange_n(&list->retired, NULL, __ATOMIC_ACQ_REL);
+    CListElement* keep     = NULL;
+    CListElement* keepLast = NULL;
+    while (element)
+    {
+        CListElement* next = element->retiredNext;
+
+        if (epoch >= element->retireEpoch + 2)
+        {
+            if (element->retireStage > 0)
+            {
+                free (element);
+                element = next;
+                continue;
+            }
+
+            if (!tailReset)
+            {
+                CListResetTail(list);
+                tailReset = true;
+            }
+            element->retireStage = 1;
+            element->retireEpoch = __atomic_load_n(&clistEpoch, __ATOMIC_SEQ_CST);
+        }
+
+        element->retiredNext = keep;
+        keep = element;
+        if (keepLast == NULL)
+            keepLast = element;
+
+        element = next;
+    }
+
+    if (keep)
+    {
+        keepLast->retiredNext = __atomic_load_n(&list->retired, __ATOMIC_ACQUIRE);
+        while (!__atomic_compare_exchange_n(&list->retired, &keepLast->retiredNext, keep, false,
+                                            __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+            ;
+    }
+}
+
+static void CListTryReclaim (CList* list)
+{
+    if (__atomic_load_n(&list->retiredCount, __ATOMIC_RELAXED) < CLIST_RECLAIM_PERIOD)
+        return;
+
+    if (__atomic_exchange_n(&list->retiredCount, 0, __ATOMIC_RELAXED) >= CLIST_RECLAIM_PERIOD)
+        CListReclaim(list);
+}
+
+/*
+    Find first not deleted element with value (any element if any == true)
+    and unlink deleted elements on the way. Must be called inside read section.
+*/
+static CListElement* CListSearch (CList* list, bool any, void* value, CListElement** predecessor)
+{
+    bool restart = true;
+    while (restart)
+    {
+        restart = false;
+
+        CListElement* pred    = &list->head;
+        CListElement* element = CListPointer(CListLoadNext(pred));
+        while (element)
+        {
+            CListElement* next = CListLoadNext(element);
+            if (CListIsMarked(next))
+            {
+                /* deleted last element stays, append links new element to it */
+                CListElement* succ = CListPointer(next);
+                if (succ == NULL)
+                    break;
+
+                if (!CListCasNext(&pred->next, element, succ))
+                {
+                    restart = true;
+                    break;
+                }
+
+                CListRetire(list, element);
+                element = succ;
+                continue;
+            }
+
+            if (any || element->value == value)
+            {
+                *predecessor = pred;
+                return element;
+            }
+
+            pred    = element;
+            element = next;
+        }
+    }
+
+    return NULL;
+}
+
+/* mark found element as deleted and try to unlink it */
+static bool CListRemove (CList* list, bool any, void* value, void** removed)
+{
+    if (!CListEnter())
+        return false;
+
+    bool result = false;
+    CListElement* pred;
+    CListElement* element;
+    while ((element = CListSearch(list, any, value, &pred)) != NULL)
+    {
+        CListElement* next = CListLoadNext(element);
+        if (CListIsMarked(next) ||
+            !CListCasNext(&element->next, next, (CListElement*)((uintptr_t)next | CLIST_MARK)))
+            continue;
+
+        if (removed)
+            *removed = element->value;
+        __atomic_fetch_sub(&list->size, 1, __ATOMIC_RELAXED);
+
+        /* if it fails, next search unlinks element */
+        if (next && CListCasNext(&pred->next, element, next))
+            CListRetire(list, element);
+
+        result = true;
+        break;
+    }
+
+    CListLeave();
+
+    if (result && clistDepth == 0)
+        CListTryReclaim(list);
+
+    return result;
+}
+
+static CListElement* CListSkipDeleted (CListElement* element)
+{
+    while (element)
+    {
+        CListElement* next = CListLoadNext(element);
+        if (!CListIsMarked(next))
+            break;
+        element = CListPointer(next);
+    }
+
+    return element;
+}
+
+
+void CListInit(void* mem)
+{
+    if (mem)
+    {
+        CList* list = mem;
+
+        /* already initialized? */
+        if (list->__id == __CLIST_ID)
+        {
+            CListClear(list);
+        }
+        else
+        {
+            memset(list, 0, sizeof(CList));
+
+            list->__id      = __CLIST_ID;
+            list->tail      = &list->head;
+
+            list->front     = &CListGetFirstValue;
+            list->push_back = &CListAddElement;
+            list->pop_front = &CListPopFront;
+            list->clear     = &CListClear;
+            list->empty     = &CListIsEmpty;
+        }
+    }
+}
+
+CList* CListCreate()
+{
+    CList* list = AllocMemory(ALLOC_TYPE_CLIST, sizeof(CList), 1);
+    if (list == NULL)
+        return NULL;
+
+    CListInit(list);
+    list->__alloc = true;
+
+    return list;
+}
+
+void CListClear(CList* list)
+{
+    CLIST_CHECK_VALID
+
+    while (CListRemove(list, true, NULL, NULL))
+        ;
+
+    if (clistDepth == 0)
+        CListReclaim(list);
+}
+
+/* release all elements, called by delete() */
+static void CListFinalize (void* object)
+{
+    CList* list = object;
+
+    CListElement* element = CListPointer(list->head.next);
+    while (element)
+    {
+        CListElement* next = CListPointer(element->next);
+        free (element);
+        element = next;
+    }
+
+    element = list->retired;
+    while (element)
+    {
+        CListElement* next = element->retiredNext;
+        free (element);
+        element = next;
+    }
+
+    list->head.next = NULL;
+    list->tail      = &list->head;
+    list->retired   = NULL;
+    list->size      = 0;
+
+    list->__id = 0;
+}
+
+static void __attribute__((constructor)) CListRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_CLIST, CListFinalize);
+}
+
+void CListDestroy (CList** list)
+{
+    if (!list || !(*list))
+        return;
+
+    /* memory of CListInit is released by free() */
+    bool alloc = (*list)->__alloc;
+    CListFinalize(*list);
+
+    if (alloc)
+        AllocFree(*list);
+    else
+        free (*list);
+    *list = NULL;
+}
+
+bool CListAddElement (CList* list, void* value)
+{
+    CLIST_CHECK_VALID
+
+    CListElement* element = malloc(sizeof(CListElement));
+    if (element == NULL)
+        return false;
+
+    memset(element, 0, sizeof(CListElement));
+    element->value = value;
+
+    if (!CListEnter())
+    {
+        free (element);
+        return false;
+    }
+
+    __atomic_fetch_add(&list->size, 1, __ATOMIC_RELAXED);
+
+    CListElement* start = __atomic_load_n(&list->tail, __ATOMIC_ACQUIRE);
+    CListElement* last  = start;
+    for (;;)
+    {
+        CListElement* next = CListLoadNext(last);
+        if (CListPointer(next))
+        {
+            last = CListPointer(next);
+            continue;
+        }
+
+        /* deleted last element keeps its mark */
+        if (CListCasNext(&last->next, next, (CListElement*)((uintptr_t)next | (uintptr_t)element)))
+            break;
+    }
+
+    /* if tail was moved by somebody else, leave it */
+    __atomic_compare_exchange_n(&list->tail, &start, element, false,
+                                __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
+    CListLeave();
+
+    return true;
+}
+
+bool CListDeleteElementByValue (CList* list, void* value)
+{
+    CLIST_CHECK_VALID
+
+    return CListRemove(list, false, value, NULL);
+}
+
+void* CListPopFront (CList* list)
+{
+    CLIST_CHECK_VALID
+
+    void* value = NULL;
+    CListRemove(list, true, NULL, &value);
+
+    return value;
+}
+
+CListElement* CListGetFirst (CList* list)
+{
+    CLIST_CHECK_VALID
+
+    return CListSkipDeleted(CListPointer(CListLoadNext(&list->head)));
+}
+
+CListElement* CListGetNext (CListElement* element)
+{
+    if (!element)
+        return NULL;
+
+    return CListSkipDeleted(CListPointer(CListLoadNext(element)));
+}
+
+void* CListGetFirstValue (CList* list)
+{
+    CLIST_CHECK_VALID
+
+    void* value = NULL;
+    CLIST_READ_SCOPE()
+    {
+        CListElement* first = CListGetFirst(list);
+        if (first)
+            value = first->value;
+    }
+
+    return value;
+}
+
+unsigned CListGetSize (CList* list)
+{
+    CLIST_CHECK_VALID
+
+    return __atomic_load_n(&list->size, __ATOMIC_RELAXED);
+}
+
+bool CListIsEmpty (CList* list)
+{
+    CLIST_CHECK_VALID
+
+    return (CListGetSize(list) == 0);
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#define MAX_CLIST_SIZE 10000
+
+#ifdef __MULTITHREADS
+#define CLIST_TEST_PARTS 8
+
+typedef struct
+{
+    CList* list;
+    int*   array;
+    unsigned removed[CLIST_TEST_PARTS];
+} CListTestJob;
+
+static void CListTestPush (void* arg, unsigned part)
+{
+    CListTestJob* job = arg;
+    for (unsigned i = part; i < MAX_CLIST_SIZE; i += CLIST_TEST_PARTS)
+        assert(CListAddElement(job->list, &job->array[i]));
+}
+
+/* even parts remove values, odd parts walk the list at the same time */
+static void CListTestRemove (void* arg, unsigned part)
+{
+    CListTestJob* job = arg;
+    if (part % 2 == 0)
+    {
+        for (unsigned i = part; i < MAX_CLIST_SIZE; i += CLIST_TEST_PARTS)
+            if (CListDeleteElementByValue(job->list, &job->array[i]))
+                ++job->removed[part];
+    }
+    else
+    {
+        for (unsigned pass = 0; pass < 10; ++pass)
+        {
+            CLIST_READ_SCOPE()
+            {
+                int last = -1;
+                for (CListElement* element = CListGetFirst(job->list); element; element = CListGetNext(element))
+                {
+                    int value = *(int*)element->value;
+                    assert(value > last);
+                    last = value;
+                }
+            }
+        }
+    }
+}
+#endif // __MULTITHREADS
+
+void CListTest()
+{
+    printf ("Concurrent list's tests started!!!\n");
+
+    CList* list = CListCreate();
+    int* array = malloc(MAX_CLIST_SIZE*sizeof(int));
+
+    /* test1 : add and walk */
+    printf ("--------test1--------\n");
+    for (int i = 0; i < MAX_CLIST_SIZE; ++i)
+    {
+        array[i] = i;
+        assert(CListAddElement(list, &array[i]));
+    }
+    assert(CListGetSize(list) == MAX_CLIST_SIZE);
+    assert(CListGetFirstValue(list) == &array[0]);
+    unsigned count = 0;
+    CLIST_READ_SCOPE()
+    {
+        for (CListElement* element = CListGetFirst(list); element; element = CListGetNext(element))
+            assert(element->value == &array[count++]);
+    }
+    assert(count == MAX_CLIST_SIZE);
+    printf ("size of list : %d\n", CListGetSize(list));
+
+    /* test2 : delete and pop */
+    printf ("--------test2--------\n");
+    assert(CListDeleteElementByValue(list, &array[0]));
+    assert(CListDeleteElementByValue(list, &array[100]));
+    assert(CListDeleteElementByValue(list, &array[MAX_CLIST_SIZE - 1]));
+    assert(!CListDeleteElementByValue(list, &array[100]));
+    assert(CListGetSize(list) == MAX_CLIST_SIZE - 3);
+    /* new element is linked after deleted last one */
+    assert(CListAddElement(list, &array[MAX_CLIST_SIZE - 1]));
+    assert(CListPopFront(list) == &array[1]);
+    assert(CListGetFirstValue(list) == &array[2]);
+    count = 0;
+    CLIST_READ_SCOPE()
+    {
+        for (CListElement* element = CListGetFirst(list); element; element = CListGetNext(element))
+            ++count;
+    }
+    assert(count == MAX_CLIST_SIZE - 3);
+    printf ("passed!\n");
+
+    /* test3 : clear releases removed elements */
+    printf ("--------test3--------\n");
+    CListClear(list);
+    assert(CListIsEmpty(list));
+    assert(CListGetFirstValue(list) == NULL);
+    assert(CListPopFront(list) == NULL);
+    assert(CListAddElement(list, &array[5]));
+    assert(CListGetFirstValue(list) == &array[5]);
+    CListClear(list);
+    printf ("passed!\n");
+
+#ifdef __MULTITHREADS
+    /* test4 : many threads add, remove and walk */
+    printf ("--------test4--------\n");
+    CListTestJob job = { .list = list, .array = array };
+    ThreadPoolRun(ThreadPoolGet(), CListTestPush, &job, CLIST_TEST_PARTS);
+    assert(CListGetSize(list) == MAX_CLIST_SIZE);
+
+    bool* seen = calloc(MAX_CLIST_SIZE, sizeof(bool));
+    CLIST_READ_SCOPE()
+    {
+        for (CListElement* element = CListGetFirst(list); element; element = CListGetNext(element))
+        {
+            int value = *(int*)element->value;
+            assert(!seen[value]);
+            seen[value] = true;
+        }
+    }
+    for (int i = 0; i < MAX_CLIST_SIZE; ++i)
+        assert(seen[i]);
+    free(seen);
+
+    /* values were added in any order - add them sorted for walkers */
+    CListClear(list);
+    for (int i = 0; i < MAX_CLIST_SIZE; ++i)
+        CListAddElement(list, &array[i]);
+    ThreadPoolRun(ThreadPoolGet(), CListTestRemove, &job, CLIST_TEST_PARTS);
+    unsigned removed = 0;
+    for (unsigned i = 0; i < CLIST_TEST_PARTS; ++i)
+        removed += job.removed[i];
+    assert(removed == MAX_CLIST_SIZE / 2);
+    assert(CListGetSize(list) == MAX_CLIST_SIZE - removed);
+    printf ("passed!\n");
+#endif // __MULTITHREADS
+
+    /* test5 : destroy */
+    printf ("--------test5--------\n");
+    CListDestroy(&list);
+    assert(list == NULL);
+    printf ("passed!\n");
+
+    free(array);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all concurrent list's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,110 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+#ifndef __CLIST_H
+#define __CLIST_H
+
+#include <stdbool.h>
+
+#define __CLIST_ID 1953720643   /* 'C' 'L' 'i' 's' */
+
+/* elements are released in batches after this count of removed ones */
+#define CLIST_RECLAIM_PERIOD 64
+
+/* element of concurrent list, low bit of next marks element as deleted */
+typedef struct CListElement_tag
+{
+    void* value;
+    struct CListElement_tag* next;
+
+    /* removed element waits here until no thread can see it */
+    struct CListElement_tag* retiredNext;
+    unsigned long retireEpoch;
+    unsigned      retireStage;
+} CListElement;
+
+/* singly-linked list with lock-free append and removal for many threads */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of CListCreate from AllocMemory, else of malloc */
+
+    unsigned size;
+
+    CListElement  head;          /* sentinel, head.next is first element */
+    CListElement* tail;          /* hint where append starts search of last element */
+
+    CListElement* retired;       /* unlinked elements waiting for release */
+    unsigned      retiredCount;
+
+    void* (*front)(void* this);
+    bool  (*push_back)(void* this, void* value);
+    void* (*pop_front)(void* this);
+    bool  (*empty)(void* this);
+    void  (*clear)(void* this);
+} CList;
+
+/** init memory as concurrent list */
+void CListInit(void* mem);
+/** create concurrent list and return pointer to list */
+CList* CListCreate();
+/** remove all elements from list, may be called together with other threads */
+void CListClear (CList* list);
+/** destroy list, no other thread may use list now */
+void CListDestroy (CList** list);
+
+/** add value to end of list, return false if not */
+bool CListAddElement (CList* list, void* value);
+/** remove first element with value, return false if there is no such element */
+bool CListDeleteElementByValue (CList* list, void* value);
+/** remove first element and return its value, NULL if list is empty */
+void* CListPopFront (CList* list);
+
+/* TRAVERSAL */
+/** enter read section of thread, elements seen inside are not released.
+    Sections may be nested, return false if thread can't be registered */
+bool CListEnter();
+/** leave read section of thread */
+void CListLeave();
+/** read section in block: CLIST_READ_SCOPE() { ... } */
+#define CLIST_READ_SCOPE()                                                      \
+        for (int __clist_scope = CListEnter();                                  \
+             __clist_scope;                                                     \
+             __clist_scope = (CListLeave(), 0))
+/** get first not deleted element, only inside read section */
+CListElement* CListGetFirst (CList* list);
+/** get next not deleted element, only inside read section */
+CListElement* CListGetNext (CListElement* element);
+
+/* GETTERS */
+/** get value of first element */
+void* CListGetFirstValue (CList* list);
+/** get count of elements in list */
+unsigned CListGetSize (CList* list);
+/** check empty list */
+bool CListIsEmpty (CList* list);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void CListTest();
+#endif // _DEBUG
+
+#endif // __CLIST_H
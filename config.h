@@ -0,0 +1,30 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __CONFIG_H
+#define __CONFIG_H
+
+/* use worker threads for search in big containers */
+//#define __MULTITHREADS
+/* threads of SDL2 instead of tinycthread */
+//#define __USE_SDL_THREADS
+/* count allocations of new() by call sites and print report at exit */
+//#define __ALLOC_STATS
+
+#endif // __CONFIG_H
@@ -0,0 +1,439 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "deque.h"
+#include "alloc.h"
+#include "ptrscan.h"
+
+
+#define DEQUE_CHECK_VALID                           \
+                if (!deque) return 0;               \
+                unsigned id = *(unsigned*)deque;    \
+                if (id != __DEQUE_ID) return 0;
+
+
+static inline unsigned DequeIndex (Deque* deque, unsigned numOfElement)
+{
+    return (deque->head + numOfElement) & (deque->capacity - 1);
+}
+
+/* new buffer of capacity (power of two, not less than size), values are moved to its begin */
+static bool DequeResize (Deque* deque, unsigned capacity)
+{
+    void** data = malloc(capacity * sizeof(void*));
+    if (data == NULL)
+        return false;
+
+    /* values go by two parts: from head to end of buffer and wrapped ones */
+    unsigned first = deque->capacity - deque->head;
+    if (first > deque->size)
+        first = deque->size;
+    if (deque->size)
+    {
+        memcpy(data, &deque->data[deque->head], first * sizeof(void*));
+        memcpy(&data[first], deque->data, (deque->size - first) * sizeof(void*));
+    }
+
+    free(deque->data);
+    deque->data     = data;
+    deque->capacity = capacity;
+    deque->head     = 0;
+
+    return true;
+}
+
+/* grow twice, so push takes amortized O(1) */
+static bool DequeGrow (Deque* deque)
+{
+    if (deque->size < deque->capacity)
+        return true;
+
+    if (deque->capacity == 0)
+    {
+        deque->data = malloc(DEQUE_MIN_CAPACITY * sizeof(void*));
+        if (deque->data == NULL)
+            return false;
+        deque->capacity = DEQUE_MIN_CAPACITY;
+        deque->head     = 0;
+        return true;
+    }
+
+    if (deque->capacity > UINT32_MAX / 2 / sizeof(void*))
+        return false;
+
+    /* whole buffer is used: realloc and move wrapped values after old end */
+    unsigned capacity = deque->capacity;
+    void** data = realloc(deque->data, 2 * capacity * sizeof(void*));
+    if (data == NULL)
+        return false;
+
+    if (deque->head > 0)
+        memcpy(&data[capacity], data, deque->head * sizeof(void*));
+
+    deque->data     = data;
+    deque->capacity = 2 * capacity;
+
+    return true;
+}
+
+
+void DequeInit(void* mem)
+{
+    if (mem)
+    {
+        Deque* deque = mem;
+
+        /* already initialized? */
+        if (deque->__id == __DEQUE_ID)
+        {
+            DequeClear(deque);
+        }
+        else
+        {
+            memset(deque, 0, sizeof(Deque));
+
+            deque->__id       = __DEQUE_ID;
+
+            deque->front      = &DequeGetFirstValue;
+            deque->back       = &DequeGetLastValue;
+            deque->push_back  = &DequePushBack;
+            deque->push_front = &DequePushFront;
+            deque->pop_back   = &DequePopBack;
+            deque->pop_front  = &DequePopFront;
+            deque->at         = &DequeGetValueByNumber;
+            deque->clear      = &DequeClear;
+            deque->empty      = &DequeIsEmpty;
+            deque->reserve    = &DequeReserve;
+        }
+    }
+}
+
+Deque* DequeCreate()
+{
+    Deque* deque = AllocMemory(ALLOC_TYPE_DEQUE, sizeof(Deque), 1);
+    if (deque == NULL)
+        return NULL;
+
+    deque->__id = 0;
+    DequeInit(deque);
+    deque->__alloc = true;
+
+    return deque;
+}
+
+void DequeClear(Deque* deque)
+{
+    DEQUE_CHECK_VALID
+
+    deque->size = 0;
+    deque->head = 0;
+}
+
+/* release data of deque, called by delete() */
+static void DequeFinalize (void* object)
+{
+    Deque* deque = object;
+
+    free (deque->data);
+
+    deque->__id = 0;
+}
+
+static void __attribute__((constructor)) DequeRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_DEQUE, DequeFinalize);
+}
+
+void DequeDestroy (Deque** deque)
+{
+    if (!deque || !(*deque))
+        return;
+
+    /* memory of DequeInit is released by free() */
+    bool alloc = (*deque)->__alloc;
+    DequeFinalize(*deque);
+
+    if (alloc)
+        AllocFree(*deque);
+    else
+        free (*deque);
+    *deque = NULL;
+}
+
+bool DequeReserve (Deque* deque, unsigned capacity)
+{
+    DEQUE_CHECK_VALID
+
+    if (capacity <= deque->capacity)
+        return true;
+    if (capacity > UINT32_MAX / 2 / sizeof(void*))
+        return false;
+
+    unsigned newCapacity = DEQUE_MIN_CAPACITY;
+    while (newCapacity < capacity)
+        newCapacity *= 2;
+
+    return DequeResize(deque, newCapacity);
+}
+
+bool DequeShrinkToFit (Deque* deque)
+{
+    DEQUE_CHECK_VALID
+
+    unsigned capacity = DEQUE_MIN_CAPACITY;
+    while (capacity < deque->size)
+        capacity *= 2;
+
+    if (capacity >= deque->capacity)
+        return true;
+
+    return DequeResize(deque, capacity);
+}
+
+bool DequePushBack (Deque* deque, void* value)
+{
+    DEQUE_CHECK_VALID
+
+    if (!DequeGrow(deque))
+        return false;
+
+    deque->data[DequeIndex(deque, deque->size)] = value;
+    ++deque->size;
+
+    return true;
+}
+
+bool DequePushFront (Deque* deque, void* value)
+{
+    DEQUE_CHECK_VALID
+
+    if (!DequeGrow(deque))
+        return false;
+
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->data[deque->head] = value;
+    ++deque->size;
+
+    return true;
+}
+
+void* DequePopBack (Deque* deque)
+{
+    DEQUE_CHECK_VALID
+
+    if (deque->size == 0)
+        return NULL;
+
+    --deque->size;
+    return deque->data[DequeIndex(deque, deque->size)];
+}
+
+void* DequePopFront (Deque* deque)
+{
+    DEQUE_CHECK_VALID
+
+    if (deque->size == 0)
+        return NULL;
+
+    void* value = deque->data[deque->head];
+    deque->head = (deque->head + 1) & (deque->capacity - 1);
+    --deque->size;
+
+    return value;
+}
+
+void* DequeGetFirstValue (Deque* deque)
+{
+    DEQUE_CHECK_VALID
+
+    if (deque->size)
+        return deque->data[deque->head];
+    return NULL;
+}
+
+void* DequeGetLastValue (Deque* deque)
+{
+    DEQUE_CHECK_VALID
+
+    if (deque->size)
+        return deque->data[DequeIndex(deque, deque->size - 1)];
+    return NULL;
+}
+
+void* DequeGetValueByNumber (Deque* deque, unsigned numOfElement)
+{
+    DEQUE_CHECK_VALID
+
+    if (numOfElement >= deque->size)
+        return NULL;
+
+    return deque->data[DequeIndex(deque, numOfElement)];
+}
+
+int DequeGetNumberByValue (Deque* deque, const void* value)
+{
+    if (!deque || deque->__id != __DEQUE_ID || !value || deque->size == 0)
+        return -1;
+
+    /* search in part up to end of buffer, then in wrapped part */
+    size_t first = deque->capacity - deque->head;
+    if (first > deque->size)
+        first = deque->size;
+
+    size_t i = PtrScanFind((void* const*)&deque->data[deque->head], first, value);
+    if (i < first)
+        return (int)i;
+
+    size_t rest = deque->size - first;
+    i = PtrScanFind((void* const*)deque->data, rest, value);
+    return (i < rest) ? (int)(first + i) : -1;
+}
+
+unsigned DequeGetSize (Deque* deque)
+{
+    DEQUE_CHECK_VALID
+
+    return deque->size;
+}
+
+bool DequeIsEmpty (Deque* deque)
+{
+    if (!deque || deque->__id != __DEQUE_ID)
+        return true;
+
+    return (deque->size == 0);
+}
+
+void DequeSetValueByNumber (Deque* deque, unsigned numOfElement, void* value)
+{
+    DEQUE_CHECK_VALID
+
+    if (numOfElement >= deque->size)
+        return;
+
+    deque->data[DequeIndex(deque, numOfElement)] = value;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#include "cext.h"
+
+#define MAX_DEQUE_SIZE 6000
+
+void DequeTest()
+{
+    printf ("Deque's tests started!!!\n");
+
+    int* array = malloc(MAX_DEQUE_SIZE * sizeof(int));
+    for (unsigned i = 0; i < MAX_DEQUE_SIZE; ++i)
+        array[i] = i;
+    Deque* deque = new(Deque);
+
+    /* test1 : push at both ends */
+    printf ("--------test1--------\n");
+    assert(deque->empty(deque) && deque->pop_front(deque) == NULL);
+    for (unsigned i = 0; i < MAX_DEQUE_SIZE / 2; ++i)
+    {
+        assert(deque->push_back(deque, &array[MAX_DEQUE_SIZE / 2 + i]));
+        assert(deque->push_front(deque, &array[MAX_DEQUE_SIZE / 2 - 1 - i]));
+    }
+    assert(DequeGetSize(deque) == MAX_DEQUE_SIZE);
+    assert((deque->capacity & (deque->capacity - 1)) == 0);
+    assert(deque->front(deque) == &array[0]);
+    assert(deque->back(deque)  == &array[MAX_DEQUE_SIZE - 1]);
+    printf ("passed!\n");
+
+    /* test2 : get value by number */
+    printf ("--------test2--------\n");
+    for (unsigned i = 0; i < MAX_DEQUE_SIZE; ++i)
+        assert(DequeAt(deque, i) == &array[i] && deque->at(deque, i) == &array[i]);
+    assert(DequeGetValueByNumber(deque, MAX_DEQUE_SIZE) == NULL);
+    assert(DequeGetNumberByValue(deque, &array[77]) == 77);
+    assert(DequeGetNumberByValue(deque, &array[MAX_DEQUE_SIZE - 1]) == MAX_DEQUE_SIZE - 1);
+    DequeSetValueByNumber(deque, 5, &array[6]);
+    assert(DequeAt(deque, 5) == &array[6]);
+    DequeSetValueByNumber(deque, 5, &array[5]);
+    printf ("passed!\n");
+
+    /* test3 : pop at both ends */
+    printf ("--------test3--------\n");
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        assert(deque->pop_front(deque) == &array[i]);
+        assert(deque->pop_back(deque) == &array[MAX_DEQUE_SIZE - 1 - i]);
+    }
+    assert(DequeGetSize(deque) == MAX_DEQUE_SIZE - 200);
+    assert(DequeGetFirstValue(deque) == &array[100]);
+    assert(DequeGetNumberByValue(deque, &array[50]) == -1);
+    printf ("passed!\n");
+
+    /* test4 : queue keeps small buffer and grows while wrapped */
+    printf ("--------test4--------\n");
+    DequeClear(deque);
+    assert(DequeShrinkToFit(deque) && deque->capacity == DEQUE_MIN_CAPACITY);
+    unsigned count = MAX_DEQUE_SIZE - 4;    /* last values are wrapped */
+    for (unsigned i = 0; i < count; ++i)
+    {
+        assert(DequePushBack(deque, &array[i]));
+        if (i >= 5)
+            assert(DequePopFront(deque) == &array[i - 5]);
+    }
+    assert(deque->capacity == DEQUE_MIN_CAPACITY && DequeGetSize(deque) == 5);
+    assert(deque->head + DequeGetSize(deque) > deque->capacity);
+    for (unsigned i = 0; i < 20; ++i)
+        assert(DequePushBack(deque, &array[i]));
+    assert(DequeGetSize(deque) == 25);
+    for (unsigned i = 0; i < 5; ++i)
+        assert(DequeAt(deque, i) == &array[count - 5 + i]);
+    for (unsigned i = 0; i < 20; ++i)
+        assert(DequeAt(deque, 5 + i) == &array[i]);
+    assert(DequeGetNumberByValue(deque, &array[3]) == 8);
+    assert(DequeReserve(deque, 100) && deque->capacity == 128);
+    assert(DequeAt(deque, 0) == &array[count - 5] && DequeAt(deque, 24) == &array[19]);
+    printf ("passed!\n");
+
+    /* test5 : clear and destroy */
+    printf ("--------test5--------\n");
+    DequeClear(deque);
+    assert(DequeIsEmpty(deque));
+    assert(DequeGetFirstValue(deque) == NULL && DequePopBack(deque) == NULL);
+    delete(deque);
+    assert(deque == NULL);
+    deque = DequeCreate();
+    DequePushFront(deque, &array[1]);
+    assert(DequeGetLastValue(deque) == &array[1]);
+    DequeDestroy(&deque);
+    assert(deque == NULL);
+    printf ("passed!\n");
+
+    free(array);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all deque's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,105 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __DEQUE_H
+#define __DEQUE_H
+
+#include <stdbool.h>
+
+#define __DEQUE_ID 1970365764   /* 'D' 'e' 'q' 'u' */
+
+#define DEQUE_MIN_CAPACITY 8    /* capacity after first push */
+
+/* ring buffer of values, push and pop at both ends and access by number in O(1) */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of DequeCreate from AllocMemory, else of malloc */
+
+    unsigned size;
+    unsigned capacity;         /* power of two */
+    unsigned head;             /* index of first value in data */
+
+    void** data;               /* value by number i is data[(head + i) & (capacity - 1)] */
+
+    void* (*front)(void* this);
+    void* (*back) (void* this);
+    bool  (*push_back) (void* this, void* value);
+    bool  (*push_front)(void* this, void* value);
+    void* (*pop_back)  (void* this);
+    void* (*pop_front) (void* this);
+    bool  (*empty)(void* this);
+    void  (*clear)(void* this);
+    void* (*at)(void* this, unsigned position);
+    bool  (*reserve)(void* this, unsigned capacity);
+} Deque;
+
+/** value by number without checks, number must be less than size */
+#define DequeAt(deque, numOfElement) \
+        ((deque)->data[((deque)->head + (numOfElement)) & ((deque)->capacity - 1)])
+
+/** init memory as deque */
+void DequeInit(void* mem);
+/** create deque and return pointer to deque */
+Deque* DequeCreate ();
+/** delete all values in deque, memory is kept */
+void DequeClear (Deque* deque);
+/** clear and destroy deque */
+void DequeDestroy (Deque** deque);
+
+/** make room for capacity values (rounded up to power of two), return false if not */
+bool DequeReserve (Deque* deque, unsigned capacity);
+/** free unused memory down to power of two, return false if not */
+bool DequeShrinkToFit (Deque* deque);
+
+/** add value to end of deque, return false if not */
+bool DequePushBack (Deque* deque, void* value);
+/** add value to begin of deque, return false if not */
+bool DequePushFront (Deque* deque, void* value);
+/** delete last value from deque and return it (NULL if deque is empty) */
+void* DequePopBack (Deque* deque);
+/** delete first value from deque and return it (NULL if deque is empty) */
+void* DequePopFront (Deque* deque);
+
+/* GETTERS */
+/** get first value from deque */
+void* DequeGetFirstValue (Deque* deque);
+/** get last value from deque */
+void* DequeGetLastValue (Deque* deque);
+/** return value by number in deque */
+void* DequeGetValueByNumber (Deque* deque, unsigned numOfElement);
+/** return number of value in deque (if exists), else return -1 */
+int DequeGetNumberByValue (Deque* deque, const void* value);
+
+/** get count of values in deque */
+unsigned DequeGetSize (Deque* deque);
+/** check empty deque */
+bool DequeIsEmpty (Deque* deque);
+
+/* SETTERS */
+/** set value by position in deque */
+void DequeSetValueByNumber (Deque* deque, unsigned numOfElement, void* value);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void DequeTest();
+#endif // _DEBUG
+
+#endif // __DEQUE_H
@@ -0,0 +1,617 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dict.h"
+#include "alloc.h"
+#include "str.h"
+
+
+#define DICTIONARY_CHECK_VALID                      \
+                if (!dict) return 0;                \
+                unsigned id = *(unsigned*)dict;     \
+                if (id != __DICTIONARY_ID) return 0;
+
+/* max count of entries for capacity - 7/8 */
+#define DICTIONARY_MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+
+#define DICTIONARY_MIN_PROBES 16     /* probeLimit for small capacities */
+#define DICTIONARY_MAX_PROBES 200    /* distance + 1 must fit in byte of meta */
+
+#define DICTIONARY_DISTANCE(meta) ((meta) & 0xFF)
+
+
+static inline uint64_t DictionaryHash (unsigned keyType, const void* key)
+{
+    if (keyType == DICTIONARY_KEY_STRING)
+        return StringHashChars(key, strlen(key));
+
+    /* pointers are aligned and integers are small, mix all bits */
+    uint64_t x = (uint64_t)(uintptr_t)key;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline bool DictionaryKeyEqual (unsigned keyType, const void* a, const void* b)
+{
+    return (keyType == DICTIONARY_KEY_STRING) ? strcmp(a, b) == 0 : a == b;
+}
+
+/* meta of entry in its home slot */
+static inline uint32_t DictionaryMeta (uint64_t hash)
+{
+    return (uint32_t)(hash >> 40) << 8 | 1;
+}
+
+static inline unsigned DictionaryHome (Dictionary* dict, uint64_t hash)
+{
+    return (unsigned)(hash >> dict->shift);
+}
+
+static inline size_t DictionarySlots (Dictionary* dict)
+{
+    return (dict->capacity) ? (size_t)dict->capacity + dict->probeLimit + 1 : 0;
+}
+
+/* slot of key or -1 */
+static int DictionaryFindSlot (Dictionary* dict, const void* key, uint64_t hash)
+{
+    if (dict->size == 0)
+        return -1;
+
+    const uint32_t* meta = dict->meta;
+    unsigned pos  = DictionaryHome(dict, hash);
+    uint32_t want = DictionaryMeta(hash);
+
+    /* entries of cluster are sorted by home, so search stops at entry nearer to its home */
+    for (;; ++pos, ++want)
+    {
+        uint32_t m = meta[pos];
+        if (m == want && DictionaryKeyEqual(dict->keyType, dict->entries[pos].key, key))
+            return (int)pos;
+        if (DICTIONARY_DISTANCE(m) < DICTIONARY_DISTANCE(want))
+            return -1;
+    }
+}
+
+/* put entry of new key before first entry nearer to its home, entries up to empty slot move by one.
+   Return false and don't change anything if some entry would go farther than probeLimit */
+static bool DictionaryPlace (Dictionary* dict, uint64_t hash, const DictionaryEntry* entry)
+{
+    uint32_t* meta = dict->meta;
+    uint32_t  limit = dict->probeLimit + 1;
+    unsigned  pos  = DictionaryHome(dict, hash);
+    uint32_t  want = DictionaryMeta(hash);
+
+    while (DICTIONARY_DISTANCE(meta[pos]) >= DICTIONARY_DISTANCE(want))
+    {
+        ++pos;
+        ++want;
+    }
+    if (DICTIONARY_DISTANCE(want) > limit)
+        return false;
+
+    unsigned end = pos;
+    while (meta[end] != 0)
+    {
+        if (DICTIONARY_DISTANCE(meta[end]) >= limit)
+            return false;
+        ++end;
+    }
+    /* last slot stays empty, it stops searches */
+    if (end >= dict->capacity + dict->probeLimit)
+        return false;
+
+    for (unsigned i = end; i > pos; --i)
+        meta[i] = meta[i - 1] + 1;
+    memmove(&dict->entries[pos + 1], &dict->entries[pos], (end - pos) * sizeof(DictionaryEntry));
+
+    meta[pos] = want;
+    dict->entries[pos] = *entry;
+
+    return true;
+}
+
+/* move entries to new arrays of capacity slots, capacity grows if entries don't fit */
+static bool DictionaryRehash (Dictionary* dict, unsigned capacity)
+{
+    uint32_t*        oldMeta    = dict->meta;
+    DictionaryEntry* oldEntries = dict->entries;
+    size_t           oldSlots   = DictionarySlots(dict);
+    unsigned         oldCapacity   = dict->capacity;
+    unsigned         oldShift      = dict->shift;
+    unsigned         oldProbeLimit = dict->probeLimit;
+
+    for (; capacity > 0; capacity *= 2)
+    {
+        unsigned bits = __builtin_ctz(capacity);
+        unsigned probeLimit = bits * 2;
+        if (probeLimit < DICTIONARY_MIN_PROBES)
+            probeLimit = DICTIONARY_MIN_PROBES;
+        if (probeLimit > DICTIONARY_MAX_PROBES)
+            probeLimit = DICTIONARY_MAX_PROBES;
+
+        size_t slots = (size_t)capacity + probeLimit + 1;
+        uint32_t*        meta    = calloc(slots, sizeof(uint32_t));
+        DictionaryEntry* entries = malloc(slots * sizeof(DictionaryEntry));
+        if (meta == NULL || entries == NULL)
+        {
+            free(meta);
+            free(entries);
+            break;
+        }
+
+        dict->meta       = meta;
+        dict->entries    = entries;
+        dict->capacity   = capacity;
+        dict->shift      = 64 - bits;
+        dict->probeLimit = probeLimit;
+
+        /* home of up to 2^24 slots is in 24 bits of hash in meta */
+        size_t i = 0;
+        for (; i < oldSlots; ++i)
+        {
+            if (oldMeta[i] == 0)
+                continue;
+
+            uint64_t hash = (bits <= 24) ? (uint64_t)(oldMeta[i] >> 8) << 40
+                                         : DictionaryHash(dict->keyType, oldEntries[i].key);
+            if (!DictionaryPlace(dict, hash, &oldEntries[i]))
+                break;
+        }
+
+        if (i == oldSlots)
+        {
+            free(oldMeta);
+            free(oldEntries);
+            return true;
+        }
+
+        free(meta);
+        free(entries);
+    }
+
+    dict->meta       = oldMeta;
+    dict->entries    = oldEntries;
+    dict->capacity   = oldCapacity;
+    dict->shift      = oldShift;
+    dict->probeLimit = oldProbeLimit;
+
+    return false;
+}
+
+/* delete entry, next entries of cluster move back by one */
+static void DictionaryEraseSlot (Dictionary* dict, unsigned pos)
+{
+    uint32_t* meta = dict->meta;
+
+    if (dict->keyType == DICTIONARY_KEY_STRING)
+        free(dict->entries[pos].key);
+
+    unsigned end = pos + 1;
+    while (DICTIONARY_DISTANCE(meta[end]) > 1)
+        ++end;
+
+    for (unsigned i = pos; i + 1 < end; ++i)
+        meta[i] = meta[i + 1] - 1;
+    memmove(&dict->entries[pos], &dict->entries[pos + 1], (end - pos - 1) * sizeof(DictionaryEntry));
+
+    meta[end - 1] = 0;
+    --dict->size;
+}
+
+/* free copies of string keys */
+static void DictionaryFreeKeys (Dictionary* dict)
+{
+    if (dict->keyType != DICTIONARY_KEY_STRING || dict->size == 0)
+        return;
+
+    size_t slots = DictionarySlots(dict);
+    for (size_t i = 0; i < slots; ++i)
+    {
+        if (dict->meta[i])
+            free(dict->entries[i].key);
+    }
+}
+
+
+void DictionaryInit(void* mem)
+{
+    if (mem)
+    {
+        Dictionary* dict = mem;
+
+        /* already initialized? */
+        if (dict->__id == __DICTIONARY_ID)
+        {
+            DictionaryClear(dict);
+        }
+        else
+        {
+            memset(dict, 0, sizeof(Dictionary));
+
+            dict->__id     = __DICTIONARY_ID;
+            dict->keyType  = DICTIONARY_KEY_POINTER;
+
+            dict->set      = &DictionarySet;
+            dict->get      = &DictionaryGet;
+            dict->contains = &DictionaryContains;
+            dict->erase    = &DictionaryErase;
+            dict->empty    = &DictionaryIsEmpty;
+            dict->clear    = &DictionaryClear;
+            dict->reserve  = &DictionaryReserve;
+        }
+    }
+}
+
+Dictionary* DictionaryCreate()
+{
+    return DictionaryCreateWithKeys(DICTIONARY_KEY_POINTER);
+}
+
+Dictionary* DictionaryCreateWithKeys (unsigned keyType)
+{
+    if (keyType > DICTIONARY_KEY_STRING)
+        return NULL;
+
+    Dictionary* dict = AllocMemory(ALLOC_TYPE_DICTIONARY, sizeof(Dictionary), 1);
+    if (dict == NULL)
+        return NULL;
+
+    dict->__id = 0;
+    DictionaryInit(dict);
+    dict->__alloc = true;
+    dict->keyType = keyType;
+
+    return dict;
+}
+
+bool DictionarySetKeyType (Dictionary* dict, unsigned keyType)
+{
+    DICTIONARY_CHECK_VALID
+
+    if (dict->size > 0 || keyType > DICTIONARY_KEY_STRING)
+        return false;
+
+    dict->keyType = keyType;
+    return true;
+}
+
+void DictionaryClear (Dictionary* dict)
+{
+    DICTIONARY_CHECK_VALID
+
+    DictionaryFreeKeys(dict);
+    if (dict->meta)
+        memset(dict->meta, 0, DictionarySlots(dict) * sizeof(uint32_t));
+    dict->size = 0;
+}
+
+/* release entries of dictionary, called by delete() */
+static void DictionaryFinalize (void* object)
+{
+    Dictionary* dict = object;
+
+    DictionaryFreeKeys(dict);
+    free (dict->meta);
+    free (dict->entries);
+
+    dict->__id = 0;
+}
+
+static void __attribute__((constructor)) DictionaryRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_DICTIONARY, DictionaryFinalize);
+}
+
+void DictionaryDestroy (Dictionary** dict)
+{
+    if (!dict || !(*dict))
+        return;
+
+    /* memory of DictionaryInit is released by free() */
+    bool alloc = (*dict)->__alloc;
+    DictionaryFinalize(*dict);
+
+    if (alloc)
+        AllocFree(*dict);
+    else
+        free (*dict);
+    *dict = NULL;
+}
+
+bool DictionaryReserve (Dictionary* dict, unsigned count)
+{
+    DICTIONARY_CHECK_VALID
+
+    unsigned capacity = DICTIONARY_MIN_CAPACITY;
+    while (DICTIONARY_MAX_LOAD(capacity) < count)
+    {
+        if (capacity > UINT32_MAX / 4)
+            return false;
+        capacity *= 2;
+    }
+
+    if (capacity <= dict->capacity)
+        return true;
+
+    return DictionaryRehash(dict, capacity);
+}
+
+bool DictionarySet (Dictionary* dict, const void* key, void* value)
+{
+    DICTIONARY_CHECK_VALID
+
+    if (dict->keyType == DICTIONARY_KEY_STRING && !key)
+        return false;
+
+    uint64_t hash = DictionaryHash(dict->keyType, key);
+    int slot = DictionaryFindSlot(dict, key, hash);
+    if (slot >= 0)
+    {
+        dict->entries[slot].value = value;
+        return true;
+    }
+
+    if (dict->size + 1 > DICTIONARY_MAX_LOAD(dict->capacity) &&
+        !DictionaryReserve(dict, dict->size + 1))
+        return false;
+
+    DictionaryEntry entry = {(void*)key, value};
+    if (dict->keyType == DICTIONARY_KEY_STRING)
+    {
+        size_t length = strlen(key) + 1;
+        entry.key = malloc(length);
+        if (entry.key == NULL)
+            return false;
+        memcpy(entry.key, key, length);
+    }
+
+    /* long cluster - table grows */
+    while (!DictionaryPlace(dict, hash, &entry))
+    {
+        if (!DictionaryRehash(dict, dict->capacity * 2))
+        {
+            if (dict->keyType == DICTIONARY_KEY_STRING)
+                free(entry.key);
+            return false;
+        }
+    }
+
+    ++dict->size;
+    return true;
+}
+
+bool DictionaryErase (Dictionary* dict, const void* key)
+{
+    DICTIONARY_CHECK_VALID
+
+    if (dict->keyType == DICTIONARY_KEY_STRING && !key)
+        return false;
+
+    int slot = DictionaryFindSlot(dict, key, DictionaryHash(dict->keyType, key));
+    if (slot < 0)
+        return false;
+
+    DictionaryEraseSlot(dict, slot);
+    return true;
+}
+
+
+
+/* GETTERS */
+void* DictionaryGet (Dictionary* dict, const void* key)
+{
+    void* value = NULL;
+    DictionaryFind(dict, key, &value);
+    return value;
+}
+
+bool DictionaryFind (Dictionary* dict, const void* key, void** value)
+{
+    DICTIONARY_CHECK_VALID
+
+    if (dict->keyType == DICTIONARY_KEY_STRING && !key)
+        return false;
+
+    int slot = DictionaryFindSlot(dict, key, DictionaryHash(dict->keyType, key));
+    if (slot < 0)
+        return false;
+
+    if (value)
+        *value = dict->entries[slot].value;
+    return true;
+}
+
+bool DictionaryContains (Dictionary* dict, const void* key)
+{
+    return DictionaryFind(dict, key, NULL);
+}
+
+unsigned DictionaryGetSize (Dictionary* dict)
+{
+    DICTIONARY_CHECK_VALID
+
+    return dict->size;
+}
+
+bool DictionaryIsEmpty (Dictionary* dict)
+{
+    if (!dict || dict->__id != __DICTIONARY_ID)
+        return true;
+
+    return dict->size == 0;
+}
+
+bool DictionaryIterate (Dictionary* dict, unsigned* position, void** key, void** value)
+{
+    DICTIONARY_CHECK_VALID
+
+    if (!position)
+        return false;
+
+    size_t slots = DictionarySlots(dict);
+    for (size_t i = *position; i < slots; ++i)
+    {
+        if (dict->meta[i] == 0)
+            continue;
+
+        if (key)
+            *key = dict->entries[i].key;
+        if (value)
+            *value = dict->entries[i].value;
+        *position = (unsigned)i + 1;
+        return true;
+    }
+
+    *position = (unsigned)slots;
+    return false;
+}
+
+void DictionaryEraseIterated (Dictionary* dict, unsigned* position)
+{
+    if (!dict || dict->__id != __DICTIONARY_ID || !position || *position == 0)
+        return;
+
+    /* next entries move back to this slot, so it is visited again */
+    unsigned slot = *position - 1;
+    if (slot < DictionarySlots(dict) && dict->meta[slot])
+    {
+        DictionaryEraseSlot(dict, slot);
+        *position = slot;
+    }
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#include "cext.h"
+
+#define MAX_DICTIONARY_SIZE 100000
+
+void DictionaryTest()
+{
+    printf ("Dictionary's tests started!!!\n");
+
+    /* test1 : pointer keys */
+    printf ("--------test1--------\n");
+    int values[10];
+    Dictionary* dict = new(Dictionary);
+    assert(dict != NULL && dict->empty(dict));
+    for (int i = 0; i < 10; ++i)
+        assert(dict->set(dict, &values[i], &values[9 - i]));
+    assert(DictionaryGetSize(dict) == 10);
+    assert(dict->get(dict, &values[3]) == &values[6]);
+    assert(dict->set(dict, &values[3], NULL));
+    assert(DictionaryGetSize(dict) == 10);
+    void* value = &values[0];
+    assert(DictionaryFind(dict, &values[3], &value) && value == NULL);
+    assert(!dict->contains(dict, &value));
+    assert(dict->erase(dict, &values[3]) && !dict->erase(dict, &values[3]));
+    assert(DictionaryGetSize(dict) == 9 && !dict->contains(dict, &values[3]));
+    assert(!DictionarySetKeyType(dict, DICTIONARY_KEY_STRING));
+    delete(dict);
+    assert(dict == NULL);
+    printf ("passed!\n");
+
+    /* test2 : many integer keys, erase and reserve */
+    printf ("--------test2--------\n");
+    dict = DictionaryCreateWithKeys(DICTIONARY_KEY_INTEGER);
+    assert(DictionaryReserve(dict, MAX_DICTIONARY_SIZE));
+    unsigned capacity = dict->capacity;
+    for (int i = 0; i < MAX_DICTIONARY_SIZE; ++i)
+        assert(DictionarySet(dict, DICTIONARY_INT(i * 7), (void*)(intptr_t)i));
+    assert(dict->capacity == capacity);
+    assert(DictionaryGetSize(dict) == MAX_DICTIONARY_SIZE);
+    for (int i = 0; i < MAX_DICTIONARY_SIZE; i += 2)
+        assert(DictionaryErase(dict, DICTIONARY_INT(i * 7)));
+    for (int i = 0; i < MAX_DICTIONARY_SIZE; ++i)
+    {
+        assert(DictionaryContains(dict, DICTIONARY_INT(i * 7)) == (i & 1));
+        assert(!DictionaryContains(dict, DICTIONARY_INT(i * 7 + 1)));
+        if (i & 1)
+            assert(DictionaryGet(dict, DICTIONARY_INT(i * 7)) == (void*)(intptr_t)i);
+    }
+    assert(DictionaryGetSize(dict) == MAX_DICTIONARY_SIZE / 2);
+    DictionaryClear(dict);
+    assert(DictionaryIsEmpty(dict) && !DictionaryContains(dict, DICTIONARY_INT(7)));
+    assert(dict->capacity == capacity);
+    DictionaryDestroy(&dict);
+    assert(dict == NULL);
+    printf ("passed!\n");
+
+    /* test3 : string keys are copied */
+    printf ("--------test3--------\n");
+    dict = new(Dictionary);
+    assert(DictionarySetKeyType(dict, DICTIONARY_KEY_STRING));
+    char key[32];
+    for (int i = 0; i < 1000; ++i)
+    {
+        sprintf(key, "key%d", i);
+        assert(DictionarySet(dict, key, (void*)(intptr_t)(i + 1)));
+    }
+    strcpy(key, "key500");
+    assert(DictionaryGet(dict, key) == (void*)501);
+    key[3] = '6';
+    assert(DictionaryGet(dict, "key500") == (void*)501);
+    assert(DictionaryGet(dict, "key1000") == NULL);
+    assert(DictionaryErase(dict, "key999") && DictionaryGetSize(dict) == 999);
+    assert(!DictionarySet(dict, NULL, NULL) && !DictionaryContains(dict, NULL));
+    delete(dict);
+    printf ("passed!\n");
+
+    /* test4 : iteration with erase */
+    printf ("--------test4--------\n");
+    dict = DictionaryCreateWithKeys(DICTIONARY_KEY_INTEGER);
+    for (int i = 1; i <= 5000; ++i)
+        DictionarySet(dict, DICTIONARY_INT(i), (void*)(intptr_t)i);
+    unsigned position = 0;
+    unsigned visited = 0;
+    intptr_t sum = 0;
+    void* k;
+    while (DictionaryIterate(dict, &position, &k, &value))
+    {
+        assert(k == value);
+        ++visited;
+        sum += (intptr_t)value;
+        if ((intptr_t)value % 3 == 0)
+            DictionaryEraseIterated(dict, &position);
+    }
+    assert(visited == 5000 && sum == 5000 * 5001 / 2);
+    assert(DictionaryGetSize(dict) == 5000 - 5000 / 3);
+    for (int i = 1; i <= 5000; ++i)
+        assert(DictionaryContains(dict, DICTIONARY_INT(i)) == (i % 3 != 0));
+    delete(dict);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all dictionary's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,122 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __DICT_H
+#define __DICT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define __DICTIONARY_ID 1952672068   /* 'D' 'i' 'c' 't' */
+
+#define DICTIONARY_MIN_CAPACITY 8    /* slots after first set */
+
+/* keys of dictionary */
+enum
+{
+    DICTIONARY_KEY_POINTER = 0,      /* keys are compared as pointers */
+    DICTIONARY_KEY_INTEGER,          /* keys are intptr_t casted to pointer */
+    DICTIONARY_KEY_STRING            /* keys are strings, dictionary keeps own copies */
+};
+
+/* key and value of slot */
+typedef struct
+{
+    void* key;
+    void* value;
+} DictionaryEntry;
+
+/* hash map with open addressing (Robin Hood): entries are kept in one array,
+   entry is at most probeLimit slots after its home slot, so slots don't wrap around */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of DictionaryCreate from AllocMemory, else of malloc */
+
+    unsigned keyType;
+    unsigned size;
+    unsigned capacity;               /* power of two, 0 - no memory */
+    unsigned shift;                  /* home slot is top bits of hash: hash >> shift */
+    unsigned probeLimit;
+
+    uint32_t*        meta;           /* capacity + probeLimit + 1: 0 - empty, else 24 bits of hash << 8 | distance + 1 */
+    DictionaryEntry* entries;
+
+    bool  (*set)     (void* this, const void* key, void* value);
+    void* (*get)     (void* this, const void* key);
+    bool  (*contains)(void* this, const void* key);
+    bool  (*erase)   (void* this, const void* key);
+    bool  (*empty)   (void* this);
+    void  (*clear)   (void* this);
+    bool  (*reserve) (void* this, unsigned count);
+} Dictionary;
+
+/** key of integer for functions of dictionary */
+#define DICTIONARY_INT(x) ((const void*)(intptr_t)(x))
+
+/** init memory as dictionary with pointer keys */
+void DictionaryInit(void* mem);
+/** create dictionary with pointer keys and return pointer to dictionary */
+Dictionary* DictionaryCreate ();
+/** create dictionary with keys of type DICTIONARY_KEY_xxx */
+Dictionary* DictionaryCreateWithKeys (unsigned keyType);
+/** change type of keys of empty dictionary, return false if not */
+bool DictionarySetKeyType (Dictionary* dict, unsigned keyType);
+/** delete all entries, memory is kept */
+void DictionaryClear (Dictionary* dict);
+/** clear and destroy dictionary */
+void DictionaryDestroy (Dictionary** dict);
+
+/** make room for count entries, return false if not */
+bool DictionaryReserve (Dictionary* dict, unsigned count);
+
+/** add entry or replace value of key, return false if not */
+bool DictionarySet (Dictionary* dict, const void* key, void* value);
+/** delete entry of key, return false if there is no key */
+bool DictionaryErase (Dictionary* dict, const void* key);
+
+/* GETTERS */
+/** return value of key or NULL */
+void* DictionaryGet (Dictionary* dict, const void* key);
+/** put value of key to value (if not NULL), return false if there is no key */
+bool DictionaryFind (Dictionary* dict, const void* key, void** value);
+/** check that key is in dictionary */
+bool DictionaryContains (Dictionary* dict, const void* key);
+/** get count of entries in dictionary */
+unsigned DictionaryGetSize (Dictionary* dict);
+/** check empty dictionary */
+bool DictionaryIsEmpty (Dictionary* dict);
+
+/** iterate over entries in no order, position starts with 0:
+        unsigned position = 0;
+        void *key, *value;
+        while (DictionaryIterate(dict, &position, &key, &value))
+            ...
+    return false after last entry */
+bool DictionaryIterate (Dictionary* dict, unsigned* position, void** key, void** value);
+/** delete entry given by last DictionaryIterate, iteration goes on without skipped entries */
+void DictionaryEraseIterated (Dictionary* dict, unsigned* position);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void DictionaryTest();
+#endif // _DEBUG
+
+#endif // __DICT_H
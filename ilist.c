@@ -0,0 +1,398 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ilist.h"
+#include "alloc.h"
+
+
+#define ILIST_CHECK_VALID                           \
+                if (!list) return 0;                \
+                unsigned id = *(unsigned*)list;     \
+                if (id != __ILIST_ID) return 0;
+
+
+static inline ILink* IListGetLink (IList* list, const void* value)
+{
+    return (ILink*)((char*)value + list->offset);
+}
+
+static inline void* IListGetValue (IList* list, ILink* link)
+{
+    return (link) ? (char*)link - list->offset : NULL;
+}
+
+static void IListUnlink (IList* list, ILink* link)
+{
+    /* value is not linked, e.g. deleted twice */
+    if (link->prev == NULL && link->next == NULL && list->first != link)
+        return;
+
+    if (link->prev)
+        link->prev->next = link->next;
+    else
+        list->first = link->next;
+
+    if (link->next)
+        link->next->prev = link->prev;
+    else
+        list->last = link->prev;
+
+    link->prev = NULL;
+    link->next = NULL;
+    --list->size;
+}
+
+static ILink* IListGetLinkByNumber (IList* list, unsigned numOfElement)
+{
+    if (numOfElement >= list->size)
+        return NULL;
+
+    ILink* link = NULL;
+    /* check which way is faster - from the head or from the tail */
+    if ((list->size - numOfElement) >= numOfElement)
+    {
+        link = list->first;
+        for (unsigned i = 0; link && (i < numOfElement); ++i)
+            link = link->next;
+    }
+    else
+    {
+        link = list->last;
+        for (unsigned i = list->size - 1; link && (i > numOfElement); --i)
+            link = link->prev;
+    }
+
+    return link;
+}
+
+
+void IListInit(void* mem, size_t offset)
+{
+    if (mem)
+    {
+        IList* list = mem;
+
+        /* already initialized? */
+        if (list->__id == __ILIST_ID)
+        {
+            IListClear(list);
+        }
+        else
+        {
+            memset(list, 0, sizeof(IList));
+
+            list->__id      = __ILIST_ID;
+
+            list->front     = &IListGetFirstValue;
+            list->back      = &IListGetLastValue;
+            list->push_back = &IListAddElement;
+            list->pop_back  = &IListPopBack;
+            list->at        = &IListGetValueByNumber;
+            list->clear     = &IListClear;
+            list->empty     = &IListIsEmpty;
+        }
+
+        list->offset = offset;
+    }
+}
+
+IList* IListCreate(size_t offset)
+{
+    IList* list = AllocMemory(ALLOC_TYPE_ILIST, sizeof(IList), 1);
+    if (list == NULL)
+        return NULL;
+
+    list->__id = 0;
+    IListInit(list, offset);
+    list->__alloc = true;
+
+    return list;
+}
+
+void IListClear(IList* list)
+{
+    ILIST_CHECK_VALID
+
+    /* values may be linked to other list later */
+    ILink* link = list->first;
+    while (link)
+    {
+        ILink* next = link->next;
+        link->prev = NULL;
+        link->next = NULL;
+        link = next;
+    }
+
+    list->first = NULL;
+    list->last  = NULL;
+    list->size  = 0;
+}
+
+/* unlink values of list, called by delete() */
+static void IListFinalize (void* object)
+{
+    IList* list = object;
+
+    IListClear(list);
+
+    list->__id = 0;
+}
+
+static void __attribute__((constructor)) IListRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_ILIST, IListFinalize);
+}
+
+void IListDestroy (IList** list)
+{
+    if (!list || !(*list))
+        return;
+
+    /* memory of IListInit is released by free() */
+    bool alloc = (*list)->__alloc;
+    IListFinalize(*list);
+
+    if (alloc)
+        AllocFree(*list);
+    else
+        free (*list);
+    *list = NULL;
+}
+
+bool IListAddElement (IList* list, void* value)
+{
+    ILIST_CHECK_VALID
+
+    return IListInsertElement(list, NULL, value);
+}
+
+bool IListInsertElement (IList* list, void* before, void* value)
+{
+    ILIST_CHECK_VALID
+
+    if (value == NULL)
+        return false;
+
+    ILink* link = IListGetLink(list, value);
+    ILink* next = (before) ? IListGetLink(list, before) : NULL;
+
+    link->next = next;
+    link->prev = (next) ? next->prev : list->last;
+
+    if (link->prev)
+        link->prev->next = link;
+    else
+        list->first = link;
+
+    if (next)
+        next->prev = link;
+    else
+        list->last = link;
+
+    ++list->size;
+
+    return true;
+}
+
+void IListDeleteElement (IList* list, void* value)
+{
+    ILIST_CHECK_VALID
+
+    if (value == NULL || list->size == 0)
+        return;
+
+    IListUnlink(list, IListGetLink(list, value));
+}
+
+void IListDeleteElementByNumber (IList* list, unsigned numOfElement)
+{
+    ILIST_CHECK_VALID
+
+    ILink* link = IListGetLinkByNumber(list, numOfElement);
+    if (link)
+        IListUnlink(list, link);
+}
+
+void IListPopBack(IList* list)
+{
+    ILIST_CHECK_VALID
+
+    if (list->last)
+        IListUnlink(list, list->last);
+}
+
+void* IListGetFirstValue(IList* list)
+{
+    ILIST_CHECK_VALID
+
+    return IListGetValue(list, list->first);
+}
+
+void* IListGetLastValue(IList* list)
+{
+    ILIST_CHECK_VALID
+
+    return IListGetValue(list, list->last);
+}
+
+void* IListGetNextValue(IList* list, void* value)
+{
+    ILIST_CHECK_VALID
+
+    if (value == NULL)
+        return NULL;
+
+    return IListGetValue(list, IListGetLink(list, value)->next);
+}
+
+void* IListGetPrevValue(IList* list, void* value)
+{
+    ILIST_CHECK_VALID
+
+    if (value == NULL)
+        return NULL;
+
+    return IListGetValue(list, IListGetLink(list, value)->prev);
+}
+
+void* IListGetValueByNumber (IList* list, unsigned numOfElement)
+{
+    ILIST_CHECK_VALID
+
+    return IListGetValue(list, IListGetLinkByNumber(list, numOfElement));
+}
+
+int IListGetNumberByValue (IList* list, const void* value)
+{
+    if (!list || !value)
+        return -1;
+
+    ILink* target = IListGetLink(list, value);
+    int num = 0;
+    for (ILink* link = list->first; link; link = link->next, ++num)
+    {
+        if (link == target)
+            return num;
+    }
+
+    return -1;
+}
+
+unsigned IListGetSize (IList* list)
+{
+    ILIST_CHECK_VALID
+
+    return list->size;
+}
+
+bool IListIsEmpty(IList* list)
+{
+    ILIST_CHECK_VALID
+
+    return (list->size == 0);
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#define MAX_ILIST_SIZE 6000
+typedef struct
+{
+    int   number;
+    ILink link;
+} IListTestValue;
+
+void IListTest()
+{
+    printf ("IList's tests started!!!\n");
+
+    IListTestValue* array = calloc(MAX_ILIST_SIZE, sizeof(IListTestValue));
+    IList* list = IListCreateFor(IListTestValue, link);
+
+    /* test1 : fill list */
+    printf ("--------test1--------\n");
+    for (unsigned i = 0; i < MAX_ILIST_SIZE; ++i)
+    {
+        array[i].number = i;
+        assert(IListAddElement(list, &array[i]));
+    }
+    assert(IListGetSize(list) == MAX_ILIST_SIZE);
+    assert(IListGetFirstValue(list) == &array[0]);
+    assert(IListGetLastValue(list)  == &array[MAX_ILIST_SIZE - 1]);
+    printf ("size of list : %d\n", IListGetSize(list));
+
+    /* test2 : iterate and get by number */
+    printf ("--------test2--------\n");
+    unsigned count = 0;
+    for (IListTestValue* it = IListGetFirstValue(list); it; it = IListGetNextValue(list, it))
+        assert(it->number == (int)count++);
+    assert(count == MAX_ILIST_SIZE);
+    assert(IListGetValueByNumber(list, 10) == &array[10]);
+    assert(IListGetValueByNumber(list, MAX_ILIST_SIZE - 10) == &array[MAX_ILIST_SIZE - 10]);
+    assert(IListGetNumberByValue(list, &array[33]) == 33);
+    printf ("passed!\n");
+
+    /* test3 : unlink by object */
+    printf ("--------test3--------\n");
+    IListDeleteElement(list, &array[0]);
+    IListDeleteElement(list, &array[100]);
+    IListDeleteElement(list, &array[MAX_ILIST_SIZE - 1]);
+    IListDeleteElement(list, &array[100]);
+    assert(IListGetSize(list) == MAX_ILIST_SIZE - 3);
+    assert(IListGetFirstValue(list) == &array[1]);
+    assert(IListGetLastValue(list)  == &array[MAX_ILIST_SIZE - 2]);
+    assert(IListGetNextValue(list, &array[99]) == &array[101]);
+    assert(IListGetPrevValue(list, &array[101]) == &array[99]);
+    assert(IListGetNumberByValue(list, &array[100]) == -1);
+    printf ("passed!\n");
+
+    /* test4 : insert before value */
+    printf ("--------test4--------\n");
+    assert(IListInsertElement(list, &array[101], &array[100]));
+    assert(IListInsertElement(list, &array[1], &array[0]));
+    assert(IListGetValueByNumber(list, 100) == &array[100]);
+    assert(IListGetFirstValue(list) == &array[0]);
+    IListPopBack(list);
+    IListDeleteElementByNumber(list, 0);
+    assert(IListGetSize(list) == MAX_ILIST_SIZE - 3);
+    printf ("passed!\n");
+
+    /* test5 : clear and destroy */
+    printf ("--------test5--------\n");
+    IListClear(list);
+    assert(IListIsEmpty(list));
+    assert(array[50].link.next == NULL);
+    IListDestroy(&list);
+    assert(list == NULL);
+    printf ("passed!\n");
+
+    free(array);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all intrusive list's tests are passed!\n");
+}
+#endif // _DEBUG
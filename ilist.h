@@ -0,0 +1,104 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __ILIST_H
+#define __ILIST_H
+
+#include <stddef.h>
+
+#define __ILIST_ID 1953720649   /* 'I' 'L' 'i' 's' */
+
+/* links placed inside user struct */
+typedef struct ILink_tag
+{
+    struct ILink_tag* prev;
+    struct ILink_tag* next;
+} ILink;
+
+/* intrusive doubly-linked list - values are user structs with ILink inside, list allocates nothing */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of IListCreate from AllocMemory, else of malloc */
+
+    unsigned size;
+
+    ILink* first;              /* head */
+    ILink* last;               /* tail */
+
+    size_t offset;             /* offset of ILink in user struct */
+
+    void* (*front)(void* this);
+    void* (*back) (void* this);
+    bool  (*push_back)(void* this, void* value);
+    void  (*pop_back) (void* this);
+    bool  (*empty)(void* this);
+    void  (*clear)(void* this);
+    void* (*at)(void* this, unsigned position);
+} IList;
+
+/** create intrusive list of structs Type with ILink field Member */
+#define IListCreateFor(Type, Member) IListCreate(offsetof(Type, Member))
+
+/** init memory as intrusive list, offset - offset of ILink in values */
+void IListInit(void* mem, size_t offset);
+/** create intrusive list and return pointer to list */
+IList* IListCreate (size_t offset);
+/** unlink all values from list */
+void IListClear (IList* list);
+/** clear and destroy list */
+void IListDestroy (IList** list);
+
+/** link value to end of list, return false if not */
+bool IListAddElement (IList* list, void* value);
+/** link value before other value in list (NULL - to the end), return false if not */
+bool IListInsertElement (IList* list, void* before, void* value);
+/** unlink value from list in O(1), value must be in this list or not linked at all (then nothing happens) */
+void IListDeleteElement (IList* list, void* value);
+/** unlink value from list by position in list */
+void IListDeleteElementByNumber (IList* list, unsigned numOfElement);
+/** unlink last value from list */
+void IListPopBack(IList* list);
+
+/* GETTERS */
+/** get first value from list */
+void* IListGetFirstValue(IList* list);
+/** get last value from list */
+void* IListGetLastValue(IList* list);
+/** get value after value in list */
+void* IListGetNextValue(IList* list, void* value);
+/** get value before value in list */
+void* IListGetPrevValue(IList* list, void* value);
+/** return value by number in list */
+void* IListGetValueByNumber (IList* list, unsigned numOfElement);
+/** return number of value in list (if exists), else return -1 */
+int IListGetNumberByValue (IList* list, const void* value);
+
+/** get count of values in list */
+unsigned IListGetSize (IList* list);
+/** check empty list */
+bool IListIsEmpty(IList* list);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void IListTest();
+#endif // _DEBUG
+
+#endif // __ILIST_H
@@ -0,0 +1,459 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#include "intern.h"
+#include "alloc.h"
+#include "arena.h"
+#include "allocstats.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #define InternYield() SwitchToThread()
+#else
+    #include <sched.h>
+    #define InternYield() sched_yield()
+#endif // _WIN32
+
+
+#define INTERN_ARENA_BLOCK_SIZE 4096    /* first block of strings of every part */
+#define INTERN_SPIN_COUNT       64      /* tries of lock before yield of thread */
+
+#define INTERN_CHECK_VALID                          \
+                if (!table) return 0;               \
+                unsigned id = *(unsigned*)table;    \
+                if (id != __INTERN_ID) return 0;
+
+/* hash and string, NULL - empty slot */
+typedef struct
+{
+    uint64_t hash;
+    String*  str;
+} InternSlot;
+
+/* open addressing hash table with linear probing, strings are in arena of part */
+struct InternShard_tag
+{
+    InternSlot* slots;
+    unsigned    capacity;       /* always power of two */
+    unsigned    count;
+
+    Arena* arena;
+    bool   lock;
+};
+
+/* shared table for NULL */
+static InternTable* internShared = NULL;
+
+
+static inline void InternLock (InternTable* table, InternShard* shard)
+{
+    if (!table->threadSafe)
+        return;
+
+    unsigned spins = 0;
+    while (__atomic_test_and_set(&shard->lock, __ATOMIC_ACQUIRE))
+    {
+        /* owner of lock may be preempted, let it go on */
+        while (__atomic_load_n(&shard->lock, __ATOMIC_RELAXED))
+        {
+            if (++spins % INTERN_SPIN_COUNT == 0)
+                InternYield();
+        }
+    }
+}
+
+static inline void InternUnlock (InternTable* table, InternShard* shard)
+{
+    if (table->threadSafe)
+        __atomic_clear(&shard->lock, __ATOMIC_RELEASE);
+}
+
+static inline InternShard* InternGetShard (InternTable* table, uint64_t hash)
+{
+    /* high bits choose part, low bits choose slot */
+    return &table->shards[(table->shardCount > 1) ? (unsigned)(hash >> 60) % table->shardCount : 0];
+}
+
+static String* InternShardFind (InternShard* shard, uint64_t hash, const char* chars, unsigned length)
+{
+    unsigned mask = shard->capacity - 1;
+    unsigned i = (unsigned)hash & mask;
+    while (shard->slots[i].str)
+    {
+        String* str = shard->slots[i].str;
+        if (shard->slots[i].hash == hash &&
+            str->buffer.length == length &&
+            memcmp(StringGetChars(str), chars, length) == 0)
+            return str;
+
+        i = (i + 1) & mask;
+    }
+
+    return NULL;
+}
+
+static void InternShardPut (InternShard* shard, uint64_t hash, String* str)
+{
+    unsigned mask = shard->capacity - 1;
+    unsigned i = (unsigned)hash & mask;
+    while (shard->slots[i].str)
+        i = (i + 1) & mask;
+
+    shard->slots[i].hash = hash;
+    shard->slots[i].str  = str;
+    ++shard->count;
+}
+
+static bool InternShardResize (InternShard* shard, unsigned capacity)
+{
+    InternSlot* slots = calloc(capacity, sizeof(InternSlot));
+    if (slots == NULL)
+        return false;
+
+    InternSlot* oldSlots = shard->slots;
+    unsigned oldCapacity = shard->capacity;
+
+    shard->slots    = slots;
+    shard->capacity = capacity;
+    shard->count    = 0;
+
+    for (unsigned i = 0; i < oldCapacity; ++i)
+    {
+        if (oldSlots[i].str)
+            InternShardPut(shard, oldSlots[i].hash, oldSlots[i].str);
+    }
+    free (oldSlots);
+
+    return true;
+}
+
+static String* InternShardAdd (InternShard* shard, uint64_t hash, const char* chars, unsigned length)
+{
+    /* keep load factor under 1/2 */
+    if ((shard->count + 1) * 2 > shard->capacity)
+    {
+        if (shard->capacity > UINT_MAX / 2 || !InternShardResize(shard, shard->capacity * 2))
+            return NULL;
+    }
+
+    /* memory of arena has header of new(), so delete() of string only sets pointer to NULL */
+    if (!ArenaPush(shard->arena))
+        return NULL;
+    /* strings are counted apart from memory of user without new() */
+    ALLOC_STATS_SITE(String);
+    void* mem = AllocMemory(ALLOC_TYPE_NONE, sizeof(String) + (size_t)length + 1, 1);
+    ALLOC_STATS_SITE_END();
+    ArenaPop();
+    if (mem == NULL)
+        return NULL;
+
+    String* str = StringInitConst(mem, chars, length);
+    InternShardPut(shard, hash, str);
+
+    return str;
+}
+
+static InternTable* InternGetShared ()
+{
+    InternTable* table = __atomic_load_n(&internShared, __ATOMIC_ACQUIRE);
+    if (table)
+        return table;
+
+    table = InternTableCreate(true);
+    if (table == NULL)
+        return NULL;
+
+    /* another thread was first */
+    InternTable* expected = NULL;
+    if (!__atomic_compare_exchange_n(&internShared, &expected, table, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        InternTableDestroy(&table);
+        return expected;
+    }
+
+    return table;
+}
+
+
+InternTable* InternTableCreate (bool threadSafe)
+{
+    InternTable* table = calloc(1, sizeof(InternTable));
+    if (table == NULL)
+        return NULL;
+
+    table->__id       = __INTERN_ID;
+    table->threadSafe = threadSafe;
+    table->shardCount = (threadSafe) ? INTERN_SHARDS : 1;
+
+    table->shards = calloc(table->shardCount, sizeof(InternShard));
+    if (table->shards == NULL)
+    {
+        free (table);
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < table->shardCount; ++i)
+    {
+        InternShard* shard = &table->shards[i];
+        shard->capacity = INTERN_MIN_CAPACITY;
+        shard->slots    = calloc(shard->capacity, sizeof(InternSlot));
+        shard->arena    = ArenaCreate(INTERN_ARENA_BLOCK_SIZE);
+        if (shard->slots == NULL || shard->arena == NULL)
+        {
+            InternTableDestroy(&table);
+            return NULL;
+        }
+    }
+
+    return table;
+}
+
+void InternTableDestroy (InternTable** table)
+{
+    if (!table || !(*table))
+        return;
+
+    InternTable* t = *table;
+    for (unsigned i = 0; i < t->shardCount; ++i)
+    {
+        free (t->shards[i].slots);
+        ArenaDestroy(&t->shards[i].arena);
+    }
+    free (t->shards);
+
+    t->__id = 0;
+    free (t);
+    *table = NULL;
+}
+
+String* InternChars (InternTable* table, const char* chars, unsigned length)
+{
+    if (table == NULL)
+        table = InternGetShared();
+
+    INTERN_CHECK_VALID
+
+    if (chars == NULL)
+        return NULL;
+
+    uint64_t hash = StringHashChars(chars, length);
+    InternShard* shard = InternGetShard(table, hash);
+
+    InternLock(table, shard);
+    String* str = InternShardFind(shard, hash, chars, length);
+    if (str == NULL)
+        str = InternShardAdd(shard, hash, chars, length);
+    InternUnlock(table, shard);
+
+    return str;
+}
+
+String* InternString (InternTable* table, const char* chars)
+{
+    if (chars == NULL)
+        return NULL;
+
+    size_t length = strlen(chars);
+    if (length > UINT_MAX)
+        return NULL;
+
+    return InternChars(table, chars, length);
+}
+
+String* InternFind (InternTable* table, const char* chars, unsigned length)
+{
+    if (table == NULL)
+        table = InternGetShared();
+
+    INTERN_CHECK_VALID
+
+    if (chars == NULL)
+        return NULL;
+
+    uint64_t hash = StringHashChars(chars, length);
+    InternShard* shard = InternGetShard(table, hash);
+
+    InternLock(table, shard);
+    String* str = InternShardFind(shard, hash, chars, length);
+    InternUnlock(table, shard);
+
+    return str;
+}
+
+unsigned InternTableGetCount (InternTable* table)
+{
+    if (table == NULL)
+        table = InternGetShared();
+
+    INTERN_CHECK_VALID
+
+    unsigned count = 0;
+    for (unsigned i = 0; i < table->shardCount; ++i)
+    {
+        InternShard* shard = &table->shards[i];
+        InternLock(table, shard);
+        count += shard->count;
+        InternUnlock(table, shard);
+    }
+
+    return count;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#include "list.h"
+#include "thrdpool.h"
+
+#define MAX_INTERN_NAMES 10000
+
+#ifdef __MULTITHREADS
+typedef struct
+{
+    InternTable* table;
+    String**     results;       /* canonical string of every name for every part */
+} InternTestJob;
+
+static void InternTestTask (void* arg, unsigned part)
+{
+    InternTestJob* job = arg;
+    char name[32];
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        /* parts go in different order */
+        unsigned n = (part & 1) ? 999 - i : i;
+        sprintf(name, "name_%u", n);
+        job->results[part * 1000 + n] = InternString(job->table, name);
+    }
+}
+#endif // __MULTITHREADS
+
+void InternTest()
+{
+    printf ("Intern's tests started!!!\n");
+
+    /* test1 : equal text gives one pointer */
+    printf ("--------test1--------\n");
+    InternTable* table = InternTableCreate(false);
+    char text[64];
+    strcpy(text, "identifier");
+    String* a = InternString(table, "identifier");
+    String* b = InternString(table, text);
+    String* c = InternChars(table, "identifier_long_enough_to_be_outside", 10);
+    assert(a && a == b && a == c);
+    assert(StringCompare(a, "identifier") == 0);
+    assert(StringGetLength(a) == 10);
+    assert(InternString(table, "identifieR") != a);
+    assert(InternTableGetCount(table) == 2);
+    assert(InternFind(table, "identifier", 10) == a);
+    assert(InternFind(table, "unknown", 7) == NULL);
+    assert(InternString(table, "") == InternChars(table, "", 0));
+    printf ("passed!\n");
+
+    /* test2 : strings are immutable, delete only forgets pointer */
+    printf ("--------test2--------\n");
+    String* longName = InternString(table, "a long name which does not fit inside of string");
+    assert(StringIsConst(longName));
+    assert(!StringAppend(longName, "x"));
+    assert(!StringAssign(longName, "x"));
+    StringClear(longName);
+    assert(StringGetLength(longName) == strlen("a long name which does not fit inside of string"));
+    String* copy = longName;
+    AllocDelete((void**)&copy);
+    assert(copy == NULL);
+    StringDestroy(&b);
+    assert(b == NULL);
+    assert(InternString(table, "a long name which does not fit inside of string") == longName);
+    assert(StringCompare(longName, "a long name which does not fit inside of string") == 0);
+    printf ("passed!\n");
+
+    /* test3 : many names, search in list by pointer */
+    printf ("--------test3--------\n");
+    String** names = malloc(MAX_INTERN_NAMES * sizeof(String*));
+    List* list = ListCreate();
+    for (unsigned i = 0; i < MAX_INTERN_NAMES; ++i)
+    {
+        sprintf(text, "name_%u", i);
+        names[i] = InternString(table, text);
+        ListAddElement(list, names[i]);
+    }
+    assert(InternTableGetCount(table) == MAX_INTERN_NAMES + 4);
+    for (unsigned i = 0; i < MAX_INTERN_NAMES; i += 97)
+    {
+        sprintf(text, "name_%u", i);
+        String* name = InternString(table, text);
+        assert(name == names[i]);
+        assert(ListGetNumberByValue(list, name) == (int)i);
+    }
+    ListDestroy(&list);
+    InternTableDestroy(&table);
+    assert(table == NULL);
+    printf ("passed!\n");
+
+    /* test4 : shared thread-safe table */
+    printf ("--------test4--------\n");
+    String* shared = InternString(NULL, "shared");
+    assert(shared == InternString(NULL, "shared"));
+    table = InternTableCreate(true);
+    for (unsigned i = 0; i < MAX_INTERN_NAMES; ++i)
+    {
+        sprintf(text, "name_%u", i);
+        names[i] = InternString(table, text);
+    }
+    assert(InternTableGetCount(table) == MAX_INTERN_NAMES);
+    for (unsigned i = 0; i < MAX_INTERN_NAMES; ++i)
+    {
+        sprintf(text, "name_%u", i);
+        assert(InternFind(table, text, strlen(text)) == names[i]);
+    }
+    InternTableDestroy(&table);
+
+#ifdef __MULTITHREADS
+    table = InternTableCreate(true);
+    ThreadPool* pool = ThreadPoolGet();
+    unsigned parts = ThreadPoolGetSize(pool) * 2;
+    InternTestJob job = {table, malloc(parts * 1000 * sizeof(String*))};
+    ThreadPoolRun(pool, InternTestTask, &job, parts);
+    assert(InternTableGetCount(table) == 1000);
+    for (unsigned part = 1; part < parts; ++part)
+    {
+        for (unsigned i = 0; i < 1000; ++i)
+            assert(job.results[part * 1000 + i] == job.results[i]);
+    }
+    free(job.results);
+    InternTableDestroy(&table);
+#endif // __MULTITHREADS
+    free(names);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all intern's tests are passed!\n");
+}
+#endif // _DEBUG
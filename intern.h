@@ -0,0 +1,68 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#ifndef __INTERN_H
+#define __INTERN_H
+
+#include <stdbool.h>
+
+#include "str.h"
+
+#define __INTERN_ID 1853124169      /* 'I' 'n' 't' 'n' */
+
+#define INTERN_SHARDS       16      /* parts of thread-safe table, each with own lock */
+#define INTERN_MIN_CAPACITY 64      /* slots in new part of table */
+
+typedef struct InternShard_tag InternShard;
+
+/* table of unique immutable strings, equal text gives the same pointer */
+typedef struct
+{
+    unsigned __id;
+
+    bool         threadSafe;
+    unsigned     shardCount;
+    InternShard* shards;
+} InternTable;
+
+/** create table, thread-safe table is split into INTERN_SHARDS parts with own locks */
+InternTable* InternTableCreate (bool threadSafe);
+/** free table with all its strings */
+void InternTableDestroy (InternTable** table);
+
+/** canonical string with text of chars, NULL table - shared thread-safe table.
+    String lives until table is destroyed, delete() of it only sets pointer to NULL */
+String* InternString (InternTable* table, const char* chars);
+/** canonical string with length chars */
+String* InternChars (InternTable* table, const char* chars, unsigned length);
+/** canonical string if text is already in table, else NULL */
+String* InternFind (InternTable* table, const char* chars, unsigned length);
+
+/** count of unique strings in table */
+unsigned InternTableGetCount (InternTable* table);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void InternTest();
+#endif // _DEBUG
+
+#endif // __INTERN_H
@@ -23,108 +23,1292 @@
 #include <stdbool.h>
 
 #include "list.h"
+#include "alloc.h"
+#include "ptrscan.h"
               
-/* FIX ME */       
 /* use multithreading? */
 #ifdef __MULTITHREADS
-    #define MAX_VALUES_FOR_ONE_THRD 50        /* max length of list|dictionary for do search in one thread */
-    #ifdef __USE_SDL_THREADS
-        #include "SDL2/SDL.h"
-    #else  // NOT __USE_SDL_THREADS
-        #include "tinycthread.h"
-    #endif // __USE_SDL_THREADS
+    #define MAX_VALUES_FOR_ONE_THRD 50        /* max length of list for do search in one thread */
+    #define LIST_CALIBRATION_SIZE   16384     /* elements in list for measure speed of search */
+    #define LIST_SORT_PARALLEL_SIZE 32768     /* min length of list for sort in threads */
+    #include "thrdpool.h"
+#endif // __MULTITHREADS
+
+
+#define LIST_CHECK_VALID                            \
+                if (!list) return 0;                \
+                unsigned id = *(unsigned*)list;    \
+                if (id != __LIST_ID) return 0;
+
+
+/* free all slabs of pool at once */
+static void ListPoolRelease (ListPool* pool)
+{
+    ListPoolSlab* slab = pool->slabs;
+    while (slab && pool->arena == NULL)
+    {
+        ListPoolSlab* next = slab->next;
+        free (slab);
+        slab = next;
+    }
+
+    pool->slabs = NULL;
+    pool->free  = NULL;
+    pool->used  = 0;
+}
+
+/* add slab of count elements to pool */
+static bool ListPoolAddSlab (ListPool* pool, unsigned count)
+{
+    size_t size = sizeof(ListPoolSlab) + count * sizeof(ListElement);
+    ListPoolSlab* slab = (pool->arena) ? ArenaAlloc(pool->arena, size) : malloc(size);
+    if (slab == NULL)
+        return false;
+
+    slab->count = count;
+    slab->next  = pool->slabs;
+    pool->slabs = slab;
+    pool->used  = 0;
+
+    return true;
+}
+
+/* take element from pool, add new slab if pool is exhausted */
+static ListElement* ListPoolAlloc (ListPool* pool)
+{
+    ListElement* element = pool->free;
+    if (element)
+    {
+        pool->free = element->next;
+        return element;
+    }
+
+    ListPoolSlab* slab = pool->slabs;
+    if (slab == NULL || pool->used >= slab->count)
+    {
+        if (!ListPoolAddSlab(pool, pool->slabSize))
+            return NULL;
+        slab = pool->slabs;
+
+        /* next slab will be bigger */
+        if (pool->slabSize < LIST_POOL_MAX_SLAB_SIZE)
+            pool->slabSize *= 2;
+    }
+
+    return &slab->elements[pool->used++];
+}
+
+/* make sure next count elements are taken from pool without allocation, return false if not */
+static bool ListPoolReserve (ListPool* pool, unsigned count)
+{
+    unsigned available = 0;
+    for (ListElement* element = pool->free; element && available < count; element = element->next)
+        ++available;
+
+    ListPoolSlab* slab = pool->slabs;
+    if (slab)
+        available += slab->count - pool->used;
+
+    if (available >= count)
+        return true;
+
+    /* the rest of newest slab goes to free elements, all others are in one new slab */
+    while (slab && pool->used < slab->count)
+    {
+        ListElement* element = &slab->elements[pool->used++];
+        element->next = pool->free;
+        pool->free    = element;
+    }
+
+    unsigned size = count - available;
+    if (size < pool->slabSize)
+        size = pool->slabSize;
+
+    return ListPoolAddSlab(pool, size);
+}
+
+#define LIST_INDEX_MIN_CAPACITY 64      /* slots in new hash index */
+
+/* value and its first element in list */
+typedef struct
+{
+    const void*  value;
+    ListElement* element;       /* first element with value, NULL - find it by scan */
+    unsigned     count;         /* elements with value, 0 - empty slot */
+} ListIndexSlot;
+
+/* open addressing hash table with linear probing */
+typedef struct ListIndex_tag
+{
+    ListIndexSlot* slots;
+    unsigned       capacity;    /* always power of two */
+    unsigned       count;       /* count of different values */
+} ListIndex;
+
+static inline unsigned ListIndexHash (const void* value, unsigned capacity)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)value * 0x9E3779B97F4A7C15ull;
+    return (unsigned)(hash >> 32) & (capacity - 1);
+}
+
+/* slot of value or empty slot for it */
+static ListIndexSlot* ListIndexGetSlot (ListIndex* index, const void* value)
+{
+    unsigned mask = index->capacity - 1;
+    unsigned i = ListIndexHash(value, index->capacity);
+    while (index->slots[i].count && index->slots[i].value != value)
+        i = (i + 1) & mask;
+
+    return &index->slots[i];
+}
+
+/* add element which goes after all elements with the same value */
+static void ListIndexPut (ListIndex* index, ListElement* element)
+{
+    ListIndexSlot* slot = ListIndexGetSlot(index, element->value);
+    if (slot->count == 0)
+    {
+        slot->value   = element->value;
+        slot->element = element;
+        ++index->count;
+    }
+    ++slot->count;
+}
+
+static bool ListIndexResize (ListIndex* index, unsigned capacity)
+{
+    ListIndexSlot* slots = calloc(capacity, sizeof(ListIndexSlot));
+    if (slots == NULL)
+        return false;
+
+    ListIndexSlot* oldSlots = index->slots;
+    unsigned oldCapacity = index->capacity;
+
+    index->slots    = slots;
+    index->capacity = capacity;
+
+    for (unsigned i = 0; i < oldCapacity; ++i)
+    {
+        if (oldSlots[i].count)
+            *ListIndexGetSlot(index, oldSlots[i].value) = oldSlots[i];
+    }
+    free (oldSlots);
+
+    return true;
+}
+
+/* add element linked in list, append - element is after all others with its value */
+static bool ListIndexInsert (ListIndex* index, ListElement* element, bool append)
+{
+    ListIndexSlot* slot = ListIndexGetSlot(index, element->value);
+    if (slot->count)
+    {
+        ++slot->count;
+
+        /* first element of list is first with value, in middle it may be first or not */
+        if (element->prev == NULL)
+            slot->element = element;
+        else if (!append && element->next != NULL)
+            slot->element = NULL;
+        return true;
+    }
+
+    /* keep load factor under 1/2 */
+    if ((index->count + 1) * 2 > index->capacity)
+    {
+        if (!ListIndexResize(index, index->capacity * 2))
+            return false;
+    }
+
+    ListIndexPut(index, element);
+    return true;
+}
+
+/* remove element which is still linked in list */
+static void ListIndexRemove (ListIndex* index, ListElement* element)
+{
+    ListIndexSlot* slot = ListIndexGetSlot(index, element->value);
+    if (slot->count == 0)
+        return;
+
+    if (--slot->count)
+    {
+        /* other elements with value go after first one */
+        if (slot->element == element)
+        {
+            ListElement* next = element->next;
+            while (next && next->value != element->value)
+                next = next->next;
+            slot->element = next;
+        }
+        return;
+    }
+
+    /* shift following slots back, so no tombstones are needed */
+    unsigned mask = index->capacity - 1;
+    unsigned i = (unsigned)(slot - index->slots);
+    unsigned j = i;
+    for (;;)
+    {
+        j = (j + 1) & mask;
+        if (index->slots[j].count == 0)
+            break;
+
+        unsigned home = ListIndexHash(index->slots[j].value, index->capacity);
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            index->slots[i] = index->slots[j];
+            i = j;
+        }
+    }
+
+    index->slots[i].count = 0;
+    --index->count;
+}
+
+/* first element with value */
+static ListElement* ListIndexFind (List* list, const void* value)
+{
+    ListIndexSlot* slot = ListIndexGetSlot(list->index, value);
+    if (slot->count == 0)
+        return NULL;
+
+    /* element with the same value was inserted in middle of list */
+    if (slot->element == NULL)
+    {
+        ListElement* element = list->first;
+        while (element && element->value != value)
+            element = element->next;
+        slot->element = element;
+    }
+
+    return slot->element;
+}
+
+/* order of elements is changed, first elements of repeated values must be found again */
+static void ListIndexReorder (List* list)
+{
+    ListIndex* index = list->index;
+    if (index == NULL || index->count == list->size)
+        return;
+
+    for (unsigned i = 0; i < index->capacity; ++i)
+    {
+        if (index->slots[i].count > 1)
+            index->slots[i].element = NULL;
+    }
+}
+
+/* add element to index of list, without memory list falls back to search by scan */
+static void ListIndexAdd (List* list, ListElement* element, bool append)
+{
+    if (list->index && !ListIndexInsert(list->index, element, append))
+        ListEnableIndex(list, false);
+}
+
+/* values of list in order, for search by vector compare */
+typedef struct ListSnapshot_tag
+{
+    void**        values;
+    ListElement** elements;     /* element of every value */
+    unsigned      count;
+    unsigned      capacity;
+    bool          valid;        /* false - list is changed, build it again */
+} ListSnapshot;
+
+static inline void ListSnapshotInvalidate (List* list)
+{
+    if (list->snapshot)
+        list->snapshot->valid = false;
+}
+
+static bool ListSnapshotReserve (ListSnapshot* snapshot, unsigned capacity)
+{
+    if (capacity <= snapshot->capacity)
+        return true;
+
+    void** values = realloc(snapshot->values, capacity * sizeof(void*));
+    if (values == NULL)
+        return false;
+    snapshot->values = values;
+
+    ListElement** elements = realloc(snapshot->elements, capacity * sizeof(ListElement*));
+    if (elements == NULL)
+        return false;
+    snapshot->elements = elements;
+
+    snapshot->capacity = capacity;
+    return true;
+}
+
+/* appended element keeps snapshot valid while there is room for it */
+static void ListSnapshotAppend (List* list, ListElement* element)
+{
+    ListSnapshot* snapshot = list->snapshot;
+    if (snapshot == NULL || !snapshot->valid)
+        return;
+
+    if (snapshot->count < snapshot->capacity)
+    {
+        snapshot->values[snapshot->count]   = element->value;
+        snapshot->elements[snapshot->count] = element;
+        ++snapshot->count;
+    }
+    else
+        snapshot->valid = false;
+}
+
+/* return valid snapshot of list, NULL if there is no memory for it */
+static ListSnapshot* ListSnapshotGet (List* list)
+{
+    ListSnapshot* snapshot = list->snapshot;
+    if (snapshot->valid)
+        return snapshot;
+
+    /* room for appends */
+    unsigned capacity = list->size + list->size / 4 + 16;
+    if (!ListSnapshotReserve(snapshot, capacity))
+        return NULL;
+
+    unsigned i = 0;
+    for (ListElement* element = list->first; element; element = element->next, ++i)
+    {
+        snapshot->values[i]   = element->value;
+        snapshot->elements[i] = element;
+    }
+    snapshot->count = i;
+    snapshot->valid = true;
+
+    return snapshot;
+}
+
+/* change value of element and keep index in sync */
+static void ListSetElementValue (List* list, ListElement* element, void* value)
+{
+    if (list->index)
+        ListIndexRemove(list->index, element);
+
+    element->value = value;
+    ListSnapshotInvalidate(list);
+
+    ListIndexAdd(list, element, false);
+}
+
+/* list owns pool alone or with other lists */
+static void ListOwnPool (List* list, ListPool* pool)
+{
+    list->pool    = pool;
+    list->ownPool = (pool != NULL);
+    if (pool)
+        ++pool->lists;
+}
+
+/* give up own pool, the last owner destroys it */
+static void ListReleasePool (List* list)
+{
+    if (list->ownPool && --list->pool->lists == 0)
+        ListPoolDestroy(&list->pool);
+
+    list->pool    = NULL;
+    list->ownPool = false;
+}
+
+static ListElement* ListAllocElement (List* list)
+{
+    ListElement* element = NULL;
+    if (list->pool)
+    {
+        element = ListPoolAlloc(list->pool);
+        if (element)
+            memset(element, 0, sizeof(ListElement));
+    }
+    else
+        element = calloc(sizeof(char), sizeof(ListElement));
+
+    return element;
+}
+
+static void ListFreeElement (List* list, ListElement* element)
+{
+    if (list->pool)
+    {
+        element->next    = list->pool->free;
+        list->pool->free = element;
+    }
+    else
+        free (element);
+}
+
+
+/* free chain of elements linked by next */
+static void ListFreeChain (List* list, ListElement* first)
+{
+    while (first)
+    {
+        ListElement* next = first->next;
+        ListFreeElement(list, first);
+        first = next;
+    }
+}
+
+/* allocate chain of count zeroed elements, all of them or nothing */
+static ListElement* ListAllocChain (List* list, unsigned count, ListElement** last)
+{
+    if (list->pool && !ListPoolReserve(list->pool, count))
+        return NULL;
+
+    ListElement* first = NULL;
+    *last = NULL;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        ListElement* element = ListAllocElement(list);
+        if (element == NULL)
+        {
+            /* only elements from malloc may be missing, give them back */
+            ListFreeChain(list, first);
+            return NULL;
+        }
+
+        element->prev = *last;
+        if (*last)
+            (*last)->next = element;
+        else
+            first = element;
+        *last = element;
+    }
+
+    return first;
+}
+
+/* link chain of count elements before element of list (NULL - to the end) */
+static void ListLinkChain (List* list, ListElement* before, ListElement* first, ListElement* last, unsigned count)
+{
+    ListElement* prev = (before) ? before->prev : list->last;
+
+    first->prev = prev;
+    last->next  = before;
+
+    if (prev)
+        prev->next = first;
+    else
+        list->first = first;
+
+    if (before)
+        before->prev = last;
+    else
+        list->last = last;
+
+    list->size += count;
+    ListSnapshotInvalidate(list);
+
+    /* numbers of elements after chain are changed */
+    if (before)
+    {
+        list->finger = NULL;
+#ifdef __MULTITHREADS
+        list->segmentCount = 0;
+#endif // __MULTITHREADS
+    }
+}
+
+/* unlink chain of count elements from list, elements are not freed */
+static void ListUnlinkChain (List* list, ListElement* first, ListElement* last, unsigned count)
+{
+    if (first->prev)
+        first->prev->next = last->next;
+    else
+        list->first = last->next;
+
+    if (last->next)
+        last->next->prev = first->prev;
+    else
+        list->last = first->prev;
+
+    first->prev = NULL;
+    last->next  = NULL;
+
+    list->size  -= count;
+    list->finger = NULL;
+    ListSnapshotInvalidate(list);
+#ifdef __MULTITHREADS
+    list->segmentCount = 0;
+#endif // __MULTITHREADS
+}
+
+
+void ListInit(void* mem)
+{
+    if (mem)
+    {
+        List* list = mem;
+        
+        /* already initialized? */
+        if (list->__id == __LIST_ID)
+        {
+            ListClear(list);
+        }
+        else
+        {
+            memset(list, 0, sizeof(List));
+            
+            list->__id      = __LIST_ID;
+
+            list->front     = &ListGetFirstValue;
+            list->back      = &ListGetLastValue;
+            list->push_back = &ListAddElement;
+            list->pop_back  = &ListPopBack;
+            list->at        = &ListGetValueByNumber;
+            list->clear        = &ListClear;
+            list->empty        = &ListIsEmpty;            
+        }
+    }
+}
+
+/* allocate memory for list in current arena, pool or heap */
+static List* ListAllocate()
+{
+    List* list = AllocMemory(ALLOC_TYPE_LIST, sizeof(List), 1);
+    if (list == NULL)
+        return NULL;
+
+    ListInit(list);
+    list->arena = ArenaCurrent();
+    list->__alloc = true;
+
+    return list;
+}
+
+List* ListCreate()
+{
+    List* list = ListAllocate();
+    if (list == NULL)
+        return NULL;
+
+    /* elements of list in arena are taken from arena too */
+    if (list->arena)
+        ListOwnPool(list, ListPoolCreate(0));
+
+    return list;
+}
+
+List* ListCreateWithPool (ListPool* pool)
+{
+    bool ownPool = false;
+    if (pool == NULL)
+    {
+        pool = ListPoolCreate(0);
+        if (pool == NULL)
+            return NULL;
+        ownPool = true;
+    }
+
+    List* list = ListAllocate();
+    if (list == NULL)
+    {
+        if (ownPool)
+            ListPoolDestroy(&pool);
+        return NULL;
+    }
+
+    if (ownPool)
+        ListOwnPool(list, pool);
+    else
+        list->pool = pool;
+
+    return list;
+}
+
+void ListClear(List* list)
+{
+    LIST_CHECK_VALID
+
+    if (list->index)
+    {
+        memset(list->index->slots, 0, list->index->capacity * sizeof(ListIndexSlot));
+        list->index->count = 0;
+    }
+    
+    if (list->pool == NULL)
+    {
+        while (list->size)
+        {
+            ListPopBack(list);
+        }
+        return;
+    }
+
+    if (list->ownPool && list->pool->lists == 1)
+    {
+        /* nobody else uses these slabs - drop them all at once */
+        ListPoolRelease(list->pool);
+    }
+    else if (list->first)
+    {
+        /* return the whole chain of elements to shared pool */
+        list->last->next  = list->pool->free;
+        list->pool->free  = list->first;
+    }
+
+    list->first  = NULL;
+    list->last   = NULL;
+    list->finger = NULL;
+    list->size   = 0;
+    ListSnapshotInvalidate(list);
+#ifdef __MULTITHREADS
+    list->segmentCount = 0;
+#endif // __MULTITHREADS
+}
+
+/* release everything of list except memory of list itself, called by delete() */
+static void ListFinalize (void* object)
+{
+    List* list = object;
+
+    ListClear(list);
+    ListReleasePool(list);
+
+    ListEnableIndex(list, false);
+    ListEnableSnapshot(list, false);
+#ifdef __MULTITHREADS
+    free (list->segments);
+#endif // __MULTITHREADS
+
+    list->__id = 0;
+}
+
+static void __attribute__((constructor)) ListRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_LIST, ListFinalize);
+}
+
+void ListDestroy (List** list)
+{    
+    if (!list || !(*list))
+        return;
+
+    /* memory of ListInit is released by free() */
+    bool alloc = (*list)->__alloc;
+    ListFinalize(*list);
+
+    if (alloc)
+        AllocFree(*list);
+    else
+        free (*list);
+    *list = NULL;
+}
+
+ListPool* ListPoolCreate (unsigned slabSize)
+{
+    Arena* arena = ArenaCurrent();
+    ListPool* pool = (arena) ? ArenaAlloc(arena, sizeof(ListPool)) : calloc(1, sizeof(ListPool));
+    if (pool == NULL)
+        return NULL;
+
+    pool->arena = arena;
+
+    if (slabSize == 0)
+        slabSize = LIST_POOL_SLAB_SIZE;
+    pool->slabSize = slabSize;
+
+    return pool;
+}
+
+void ListPoolDestroy (ListPool** pool)
+{
+    if (!pool || !(*pool))
+        return;
+
+    ListPoolRelease(*pool);
+
+    if ((**pool).arena == NULL)
+        free (*pool);
+    *pool = NULL;
+}
+
+bool ListEnableIndex (List* list, bool enable)
+{
+    LIST_CHECK_VALID
+
+    if (!enable)
+    {
+        if (list->index)
+        {
+            free (list->index->slots);
+            free (list->index);
+            list->index = NULL;
+        }
+        return true;
+    }
+
+    if (list->index)
+        return true;
+
+    ListIndex* index = calloc(1, sizeof(ListIndex));
+    if (index == NULL)
+        return false;
+
+    index->capacity = LIST_INDEX_MIN_CAPACITY;
+    while (index->capacity < list->size * 2)
+        index->capacity *= 2;
+
+    index->slots = calloc(index->capacity, sizeof(ListIndexSlot));
+    if (index->slots == NULL)
+    {
+        free (index);
+        return false;
+    }
+
+    /* elements go in order, so first element with value is put first */
+    for (ListElement* element = list->first; element; element = element->next)
+        ListIndexPut(index, element);
+
+    list->index = index;
+
+    return true;
+}
+
+bool ListEnableSnapshot (List* list, bool enable)
+{
+    LIST_CHECK_VALID
+
+    if (!enable)
+    {
+        if (list->snapshot)
+        {
+            free (list->snapshot->values);
+            free (list->snapshot->elements);
+            free (list->snapshot);
+            list->snapshot = NULL;
+        }
+        return true;
+    }
+
+    if (list->snapshot)
+        return true;
+
+    /* built on first search */
+    list->snapshot = calloc(1, sizeof(ListSnapshot));
+    return list->snapshot != NULL;
+}
+
+bool ListAddElement (List* list, void* value)
+{    
+    LIST_CHECK_VALID
+    
+    ListElement* new_element = ListAllocElement(list);
+    if (new_element == NULL)
+        return false;
+    new_element->value = value;
+    ++list->size;
+    
+    /* if it is first element */
+    if (list->first == NULL)
+    {
+        list->first = new_element;
+        list->last  = new_element;
+    }
+    else
+    {
+        new_element->prev = list->last;
+        list->last->next  = new_element;
+        list->last        = new_element;
+    }
+
+    ListIndexAdd(list, new_element, true);
+    ListSnapshotAppend(list, new_element);
+    return true;
+}
+
+bool ListAddElements (List* list, void** values, unsigned count)
+{
+    LIST_CHECK_VALID
+
+    if (!values)
+        return false;
+    if (count == 0)
+        return true;
+
+    /* empty list may switch to own pool, so all elements are in one block */
+    if (list->pool == NULL && list->size == 0 && ArenaCurrent() == NULL)
+        ListOwnPool(list, ListPoolCreate(0));
+
+    ListElement* last  = NULL;
+    ListElement* first = ListAllocChain(list, count, &last);
+    if (first == NULL)
+        return false;
+
+    unsigned i = 0;
+    for (ListElement* element = first; element; element = element->next)
+        element->value = values[i++];
+
+    ListLinkChain(list, NULL, first, last, count);
+
+    for (ListElement* element = first; element; element = element->next)
+        ListIndexAdd(list, element, true);
+
+    return true;
+}
+
+bool ListSpliceRange (List* list, ListElement* before, List* other, ListElement* first, ListElement* last, unsigned count)
+{
+    LIST_CHECK_VALID
+
+    if (!other || other->__id != __LIST_ID || !first || !last)
+        return false;
+
+    if (count == 0)
+    {
+        /* range can not be moved before its own element */
+        if (before == last)
+            return false;
+        for (ListElement* element = first; element != last; element = element->next)
+        {
+            if (element == NULL || element == before)
+                return false;
+            ++count;
+        }
+        ++count;
+    }
+
+    if (list == other)
+    {
+        ListUnlinkChain(list, first, last, count);
+        ListLinkChain(list, before, first, last, count);
+        ListIndexReorder(list);
+        return true;
+    }
+
+    /* empty list takes source of other list, so elements are moved, not copied.
+       Heap list does not take pool of arena - it is lost with arena */
+    if (list->size == 0 && list->pool != other->pool && list->arena == NULL &&
+        (list->pool == NULL || list->ownPool) &&
+        !(other->ownPool && other->pool->arena))
+    {
+        ListReleasePool(list);
+        if (other->ownPool)
+            ListOwnPool(list, other->pool);
+        else
+            list->pool = other->pool;
+    }
+
+    /* elements are freed by list later, so they must have the same source which lives long enough */
+    if (list->pool == other->pool && (list->ownPool || !other->ownPool))
+    {
+        if (other->index)
+        {
+            for (ListElement* element = first; element != last->next; element = element->next)
+                ListIndexRemove(other->index, element);
+        }
+
+        ListUnlinkChain(other, first, last, count);
+        ListLinkChain(list, before, first, last, count);
+
+        for (ListElement* element = first; element != before; element = element->next)
+            ListIndexAdd(list, element, before == NULL);
+
+        return true;
+    }
+
+    /* copy values and delete them from other list, copies are allocated before any change */
+    ListElement* copyLast  = NULL;
+    ListElement* copyFirst = ListAllocChain(list, count, &copyLast);
+    if (copyFirst == NULL)
+        return false;
+
+    ListElement* element = first;
+    for (ListElement* copy = copyFirst; copy; copy = copy->next)
+    {
+        copy->value = element->value;
+        element = element->next;
+    }
+
+    ListLinkChain(list, before, copyFirst, copyLast, count);
+    for (ListElement* copy = copyFirst; copy != before; copy = copy->next)
+        ListIndexAdd(list, copy, before == NULL);
+
+    element = first;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        ListElement* next = element->next;
+        ListDeleteElement(other, element);
+        element = next;
+    }
+
+    return true;
+}
+
+bool ListSplice (List* list, List* other)
+{
+    LIST_CHECK_VALID
+
+    if (!other || other->__id != __LIST_ID || list == other)
+        return false;
+    if (other->size == 0)
+        return true;
+
+    return ListSpliceRange(list, NULL, other, other->first, other->last, other->size);
+}
+
+bool ListSplit (List* list, ListElement* element, List* tail)
+{
+    LIST_CHECK_VALID
+
+    if (!element || !tail || list == tail)
+        return false;
+
+    /* count of moved elements, walk from element to both ends until one of them */
+    unsigned count = 0;
+    if (element == list->finger)
+    {
+        count = list->size - list->fingerNumber;
+    }
+    else
+    {
+        ListElement* forward  = element;
+        ListElement* backward = element;
+        unsigned steps = 0;
+        while (forward->next && backward->prev)
+        {
+            forward  = forward->next;
+            backward = backward->prev;
+            ++steps;
+        }
+        count = (forward->next == NULL) ? steps + 1 : list->size - steps;
+    }
+
+    return ListSpliceRange(tail, NULL, list, element, list->last, count);
+}
+
+#define LIST_SORT_RUN 16      /* elements sorted by insertion before merge */
+
+/* merge two sorted chains linked by next, elements of a go first at equal values */
+static ListElement* ListMerge (ListElement* a, ListElement* b, ListCompare compare)
+{
+    ListElement  head;
+    ListElement* tail = &head;
+    while (a && b)
+    {
+        if (compare(b->value, a->value) < 0)
+        {
+            tail->next = b;
+            b = b->next;
+            if (b)
+                __builtin_prefetch(b->next);
+        }
+        else
+        {
+            tail->next = a;
+            a = a->next;
+            if (a)
+                __builtin_prefetch(a->next);
+        }
+        tail = tail->next;
+    }
+    tail->next = (a) ? a : b;
+
+    return head.next;
+}
+
+/* bottom-up merge sort of chain linked by next, bin i keeps sorted run of 2^i runs */
+static ListElement* ListSortChain (ListElement* chain, ListCompare compare)
+{
+    ListElement* bins[32] = {NULL};
+    unsigned     binCount = 0;
+
+    while (chain)
+    {
+        /* short runs are sorted by insertion, so there are less passes of merge */
+        ListElement* run[LIST_SORT_RUN];
+        unsigned length = 0;
+        for (; chain && length < LIST_SORT_RUN; ++length, chain = chain->next)
+        {
+            unsigned i = length;
+            for (; i > 0 && compare(chain->value, run[i - 1]->value) < 0; --i)
+                run[i] = run[i - 1];
+            run[i] = chain;
+        }
+        for (unsigned i = 0; i + 1 < length; ++i)
+            run[i]->next = run[i + 1];
+        run[length - 1]->next = NULL;
+        ListElement* sorted = run[0];
+
+        /* elements in bins are before run in list */
+        unsigned i = 0;
+        for (; i < binCount && bins[i]; ++i)
+        {
+            sorted = ListMerge(bins[i], sorted, compare);
+            bins[i] = NULL;
+        }
+        if (i == 32)
+            --i;
+        bins[i] = sorted;
+        if (i == binCount)
+            ++binCount;
+    }
+
+    ListElement* result = NULL;
+    for (unsigned i = 0; i < binCount; ++i)
+    {
+        if (bins[i])
+            result = ListMerge(bins[i], result, compare);
+    }
+
+    return result;
+}
+
+#ifdef __MULTITHREADS
+/* parts of list sorted in threads and merged in pairs */
+typedef struct
+{
+    ListElement** chains;       /* sorted parts, chain i takes chain i + step */
+    unsigned      count;
+    unsigned      step;
+    ListCompare   compare;
+} ListSortJob;
+
+static void ListSortPart (void* arg, unsigned part)
+{
+    ListSortJob* job = arg;
+    job->chains[part] = ListSortChain(job->chains[part], job->compare);
+}
+
+static void ListMergePart (void* arg, unsigned part)
+{
+    ListSortJob* job = arg;
+    unsigned i = part * 2 * job->step;
+    if (i + job->step < job->count)
+        job->chains[i] = ListMerge(job->chains[i], job->chains[i + job->step], job->compare);
+}
+
+/* return sorted chain or NULL if list is sorted in one thread */
+static ListElement* ListSortInThreads (List* list, ListCompare compare)
+{
+    ThreadPool* pool = ThreadPoolGet();
+    unsigned count = (pool) ? ThreadPoolGetSize(pool) : 1;
+    if (count < 2)
+        return NULL;
+
+    ListSortJob job;
+    job.chains  = malloc(count * sizeof(ListElement*));
+    job.count   = count;
+    job.compare = compare;
+    if (job.chains == NULL)
+        return NULL;
+
+    /* cut list to parts of equal size */
+    ListElement* element = list->first;
+    unsigned partSize = list->size / count;
+    for (unsigned part = 0; part < count; ++part)
+    {
+        job.chains[part] = element;
+        if (part + 1 == count)
+            break;
+
+        for (unsigned i = 1; i < partSize; ++i)
+            element = element->next;
+        ListElement* next = element->next;
+        element->next = NULL;
+        element = next;
+    }
+
+    ThreadPoolRun(pool, ListSortPart, &job, count);
+    for (job.step = 1; job.step < count; job.step *= 2)
+        ThreadPoolRun(pool, ListMergePart, &job, (count + 2 * job.step - 1) / (2 * job.step));
+
+    ListElement* result = job.chains[0];
+    free (job.chains);
+
+    return result;
+}
 #endif // __MULTITHREADS
 
+bool ListSort (List* list, ListCompare compare)
+{
+    LIST_CHECK_VALID
 
-#define LIST_CHECK_VALID                            \
-                if (!list) return 0;                \
-                unsigned id = *(unsigned*)list;    \
-                if (id != __LIST_ID) return 0;
+    if (!compare)
+        return false;
+    if (list->size < 2)
+        return true;
 
+    ListElement* first = NULL;
+#ifdef __MULTITHREADS
+    if (list->size >= LIST_SORT_PARALLEL_SIZE)
+        first = ListSortInThreads(list, compare);
+#endif // __MULTITHREADS
+    if (first == NULL)
+        first = ListSortChain(list->first, compare);
 
-void ListInit(void* mem)
+    /* restore links to previous elements */
+    ListElement* prev = NULL;
+    for (ListElement* element = first; element; element = element->next)
+    {
+        element->prev = prev;
+        prev = element;
+    }
+    list->first = first;
+    list->last  = prev;
+
+    list->finger = NULL;
+    ListSnapshotInvalidate(list);
+    ListIndexReorder(list);
+#ifdef __MULTITHREADS
+    list->segmentCount = 0;
+#endif // __MULTITHREADS
+
+    return true;
+}
+
+/* work on chunks of list in threads */
+typedef struct
 {
-    if (mem)
+    ListElement**       starts;     /* first element of every chunk */
+    size_t              chunk;      /* elements in chunk */
+    ParallelForEachFunc forEach;
+    ParallelMapFunc     map;
+    ParallelReduceFunc  reduce;
+    void*               context;
+    void**              results;    /* accumulator of every worker for reduce */
+    bool*               used;       /* worker has got any chunk */
+} ListParallelJob;
+
+static void ListParallelTask (void* arg, size_t begin, size_t end, unsigned worker)
+{
+    ListParallelJob* job = arg;
+    void* accumulator = (job->reduce) ? job->results[worker] : NULL;
+
+    for (size_t c = begin; c < end; ++c)
     {
-        List* list = mem;
-        
-        /* already initialized? */
-        if (list->__id == __LIST_ID)
+        ListElement* element = job->starts[c];
+        for (size_t i = 0; element && i < job->chunk; ++i, element = element->next)
         {
-            ListClear(list);
+            if (job->forEach)
+                job->forEach(element->value, job->context);
+            else if (job->map)
+                element->value = job->map(element->value, job->context);
+            else
+                accumulator = job->reduce(accumulator, element->value, job->context);
         }
-        else
-        {
-            memset(list, 0, sizeof(List));
-            
-            list->__id      = __LIST_ID;
+    }
 
-            list->front     = &ListGetFirstValue;
-            list->back      = &ListGetLastValue;
-            list->push_back = &ListAddElement;
-            list->pop_back  = &ListPopBack;
-            list->at        = &ListGetValueByNumber;
-            list->clear        = &ListClear;
-            list->empty        = &ListIsEmpty;            
-        }
+    if (job->reduce)
+    {
+        job->results[worker] = accumulator;
+        job->used[worker]    = true;
     }
 }
 
-List* ListCreate()
+/* cut list to chunks and run job in threads, short list is done in caller thread */
+static void ListRunParallel (List* list, ListParallelJob* job, size_t chunk)
 {
-    List* list = malloc(sizeof(List));
-    if (list == NULL)
-        return NULL;
+    ListElement** starts = NULL;
+    size_t count = 0;
+    if (chunk)
+    {
+        count  = (list->size + chunk - 1) / chunk;
+        starts = malloc(count * sizeof(ListElement*));
+    }
 
-    ListInit(list);
+    if (starts == NULL)
+    {
+        ListElement* first = list->first;
+        job->starts = &first;
+        job->chunk  = list->size;
+        ParallelFor(1, 0, ListParallelTask, job);
+        return;
+    }
 
-    return list;
+    size_t i = 0;
+    size_t n = 0;
+    for (ListElement* element = list->first; element; element = element->next, ++n)
+    {
+        if (n % chunk == 0)
+            starts[i++] = element;
+    }
+
+    job->starts = starts;
+    job->chunk  = chunk;
+    ParallelFor(count, 1, ListParallelTask, job);
+
+    free (starts);
 }
 
-void ListClear(List* list)
+void ListForEach (List* list, ParallelForEachFunc func, void* context)
 {
     LIST_CHECK_VALID
-    
-    while (list->size)
+
+    if (!func || list->size == 0)
+        return;
+
+    ListParallelJob job =
     {
-        ListPopBack(list);
-    }
+        .forEach = func,
+        .context = context
+    };
+    ListRunParallel(list, &job, ParallelGetChunkSize(list->size));
 }
 
-void ListDestroy (List** list)
-{    
-    if (!list || !(*list))
-        return;
+void ListMap (List* list, ParallelMapFunc func, void* context)
+{
+    LIST_CHECK_VALID
 
-    ListClear(*list);
-    
-    (**list).__id = 0;
+    if (!func || list->size == 0)
+        return;
 
-    free (*list);
-    *list = NULL;
+    ListParallelJob job =
+    {
+        .map     = func,
+        .context = context
+    };
+    ListRunParallel(list, &job, ParallelGetChunkSize(list->size));
+    ListSnapshotInvalidate(list);
+
+    /* all values are changed - build index again */
+    if (list->index)
+    {
+        ListEnableIndex(list, false);
+        ListEnableIndex(list, true);
+    }
 }
 
-bool ListAddElement (List* list, void* value)
-{    
-    LIST_CHECK_VALID
-    
-    ListElement* new_element = calloc(sizeof(char), sizeof(ListElement));
-    new_element->value = value;
-    ++list->size;
-    
-    /* if it is first element */
-    if (list->first == NULL)
+void* ListReduce (List* list, ParallelReduceFunc reduce, ParallelCombineFunc combine, void* initial, void* context)
+{
+    if (!list || list->__id != __LIST_ID || !reduce || list->size == 0)
+        return initial;
+
+    size_t chunk = (combine) ? ParallelGetChunkSize(list->size) : 0;
+    unsigned workers = (chunk) ? ParallelGetWorkerCount() : 1;
+
+    void* results[workers];
+    bool  used[workers];
+    for (unsigned i = 0; i < workers; ++i)
     {
-        list->first = new_element;
-        list->last  = new_element;
+        results[i] = initial;
+        used[i]    = false;
     }
-    else
+
+    ListParallelJob job =
     {
-        new_element->prev = list->last;
-        list->last->next  = new_element;
-        list->last        = new_element;
+        .reduce  = reduce,
+        .context = context,
+        .results = results,
+        .used    = used
+    };
+    ListRunParallel(list, &job, chunk);
+
+    /* workers without chunks keep initial value */
+    void* result = initial;
+    bool  first  = true;
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        if (used[i])
+        {
+            result = (first) ? results[i] : combine(result, results[i], context);
+            first  = false;
+        }
     }
-    return true;
+
+    return result;
 }
 
 bool ListDeleteElement (List* list, ListElement* element)
@@ -134,6 +1318,21 @@ bool ListDeleteElement (List* list, ListElement* element)
     if (!element)
         return false;
 
+    if (list->index)
+        ListIndexRemove(list->index, element);
+
+#ifdef __MULTITHREADS
+    list->segmentCount = 0;
+#endif // __MULTITHREADS
+
+    ListSnapshotInvalidate(list);
+
+    /* next element takes number of deleted one, numbers of others are unknown */
+    if (element == list->finger && element->next)
+        list->finger = element->next;
+    else
+        list->finger = NULL;
+
     //free (element->value);
     element->value = NULL;
 
@@ -172,7 +1371,7 @@ bool ListDeleteElement (List* list, ListElement* element)
     }
 
 element_delete:
-    free (element);
+    ListFreeElement (list, element);
     element = NULL;
 
     return true;
@@ -185,7 +1384,15 @@ void ListPopBack(List* list)
     if (list->size > 0)
     {
         ListElement* prev = list->last->prev;
-        free(list->last);
+        if (list->index)
+            ListIndexRemove(list->index, list->last);
+        if (list->finger == list->last)
+            list->finger = NULL;
+        ListSnapshotInvalidate(list);
+#ifdef __MULTITHREADS
+        list->segmentCount = 0;
+#endif // __MULTITHREADS
+        ListFreeElement(list, list->last);
         list->last = prev;
         if (prev)
             prev->next = NULL;
@@ -220,141 +1427,163 @@ void* ListGetLastValue(List* list)
 }
 
 #ifdef __MULTITHREADS
-/* parameters for quick search element by value in list */
+/* parameters for search element by value in parts of list */
 typedef struct
 {
-    ListElement*  startElement;    /* head or tail */
-    ListElement** resultElement;
-    void*         value;           /* value for search */
-    int           maxNumber;       /* maxNumber - when it's stop */
-    signed char   direction;       /* direction for finding - 1 (head-to-tail) or -1(tail-to-head) */
-} SThrdParameter;
+    ListElement** segments;     /* first elements of parts */
+    unsigned      count;        /* count of parts */
+    const void*   value;        /* value for search */
+    ListElement** results;      /* found element in every part */
+    unsigned      found;        /* nearest to head part with value, atomic */
+} ListSearch;
 
 /* func for search element by value in thread */
-static int ListGetElementByValueThread(void* arg)
+static void ListSearchSegment (void* arg, unsigned part)
 {
-    if (arg == NULL)
-#ifdef __USE_SDL_THREADS
-        return SDL_FALSE;
-#else
-        return thrd_error;
-#endif // __USE_SDL_THREADS
-
-    SThrdParameter* param   = (SThrdParameter*)arg;
-    ListElement*   element = param->startElement;
-    int maxPos = param->maxNumber;
-    ListElement** resultElement = param->resultElement;
-
+    ListSearch*  search  = arg;
+    ListElement* element = search->segments[part];
+    ListElement* end     = (part + 1 < search->count) ? search->segments[part + 1] : NULL;
 
-    // from head to tail
-    if (param->direction > 0)
-    {
-        register unsigned i = 0;
-        while ((element != NULL) &&
-               (*resultElement == NULL) &&
-               (element->value != param->value) &&
-               (i < maxPos))
-        {
-            element = element->next;
-            ++i;
-        }
-    }
-    else
-    // from tail to head
+    for (unsigned i = 1; element != end; element = element->next, ++i)
     {
-        register unsigned i = 0;
-        while ((element != NULL) &&
-               (*resultElement == NULL) &&
-               (element->value != param->value) &&
-               (i < maxPos))
+        if (element->value == search->value)
         {
-            element = element->prev;
-            ++i;
+            search->results[part] = element;
+
+            unsigned found = __atomic_load_n(&search->found, __ATOMIC_RELAXED);
+            while (part < found &&
+                   !__atomic_compare_exchange_n(&search->found, &found, part, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+            return;
         }
+
+        /* value is already found nearer to head - stop */
+        if ((i & 63) == 0 && __atomic_load_n(&search->found, __ATOMIC_RELAXED) < part)
+            return;
     }
+}
+
+/* divide list on equal parts for every thread of pool */
+static bool ListUpdateSegments (List* list, unsigned count)
+{
+    /* appended elements go to the last part, it must not grow too much */
+    if (list->segmentCount == count && list->size < 2 * list->segmentSize)
+        return true;
 
-    if (*resultElement != NULL)
-#ifdef __USE_SDL_THREADS
-        return SDL_TRUE;
-#else
-        return thrd_success;
-#endif // __USE_SDL_THREADS
+    ListElement** segments = realloc(list->segments, count * sizeof(ListElement*));
+    if (segments == NULL)
+        return false;
+    list->segments = segments;
 
-    if (element != NULL && element->value == param->value)
-        *(resultElement) = element;
+    unsigned length = list->size / count;
+    ListElement* element = list->first;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        segments[i] = element;
+        for (unsigned j = 0; j < length; ++j)
+            element = element->next;
+    }
+    list->segmentCount = count;
+    list->segmentSize  = list->size;
 
-#ifdef __USE_SDL_THREADS
-    return SDL_TRUE;
-#else
-    return thrd_success;
-#endif // __USE_SDL_THREADS
+    return true;
 }
 
-static ListElement* ListGetElementByValueInThreads (List* list, const void* value)
+/* size of list when search in threads is faster than in one thread */
+static unsigned ListGetParallelThreshold (ThreadPool* pool)
 {
-    LIST_CHECK_VALID
-    
-    if (list->first == NULL || list->last == NULL)
-        return NULL;
+    static unsigned threshold = 0;
 
-    ListElement* result = NULL;
-    /* center of list */
-    int center = list->size / 2;
+    unsigned result = __atomic_load_n(&threshold, __ATOMIC_RELAXED);
+    if (result)
+        return result;
 
-    SThrdParameter param1 = {list->first, &result, (void*)value, center,               1};
-    SThrdParameter param2 = {list->last,  &result, (void*)value, list->size - center, -1};
+    unsigned threads = ThreadPoolGetSize(pool);
+    if (threads < 2)
+    {
+        result = UINT32_MAX;
+        goto threshold_save;
+    }
 
-#ifdef __USE_SDL_THREADS
-    SDL_Thread* threadFromHead = SDL_CreateThread(ListGetElementByValueThread, "fromHead", &param1);
-    if (threadFromHead == NULL)
-        return NULL;
-    SDL_Thread* threadFromTail = SDL_CreateThread(ListGetElementByValueThread, "fromTail", &param2);
-    if (threadFromTail == NULL)
-        return NULL;
+    /* measure search in list with elements spread over heap,
+       list is not created by new() so current arena of caller is not used */
+    List list;
+    memset(&list, 0, sizeof(List));
+    ListInit(&list);
+    for (unsigned i = 0; i < LIST_CALIBRATION_SIZE; ++i)
+        ListAddElement(&list, &list);
 
-    SDL_WaitThread(threadFromHead, NULL);
-    SDL_WaitThread(threadFromTail, NULL);
+    uint64_t best = UINT64_MAX;
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        uint64_t start = ThreadPoolTime();
+        ListElement* element = list.first;
+        while (element && element->value != NULL)
+            element = element->next;
+        uint64_t elapsed = ThreadPoolTime() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    ListClear(&list);
 
-#else // NOT __USE_SDL_THREADS
-    thrd_t threadFromHead = 0;
-    thrd_t threadFromTail = 0;
+    double perElement = (double)best / LIST_CALIBRATION_SIZE;
+    if (perElement <= 0.0)
+        perElement = 1.0;
 
-    if (thrd_create(&threadFromHead, ListGetElementByValueThread, &param1) != thrd_success)
-        return NULL;
+    /* threads save (1 - 1/threads) of search time, they must save twice more than start of job */
+    double size = 2.0 * ThreadPoolGetOverhead(pool) / (perElement * (1.0 - 1.0 / threads));
+    result = (size < UINT32_MAX) ? (unsigned)size : UINT32_MAX;
+    if (result < MAX_VALUES_FOR_ONE_THRD)
+        result = MAX_VALUES_FOR_ONE_THRD;
 
-    if (thrd_create(&threadFromTail, ListGetElementByValueThread, &param2) != thrd_success)
-        return NULL;
+threshold_save:
+    __atomic_store_n(&threshold, result, __ATOMIC_RELAXED);
+    return result;
+}
 
-    /* waits until threads are completed */
-    if (thrd_join(threadFromHead, NULL) != thrd_success)
-        return NULL;
-    if (thrd_join(threadFromTail, NULL) != thrd_success)
-        return NULL;
-#endif // __USE_SDL_THREADS
+/* search element in threads, return false if list can not be divided on parts */
+static bool ListGetElementByValueInThreads (List* list, const void* value, ListElement** result)
+{
+    ThreadPool* pool = ThreadPoolGet();
+    unsigned count = ThreadPoolGetSize(pool);
+    if (!ListUpdateSegments(list, count))
+        return false;
 
-    return result;
+    ListElement* results[count];
+    memset(results, 0, sizeof(results));
+
+    ListSearch search = {list->segments, count, value, results, UINT32_MAX};
+    ThreadPoolRun(pool, ListSearchSegment, &search, count);
+
+    *result = (search.found == UINT32_MAX) ? NULL : results[search.found];
+    return true;
 }
 #endif // __MULTITHREADS
 
 ListElement* ListGetElementByValue (List* list, const void* value)
 {
     LIST_CHECK_VALID
-    
-    #ifdef __MULTITHREADS
-    ListElement* element = NULL;
-    if (list->size <= MAX_VALUES_FOR_ONE_THRD)
+
+    if (list->index)
+        return ListIndexFind(list, value);
+
+    ListSnapshot* snapshot = (list->snapshot) ? ListSnapshotGet(list) : NULL;
+    if (snapshot)
     {
-        element = list->first;
-        while (element && element->value != value)
-            element = element->next;
+        size_t i = PtrScanFind((void* const*)snapshot->values, snapshot->count, value);
+        return (i < snapshot->count) ? snapshot->elements[i] : NULL;
     }
-    else
-        element = ListGetElementByValueInThreads(list, value);
-    #else // NOT __MULTITHREADS
+    
+    #ifdef __MULTITHREADS
+    ListElement* found = NULL;
+    if (list->size > MAX_VALUES_FOR_ONE_THRD &&
+        list->size >= ListGetParallelThreshold(ThreadPoolGet()) &&
+        ListGetElementByValueInThreads(list, value, &found))
+        return found;
+    #endif // __MULTITHREADS
+
     ListElement* element = list->first;
     while (element && element->value != value)
-            element = element->next;
-    #endif // __MULTITHREADS
+        element = element->next;
 
     return element;
 }
@@ -367,8 +1596,25 @@ ListElement* ListGetElementByNumber (List* list, unsigned numOfElement)
         return NULL;
     
     ListElement* element = NULL;
-    /* check which way is faster - from the head or from the tail */
-    if ((list->size - numOfElement) >= numOfElement)
+    unsigned fromHead = numOfElement;
+    unsigned fromTail = list->size - 1 - numOfElement;
+    unsigned fromFinger = list->size;
+    if (list->finger)
+        fromFinger = (numOfElement >= list->fingerNumber) ?
+                     numOfElement - list->fingerNumber :
+                     list->fingerNumber - numOfElement;
+
+    /* check which way is faster - from the finger, the head or the tail */
+    if (fromFinger <= fromHead && fromFinger <= fromTail)
+    {
+        /* go from last accessed element */
+        element = list->finger;
+        for (unsigned i = list->fingerNumber; element && (i < numOfElement); ++i)
+            element = element->next;
+        for (unsigned i = list->fingerNumber; element && (i > numOfElement); --i)
+            element = element->prev;
+    }
+    else if (fromHead <= fromTail)
     {
         /* go from head */
         element = list->first;
@@ -383,6 +1629,9 @@ ListElement* ListGetElementByNumber (List* list, unsigned numOfElement)
             element = element->prev;
     }
 
+    list->finger       = element;
+    list->fingerNumber = numOfElement;
+
     return element;
 }
 
@@ -426,6 +1675,27 @@ int ListGetNumberByValue (List* list, void* value)
     if (list->first == NULL)
         return -1;
 
+    ListSnapshot* snapshot = (list->snapshot) ? ListSnapshotGet(list) : NULL;
+    if (snapshot)
+    {
+        /* position in snapshot is number of element */
+        size_t i = PtrScanFind((void* const*)snapshot->values, snapshot->count, value);
+        return (i < snapshot->count) ? (int)i : -1;
+    }
+
+    if (list->index)
+    {
+        /* find element at once, but number is still counted by the way back to head */
+        ListElement* element = ListIndexFind(list, value);
+        if (element == NULL)
+            return -1;
+
+        int num = 0;
+        for (element = element->prev; element; element = element->prev)
+            ++num;
+        return num;
+    }
+
     // ����������� �� ���� ���������, ���� �� ��������� �� �������� ��� �� �����...
     int num = 0;
     ListElement* element = list->first;
@@ -469,7 +1739,7 @@ void ListSetValueByNumber(List* list, unsigned numOfElement, void* value)
     if (element == NULL)
         return;
 
-    element->value = value;
+    ListSetElementValue(list, element, value);
 }
 
 bool ListChangeValue(List* list, const void* oldValue, void* newValue)
@@ -486,7 +1756,7 @@ bool ListChangeValue(List* list, const void* oldValue, void* newValue)
     if (element == NULL)
         return false;
 
-    element->value = newValue;
+    ListSetElementValue(list, element, newValue);
 
     return true;
 }
@@ -496,6 +1766,41 @@ bool ListChangeValue(List* list, const void* oldValue, void* newValue)
 /*  TESTS!!! */
 #ifdef _DEBUG
 #define MAX_LIST_SIZE 6000
+
+/* last two digits in descending order */
+static int ListTestCompareDigits (const void* a, const void* b)
+{
+    return *(const int*)b % 100 - *(const int*)a % 100;
+}
+
+static int ListTestCompareNumbers (const void* a, const void* b)
+{
+    return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+}
+
+static void ListTestCount (void* value, void* context)
+{
+    __atomic_fetch_add((unsigned*)context, *(int*)value, __ATOMIC_RELAXED);
+}
+
+static void* ListTestNext (void* value, void* context)
+{
+    (void)context;
+    return (int*)value + 1;
+}
+
+static void* ListTestSum (void* accumulator, void* value, void* context)
+{
+    (void)context;
+    return (void*)((uintptr_t)accumulator + *(int*)value);
+}
+
+static void* ListTestAdd (void* a, void* b, void* context)
+{
+    (void)context;
+    return (void*)((uintptr_t)a + (uintptr_t)b);
+}
+
 void ListTest()
 {
     printf ("List's tests started!!!\n");
@@ -668,7 +1973,257 @@ void ListTest()
     #endif // __USE_SDL_THREADS
     printf ("passed!\n");
 
+    /* test16 : elements from pool */
+    printf ("--------test16--------\n");
+    ListPool* pool = ListPoolCreate(0);
+    List* pooled = ListCreateWithPool(pool);
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        ListAddElement(pooled, &array[i]);
+    assert(ListGetSize(pooled) == MAX_LIST_SIZE);
+    ListDeleteElementByValue(pooled, &array[10]);
+    ListPopBack(pooled);
+    assert(ListGetSize(pooled) == MAX_LIST_SIZE - 2);
+    assert(ListGetValueByNumber(pooled, 10) == &array[11]);
+    /* recycled elements are used again */
+    ListAddElement(pooled, &array[10]);
+    assert(ListGetLastValue(pooled) == &array[10]);
+    ListClear(pooled);
+    assert(ListIsEmpty(pooled));
+    ListAddElement(pooled, &array[0]);
+    assert(ListGetFirstValue(pooled) == &array[0]);
+    ListDestroy(&pooled);
+    ListPoolDestroy(&pool);
+    assert(pool == NULL);
+    /* list with own pool */
+    pooled = ListCreateWithPool(NULL);
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        ListAddElement(pooled, &array[i]);
+    ListClear(pooled);
+    assert(ListGetSize(pooled) == 0);
+    ListAddElement(pooled, &array[1]);
+    assert(ListGetFirstValue(pooled) == &array[1]);
+    ListDestroy(&pooled);
+    printf ("passed!\n");
+
+    /* test17 : search by hash index */
+    printf ("--------test17--------\n");
+    assert(ListEnableIndex(list, true));
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        assert(ListGetElementByValue(list, &array[i])->value == &array[i]);
+    assert(ListGetNumberByValue(list, &array[123]) == 123);
+    for (unsigned i = 0; i < MAX_LIST_SIZE; i += 2)
+        ListDeleteElementByValue(list, &array[i]);
+    assert(ListGetSize(list) == MAX_LIST_SIZE / 2);
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        assert((ListGetElementByValue(list, &array[i]) != NULL) == (i % 2 == 1));
+    assert(ListChangeValue(list, &array[1], &array[0]));
+    assert(ListGetElementByValue(list, &array[1]) == NULL);
+    assert(ListGetNumberByValue(list, &array[0]) == 0);
+    ListSetValueByNumber(list, 1, &array[2]);
+    assert(ListGetElementByValue(list, &array[3]) == NULL);
+    assert(ListGetNumberByValue(list, &array[2]) == 1);
+    ListPopBack(list);
+    assert(ListGetElementByValue(list, &array[MAX_LIST_SIZE - 1]) == NULL);
+    ListClear(list);
+    assert(ListGetElementByValue(list, &array[5]) == NULL);
+    ListAddElement(list, &array[5]);
+    assert(ListGetElementByValue(list, &array[5]) == list->first);
+    /* repeated values are found by first element with value */
+    ListAddElement(list, &array[6]);
+    ListAddElement(list, &array[5]);
+    assert(ListGetNumberByValue(list, &array[5]) == 0);
+    ListDeleteElementByValue(list, &array[5]);
+    assert(ListGetNumberByValue(list, &array[5]) == 1);
+    List* other = ListCreate();
+    ListAddElement(other, &array[5]);
+    assert(ListSpliceRange(list, list->first, other, other->first, other->last, 1));
+    assert(ListGetElementByValue(list, &array[5]) == list->first);
+    ListAddElement(other, &array[6]);
+    assert(ListSpliceRange(list, list->last, other, other->first, other->last, 1));
+    assert(ListGetNumberByValue(list, &array[6]) == 1);
+    ListDeleteElementByValue(list, &array[6]);
+    assert(ListGetNumberByValue(list, &array[6]) == 1 && ListGetSize(list) == 3);
+    ListAddElement(list, &array[7]);
+    assert(ListChangeValue(list, &array[5], &array[7]));
+    assert(ListGetNumberByValue(list, &array[7]) == 0);
+    assert(ListGetNumberByValue(list, &array[5]) == 2);
+    ListDestroy(&other);
+    assert(ListEnableIndex(list, false));
+    assert(ListGetElementByValue(list, &array[5]) == list->last->prev);
+    printf ("passed!\n");
+
+    /* test18 : access by number near last accessed element */
+    printf ("--------test18--------\n");
+    ListClear(list);
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        ListAddElement(list, &array[i]);
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        assert(ListGetValueByNumber(list, i) == &array[i]);
+    for (unsigned i = MAX_LIST_SIZE; i > 0; --i)
+        assert(ListGetValueByNumber(list, i - 1) == &array[i - 1]);
+    assert(ListGetValueByNumber(list, 2000) == &array[2000]);
+    assert(ListGetValueByNumber(list, 1990) == &array[1990]);
+    /* numbers are changed after deleting */
+    ListDeleteElementByNumber(list, 1990);
+    assert(ListGetValueByNumber(list, 1990) == &array[1991]);
+    ListDeleteElementByValue(list, &array[5]);
+    assert(ListGetValueByNumber(list, 1990) == &array[1992]);
+    assert(ListGetValueByNumber(list, MAX_LIST_SIZE - 3) == &array[MAX_LIST_SIZE - 1]);
+    ListPopBack(list);
+    assert(ListGetValueByNumber(list, MAX_LIST_SIZE - 4) == &array[MAX_LIST_SIZE - 2]);
+    printf ("passed!\n");
+
+    /* test19 : batch add, splice and split */
+    printf ("--------test19--------\n");
+    void** values = malloc(MAX_LIST_SIZE*sizeof(void*));
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        values[i] = &array[i];
+    List* batch = ListCreate();
+    assert(ListAddElements(batch, values, MAX_LIST_SIZE));
+    assert(batch->pool && batch->pool->slabs->count >= MAX_LIST_SIZE);
+    assert(ListGetSize(batch) == MAX_LIST_SIZE);
+    assert(ListGetValueByNumber(batch, 1234) == &array[1234]);
+    /* empty list takes own pool of batch, so elements are moved there and back */
+    List* plain = ListCreate();
+    ListElement* moved = batch->first;
+    assert(ListSplice(plain, batch));
+    assert(ListIsEmpty(batch) && ListGetSize(plain) == MAX_LIST_SIZE && plain->first == moved);
+    assert(plain->ownPool && plain->pool == batch->pool && plain->pool->lists == 2);
+    assert(ListSplice(batch, plain));
+    assert(ListIsEmpty(plain) && batch->first == moved);
+    ListDestroy(&plain);
+    assert(batch->pool->lists == 1 && ListGetValueByNumber(batch, 1234) == &array[1234]);
+    /* lists with shared pool give elements to each other */
+    pool = ListPoolCreate(0);
+    List* head = ListCreateWithPool(pool);
+    List* tail = ListCreateWithPool(pool);
+    assert(ListAddElements(head, values, MAX_LIST_SIZE));
+    ListElement* middle = ListGetElementByNumber(head, 1000);
+    assert(ListSplit(head, middle, tail));
+    assert(ListGetSize(head) == 1000 && ListGetSize(tail) == MAX_LIST_SIZE - 1000);
+    assert(ListGetLastValue(head) == &array[999] && ListGetFirstValue(tail) == &array[1000]);
+    assert(ListSplit(tail, ListGetElementByValue(tail, &array[MAX_LIST_SIZE - 10]), head));
+    assert(ListGetSize(tail) == MAX_LIST_SIZE - 1010 && ListGetSize(head) == 1010);
+    assert(ListGetValueByNumber(head, 1000) == &array[MAX_LIST_SIZE - 10]);
+    ListEnableIndex(head, true);
+    assert(ListSplice(head, tail));
+    assert(ListIsEmpty(tail) && ListGetSize(head) == MAX_LIST_SIZE);
+    assert(ListGetNumberByValue(head, &array[1500]) == 1010 + 500);
+    /* move range to the front of the same list */
+    assert(ListSpliceRange(head, head->first, head, ListGetElementByNumber(head, 1010), head->last, 0));
+    assert(ListGetFirstValue(head) == &array[1000] && ListGetLastValue(head) == &array[MAX_LIST_SIZE - 1]);
+    assert(ListGetValueByNumber(head, MAX_LIST_SIZE - 1010) == &array[0]);
+    assert(!ListSpliceRange(head, ListGetElementByNumber(head, 5), head, head->first, ListGetElementByNumber(head, 9), 0));
+    assert(!ListSpliceRange(head, head->last, head, ListGetElementByNumber(head, 9), head->last, 0));
+    assert(ListGetSize(head) == MAX_LIST_SIZE && ListGetFirstValue(head) == &array[1000]);
+    /* own pools - values are copied */
+    assert(ListSplice(batch, head));
+    assert(ListIsEmpty(head) && ListGetSize(batch) == 2 * MAX_LIST_SIZE);
+    assert(ListGetValueByNumber(batch, MAX_LIST_SIZE) == &array[1000]);
+    ListDestroy(&head);
+    ListDestroy(&tail);
+    ListPoolDestroy(&pool);
+    ListDestroy(&batch);
+    free(values);
+    printf ("passed!\n");
+
+    /* test20 : stable sort */
+    printf ("--------test20--------\n");
+    ListClear(list);
+    for (unsigned i = 0; i < MAX_LIST_SIZE; ++i)
+        ListAddElement(list, &array[i]);
+    assert(ListSort(list, ListTestCompareDigits));
+    assert(ListGetSize(list) == MAX_LIST_SIZE);
+    for (ListElement* element = list->first; element->next; element = element->next)
+    {
+        int a = *(int*)element->value;
+        int b = *(int*)element->next->value;
+        assert(a % 100 > b % 100 || (a % 100 == b % 100 && a < b));
+        assert(element->next->prev == element);
+    }
+    assert(ListGetValueByNumber(list, 0) == &array[99]);
+    assert(ListGetLastValue(list) == &array[MAX_LIST_SIZE - 100]);
+    /* long list is sorted in threads */
+    uint32_t seed = 2463534242u;
+    List* numbers = ListCreate();
+    for (unsigned i = 0; i < 100000; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        ListAddElement(numbers, (void*)(uintptr_t)(seed % 50000));
+    }
+    assert(ListSort(numbers, ListTestCompareNumbers));
+    assert(ListGetSize(numbers) == 100000);
+    unsigned count = 1;
+    for (ListElement* element = numbers->first; element->next; element = element->next, ++count)
+        assert((uintptr_t)element->value <= (uintptr_t)element->next->value);
+    assert(count == 100000);
+    assert(ListGetValueByNumber(numbers, 99999) == numbers->last->value);
+    ListDestroy(&numbers);
+    printf ("passed!\n");
+
+    /* test21 : for each, map and reduce */
+    printf ("--------test21--------\n");
+    ListClear(list);
+    for (unsigned i = 0; i < MAX_LIST_SIZE - 1; ++i)
+        ListAddElement(list, &array[i]);
+    unsigned sum = 0;
+    ListForEach(list, ListTestCount, &sum);
+    assert(sum == (MAX_LIST_SIZE - 1) * (MAX_LIST_SIZE - 2) / 2);
+    assert((uintptr_t)ListReduce(list, ListTestSum, ListTestAdd, NULL, NULL) == sum);
+    assert((uintptr_t)ListReduce(list, ListTestSum, NULL, NULL, NULL) == sum);
+    ListEnableIndex(list, true);
+    ListMap(list, ListTestNext, NULL);
+    assert(ListGetFirstValue(list) == &array[1]);
+    assert(ListGetLastValue(list) == &array[MAX_LIST_SIZE - 1]);
+    assert(ListGetNumberByValue(list, &array[100]) == 99);
+    assert((uintptr_t)ListReduce(list, ListTestSum, ListTestAdd, NULL, NULL) == sum + MAX_LIST_SIZE - 1);
+    ListEnableIndex(list, false);
+    printf ("passed!\n");
+
+    /* test22 : search by snapshot */
+    printf ("--------test22--------\n");
+    ListClear(list);
+    for (unsigned i = 0; i < 1000; ++i)
+        ListAddElement(list, &array[i]);
+    assert(ListEnableSnapshot(list, true));
+    assert(ListGetElementByValue(list, &array[777])->value == &array[777]);
+    assert(ListGetNumberByValue(list, &array[777]) == 777);
+    assert(ListGetElementByValue(list, &array[1000]) == NULL);
+    /* appended elements are found without rebuild */
+    for (unsigned i = 1000; i < 1100; ++i)
+        ListAddElement(list, &array[i]);
+    assert(list->snapshot->valid);
+    assert(ListGetNumberByValue(list, &array[1099]) == 1099);
+    /* deletion makes snapshot invalid */
+    ListDeleteElementByValue(list, &array[0]);
+    assert(!list->snapshot->valid);
+    assert(ListGetNumberByValue(list, &array[1099]) == 1098);
+    assert(ListGetNumberByValue(list, &array[0]) == -1);
+    ListSetValueByNumber(list, 5, &array[2000]);
+    assert(ListGetNumberByValue(list, &array[2000]) == 5);
+    assert(ListGetNumberByValue(list, &array[6]) == -1);
+    assert(ListEnableSnapshot(list, false));
+    assert(ListGetNumberByValue(list, &array[2000]) == 5);
+    printf ("passed!\n");
+
+    ListDestroy(&list);
+
+    /* test23 : list set up in memory of malloc is given back to free() */
+    printf ("--------test23--------\n");
+    list = malloc(sizeof(List));
+    list->__id = 0;
+    ListInit(list);
+    assert(!list->__alloc);
+    ListAddElement(list, &array[0]);
     ListDestroy(&list);
+    assert(list == NULL);
+    list = ListCreate();
+    assert(list->__alloc);
+    ListDestroy(&list);
+    printf ("passed!\n");
+
     free(array);
     free(value1);
     free(value2);
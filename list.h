@@ -19,8 +19,9 @@
 #ifndef __LIST_H
 #define __LIST_H
 
-//#define __MULTITHREADS
-//#define __USE_SDL_THREADS
+#include "config.h"
+#include "arena.h"
+#include "parallel.h"
 
 #define __LIST_ID 1953720652   /* 'L' 'i' 's' 't' */
 
@@ -32,14 +33,56 @@ typedef struct ListElement_tag
     struct ListElement_tag* next;  
 } ListElement;
 
+/* compare values of elements: <0 if a goes before b, 0 if equal, >0 if after */
+typedef int (*ListCompare)(const void* a, const void* b);
+
+#define LIST_POOL_SLAB_SIZE     64     /* elements in first slab of pool */
+#define LIST_POOL_MAX_SLAB_SIZE 4096   /* slabs grow twice up to this size */
+
+/* block of elements allocated at once */
+typedef struct ListPoolSlab_tag
+{
+    struct ListPoolSlab_tag* next;
+    unsigned count;                 /* capacity of slab */
+    ListElement elements[];
+} ListPoolSlab;
+
+/* pool of list elements, may be shared by several lists */
+typedef struct
+{
+    ListPoolSlab* slabs;            /* newest slab is first */
+    ListElement*  free;             /* recycled elements linked by next */
+    unsigned      used;             /* elements taken from newest slab */
+    unsigned      slabSize;         /* capacity of next slab */
+    unsigned      lists;            /* lists owning pool, the last of them destroys it */
+    Arena*        arena;            /* source of slabs, NULL - malloc */
+} ListPool;
+
 typedef struct
 {
     unsigned __id;
+    bool     __alloc;          /* memory of ListCreate from AllocMemory, else of malloc */
     
     unsigned size;
 
     ListElement* first;        /* head */
     ListElement* last;         /* tail */
+
+    ListPool* pool;            /* source of elements, NULL - malloc every element */
+    bool      ownPool;         /* pool created by list (or taken from other one) and destroyed with the last owner */
+    Arena*    arena;           /* list is allocated in arena, NULL - malloc */
+
+    struct ListIndex_tag* index;   /* hash index value->element, NULL - search by scan */
+    struct ListSnapshot_tag* snapshot; /* array of values for vector search, NULL - none */
+
+    ListElement* finger;       /* last element accessed by number, NULL - unknown */
+    unsigned     fingerNumber; /* number of finger in list */
+
+#ifdef __MULTITHREADS
+    ListElement** segments;    /* first elements of parts for search in threads */
+    unsigned      segmentCount;/* 0 - parts must be found again */
+    unsigned      segmentSize; /* size of list when parts were found */
+#endif // __MULTITHREADS
     
     void* (*front)(void* this);
     void* (*back) (void* this);
@@ -52,15 +95,57 @@ typedef struct
 
 /** init memory as list */
 void ListInit(void* mem);
-/** create list and return pointer to list */
+/** create list and return pointer to list.
+    In current arena the list, its pool and elements are allocated in arena */
 List* ListCreate ();
 /** delete all elements in list */
 void ListClear (List* list);
 /** clear and destroy list */
 void ListDestroy (List** list);
 
+/** create pool of elements with slabs of slabSize elements (0 - default), in current arena if it is */
+ListPool* ListPoolCreate (unsigned slabSize);
+/** free all slabs of pool, lists using pool must be cleared before */
+void ListPoolDestroy (ListPool** pool);
+/** create list which takes elements from pool, if pool is NULL then list creates own pool */
+List* ListCreateWithPool (ListPool* pool);
+
+/** build (or drop) hash index of values, so search of element by value takes O(1).
+    If value is in list several times, search returns first element with it as without index,
+    but after deleting first of them or inserting in middle of list the next one is found by scan.
+    ListGetNumberByValue still counts number by the way back to head - O(n) */
+bool ListEnableIndex (List* list, bool enable);
+
+/** keep (or drop) array of values in order of list, search by value scans it with SIMD.
+    Array is rebuilt on first search after list is changed, append keeps it */
+bool ListEnableSnapshot (List* list, bool enable);
+
 /** add value to exists list, return false if not */
 bool ListAddElement (List* list, void* value);
+/** add count values from array to end of list, elements are taken in one block
+    (empty list without pool gets own pool for it). Return false if not */
+bool ListAddElements (List* list, void** values, unsigned count);
+/** move elements from first to last of other list before element of list (NULL - to the end).
+    count - count of moved elements, 0 - count them. Empty list takes source of elements of other one.
+    In the same list before must be out of range, it is checked only when count is 0.
+    Takes O(1) if both lists take elements from the same pool (or both from malloc) and list has no index,
+    else values are copied. Return false if not, then both lists are not changed */
+bool ListSpliceRange (List* list, ListElement* before, List* other, ListElement* first, ListElement* last, unsigned count);
+/** move all elements of other list to the end of list */
+bool ListSplice (List* list, List* other);
+/** move element and all elements after it to the end of tail list.
+    Moved elements are counted in O(min(k, n - k)), at once if element is last accessed by number */
+bool ListSplit (List* list, ListElement* element, List* tail);
+/** sort list by values in place, equal values keep their order.
+    Long lists are sorted in threads if __MULTITHREADS is defined, so compare must be thread-safe */
+bool ListSort (List* list, ListCompare compare);
+/** call func for every value of list, long list is processed in threads */
+void ListForEach (List* list, ParallelForEachFunc func, void* context);
+/** replace every value of list with result of func, long list is processed in threads */
+void ListMap (List* list, ParallelMapFunc func, void* context);
+/** reduce values of list to one value, starting with initial. Long list is processed in threads,
+    every of them starts with initial and results are joined by combine. combine NULL - one thread */
+void* ListReduce (List* list, ParallelReduceFunc reduce, ParallelCombineFunc combine, void* initial, void* context);
 /** delete element from list */
 bool ListDeleteElement (List* list, ListElement* element);
 /** delete value from list */
@@ -90,7 +175,7 @@ unsigned ListGetSize (List* list);
 bool ListIsEmpty(List* list);
 
 /* SETTERS */
-/** set value of element by position in dictionary */
+/** set value of element by position in list */
 void ListSetValueByNumber(List* list, unsigned numOfElement, void* value);
 /** change value of element. Return false if value not changed */
 bool ListChangeValue(List* list, const void* oldValue, void* newValue);
@@ -11,6 +11,23 @@ void main()
 {        
     #ifdef _DEBUG
     ListTest();
+    UListTest();
+    TreeListTest();
+    VectorTest();
+    DequeTest();
+    IListTest();
+    CListTest();
+    ArenaTest();
+    AllocTest();
+    AllocStatsTest();
+    ParallelTest();
+    PtrScanTest();
+    StringTest();
+    StringBuilderTest();
+    RopeTest();
+    InternTest();
+    Utf8Test();
+    DictionaryTest();
     #endif // _DEBUG
         
     /* test swap values */
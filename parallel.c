@@ -0,0 +1,348 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "parallel.h"
+
+#ifdef __MULTITHREADS
+    #include "thrdpool.h"
+#endif // __MULTITHREADS
+
+
+#ifdef __MULTITHREADS
+/* chunks of job are taken by threads one by one */
+typedef struct
+{
+    ParallelTask task;
+    void*        arg;
+    size_t       count;
+    size_t       chunk;
+    size_t       next;          /* begin of next free chunk, atomic */
+} ParallelJob;
+
+static void ParallelWorker (void* arg, unsigned part)
+{
+    ParallelJob* job = arg;
+    for (;;)
+    {
+        size_t begin = __atomic_fetch_add(&job->next, job->chunk, __ATOMIC_RELAXED);
+        if (begin >= job->count)
+            break;
+
+        size_t end = begin + job->chunk;
+        if (end > job->count)
+            end = job->count;
+
+        job->task(job->arg, begin, end, part);
+    }
+}
+#endif // __MULTITHREADS
+
+unsigned ParallelGetWorkerCount ()
+{
+#ifdef __MULTITHREADS
+    ThreadPool* pool = ThreadPoolGet();
+    if (pool)
+        return ThreadPoolGetSize(pool);
+#endif // __MULTITHREADS
+
+    return 1;
+}
+
+size_t ParallelGetChunkSize (size_t count)
+{
+    unsigned workers = ParallelGetWorkerCount();
+    if (workers < 2 || count < PARALLEL_MIN_COUNT)
+        return 0;
+
+    size_t chunk = count / ((size_t)workers * PARALLEL_CHUNKS_PER_THREAD);
+    return (chunk > 0) ? chunk : 1;
+}
+
+void ParallelFor (size_t count, size_t chunk, ParallelTask task, void* arg)
+{
+    if (!task || count == 0)
+        return;
+
+#ifdef __MULTITHREADS
+    ThreadPool* pool = ThreadPoolGet();
+    if (pool && chunk > 0 && chunk < count)
+    {
+        ParallelJob job =
+        {
+            .task  = task,
+            .arg   = arg,
+            .count = count,
+            .chunk = chunk,
+            .next  = 0
+        };
+        ThreadPoolRun(pool, ParallelWorker, &job, ThreadPoolGetSize(pool));
+        return;
+    }
+#else
+    (void)chunk;
+#endif // __MULTITHREADS
+
+    task(arg, 0, count, 0);
+}
+
+/* parameters of work on array */
+typedef struct
+{
+    char*   array;
+    size_t  size;
+    ParallelForEachFunc forEach;
+    ParallelReduceFunc  reduce;
+    size_t  count;              /* elements in pattern of fill */
+    void*   context;
+    void**  results;            /* accumulator of every worker */
+    bool*   used;               /* worker has got any chunk */
+} ArrayJob;
+
+static void ArrayFillTask (void* arg, size_t begin, size_t end, unsigned worker)
+{
+    (void)worker;
+    ArrayJob* job = arg;
+    size_t block = job->count;      /* elements in pattern at begin of array */
+    if (begin < block)
+        begin = block;
+    while (begin < end)
+    {
+        size_t n = (end - begin < block) ? end - begin : block;
+        memcpy(job->array + begin * job->size, job->array, n * job->size);
+        begin += n;
+    }
+}
+
+static void ArrayForEachTask (void* arg, size_t begin, size_t end, unsigned worker)
+{
+    (void)worker;
+    ArrayJob* job = arg;
+    for (size_t i = begin; i < end; ++i)
+        job->forEach(job->array + i * job->size, job->context);
+}
+
+static void ArrayReduceTask (void* arg, size_t begin, size_t end, unsigned worker)
+{
+    ArrayJob* job = arg;
+    void* accumulator = job->results[worker];
+    for (size_t i = begin; i < end; ++i)
+        accumulator = job->reduce(accumulator, job->array + i * job->size, job->context);
+    job->results[worker] = accumulator;
+    job->used[worker] = true;
+}
+
+void ArrayForEach (void* array, size_t count, size_t size, ParallelForEachFunc func, void* context)
+{
+    if (!array || !func || size == 0)
+        return;
+
+    ArrayJob job =
+    {
+        .array   = array,
+        .size    = size,
+        .forEach = func,
+        .context = context
+    };
+    ParallelFor(count, ParallelGetChunkSize(count), ArrayForEachTask, &job);
+}
+
+void ArrayFill (void* array, size_t count, size_t size, const void* value)
+{
+    if (!array || !value || size == 0 || count == 0)
+        return;
+
+    char* data = array;
+
+    /* pattern: 1, 2, 4 ... values while it fits in block */
+    size_t block = ARRAY_FILL_BLOCK / size;
+    if (block == 0)
+        block = 1;
+    if (block > count)
+        block = count;
+
+    memcpy(data, value, size);
+    for (size_t done = 1; done < block; )
+    {
+        size_t n = (done < block - done) ? done : block - done;
+        memcpy(data + done * size, data, n * size);
+        done += n;
+    }
+    if (block == count)
+        return;
+
+    /* rest is copied from pattern, it stays in cache */
+    ArrayJob job =
+    {
+        .array = data,
+        .size  = size,
+        .count = block
+    };
+    size_t chunk = ((count - block) * size >= ARRAY_FILL_THREADS) ? ParallelGetChunkSize(count) : 0;
+    ParallelFor(count, chunk, ArrayFillTask, &job);
+}
+
+void* ArrayReduce (void* array, size_t count, size_t size,
+                   ParallelReduceFunc reduce, ParallelCombineFunc combine, void* initial, void* context)
+{
+    if (!array || !reduce || size == 0)
+        return initial;
+
+    size_t chunk = (combine) ? ParallelGetChunkSize(count) : 0;
+    unsigned workers = (chunk) ? ParallelGetWorkerCount() : 1;
+
+    void* results[workers];
+    bool  used[workers];
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        results[i] = initial;
+        used[i]    = false;
+    }
+
+    ArrayJob job =
+    {
+        .array   = array,
+        .size    = size,
+        .reduce  = reduce,
+        .context = context,
+        .results = results,
+        .used    = used
+    };
+    ParallelFor(count, chunk, ArrayReduceTask, &job);
+
+    /* workers without chunks keep initial value */
+    void* result = initial;
+    bool  first  = true;
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        if (used[i])
+        {
+            result = (first) ? results[i] : combine(result, results[i], context);
+            first  = false;
+        }
+    }
+
+    return result;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#include "cext.h"
+
+#define MAX_PARALLEL_SIZE 100000
+
+static void ParallelTestMark (void* arg, size_t begin, size_t end, unsigned worker)
+{
+    unsigned char* marks = arg;
+    assert(worker < ParallelGetWorkerCount());
+    for (size_t i = begin; i < end; ++i)
+        ++marks[i];
+}
+
+static void ParallelTestTwice (void* value, void* context)
+{
+    (void)context;
+    *(int*)value *= 2;
+}
+
+static void* ParallelTestSum (void* accumulator, void* value, void* context)
+{
+    (void)context;
+    return (void*)((uintptr_t)accumulator + *(int*)value);
+}
+
+static void* ParallelTestAdd (void* a, void* b, void* context)
+{
+    (void)context;
+    return (void*)((uintptr_t)a + (uintptr_t)b);
+}
+
+void ParallelTest()
+{
+    printf ("Parallel's tests started!!!\n");
+
+    /* test1 : every element is in one chunk */
+    printf ("--------test1--------\n");
+    unsigned char* marks = calloc(MAX_PARALLEL_SIZE, 1);
+    ParallelFor(MAX_PARALLEL_SIZE, 7, ParallelTestMark, marks);
+    ParallelFor(MAX_PARALLEL_SIZE, ParallelGetChunkSize(MAX_PARALLEL_SIZE), ParallelTestMark, marks);
+    ParallelFor(MAX_PARALLEL_SIZE, 0, ParallelTestMark, marks);
+    for (size_t i = 0; i < MAX_PARALLEL_SIZE; ++i)
+        assert(marks[i] == 3);
+    assert(ParallelGetChunkSize(10) == 0);
+    free(marks);
+    printf ("passed!\n");
+
+    /* test2 : array from new() */
+    printf ("--------test2--------\n");
+    int* array = AllocMemory(ALLOC_TYPE_NONE, sizeof(int), MAX_PARALLEL_SIZE);
+    assert(ARRAY_COUNT(array) == MAX_PARALLEL_SIZE);
+    for (int i = 0; i < MAX_PARALLEL_SIZE; ++i)
+        array[i] = i % 1000;
+    ArrayForEach(array, ARRAY_COUNT(array), sizeof(int), ParallelTestTwice, NULL);
+    assert(array[999] == 1998 && array[MAX_PARALLEL_SIZE - 1] == 1998);
+    uintptr_t sum = (uintptr_t)ArrayReduce(array, ARRAY_COUNT(array), sizeof(int), ParallelTestSum, ParallelTestAdd, NULL, NULL);
+    assert(sum == 999ull * 1000 * (MAX_PARALLEL_SIZE / 1000));
+    assert((uintptr_t)ArrayReduce(array, ARRAY_COUNT(array), sizeof(int), ParallelTestSum, NULL, NULL, NULL) == sum);
+    assert((uintptr_t)ArrayReduce(array, 0, sizeof(int), ParallelTestSum, ParallelTestAdd, (void*)5, NULL) == 5);
+    AllocFree(array);
+    printf ("passed!\n");
+
+    /* test3 : fill of array by pattern */
+    printf ("--------test3--------\n");
+    typedef struct { float gain; char name[7]; } ParallelTestItem;
+    ParallelTestItem item = {0.5f, "fill"};
+    size_t counts[] = {1, 2, 3, 341, 342, 1000, 5000, (ARRAY_FILL_THREADS / sizeof(item)) * 3 + 7};
+    for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        ParallelTestItem* items = AllocMemoryUninit(ALLOC_TYPE_NONE, sizeof(item), counts[c] + 1);
+        items[counts[c]].gain = 2.0f;
+        ArrayFill(items, counts[c], sizeof(item), &item);
+        for (size_t i = 0; i < counts[c]; ++i)
+            assert(memcmp(&items[i], &item, sizeof(item)) == 0);
+        assert(items[counts[c]].gain == 2.0f);
+        AllocFree(items);
+    }
+    ArrayFill(NULL, 10, sizeof(item), &item);
+    printf ("passed!\n");
+
+    /* test4 : template of constructors */
+    printf ("--------test4--------\n");
+    const ParallelTestItem ParallelTestItem_c = {1.5f, "init"};
+    ParallelTestItem* created = __create(ParallelTestItem, 3000);
+    assert(ARRAY_COUNT(created) == 3000);
+    assert(created[0].gain == 1.5f && created[2999].gain == 1.5f && strcmp(created[2999].name, "init") == 0);
+    delete(created);
+    assert(created == NULL);
+    assert(__create(ParallelTestItem, 0) == NULL);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all parallel's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,75 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+#ifndef __PARALLEL_H
+#define __PARALLEL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "alloc.h"
+
+#define PARALLEL_MIN_COUNT         512  /* less elements are processed in one thread */
+#define PARALLEL_CHUNKS_PER_THREAD 16   /* threads take chunks while others are busy */
+#define ARRAY_FILL_BLOCK   (4 * 1024)          /* bytes of pattern copied by one memcpy, it stays in L1 */
+#define ARRAY_FILL_THREADS (4 * 1024 * 1024)   /* bigger arrays are filled in threads */
+
+/* process elements [begin, end), worker - number of thread in [0, ParallelGetWorkerCount()) */
+typedef void (*ParallelTask)(void* arg, size_t begin, size_t end, unsigned worker);
+
+/* function for every value */
+typedef void  (*ParallelForEachFunc)(void* value, void* context);
+/* return new value for value */
+typedef void* (*ParallelMapFunc)(void* value, void* context);
+/* add value to accumulator and return new accumulator */
+typedef void* (*ParallelReduceFunc)(void* accumulator, void* value, void* context);
+/* join two accumulators, must not depend on their order */
+typedef void* (*ParallelCombineFunc)(void* a, void* b, void* context);
+
+/** count of elements in array from new(T, n) */
+#define ARRAY_COUNT(array) (AllocGetSize(array) / sizeof(*(array)))
+
+/** count of threads which may run tasks */
+unsigned ParallelGetWorkerCount ();
+/** size of chunk for count elements, 0 - one thread does it faster */
+size_t ParallelGetChunkSize (size_t count);
+/** run task for chunks of [0, count) in threads, every thread takes next free chunk
+    when it is done with previous one. Without __MULTITHREADS all runs in caller thread */
+void ParallelFor (size_t count, size_t chunk, ParallelTask task, void* arg);
+
+/** call func for pointer to every element of array, elements are processed in threads if there are many */
+void ArrayForEach (void* array, size_t count, size_t size, ParallelForEachFunc func, void* context);
+/** copy value of size bytes to every element of array: pattern of values is made by doubling memcpy,
+    then copied by blocks. Big arrays are filled in threads, so pages are first touched by them */
+void ArrayFill (void* array, size_t count, size_t size, const void* value);
+/** reduce pointers to elements of array to one value, starting with initial.
+    In threads every of them starts with initial and results are joined by combine,
+    combine NULL - reduce in one thread */
+void* ArrayReduce (void* array, size_t count, size_t size,
+                   ParallelReduceFunc reduce, ParallelCombineFunc combine, void* initial, void* context);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void ParallelTest();
+#endif // _DEBUG
+
+#endif // __PARALLEL_H
@@ -0,0 +1,211 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ptrscan.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    #define PTRSCAN_X86
+    #include <immintrin.h>
+#endif
+
+typedef size_t (*PtrScanKernel)(void* const* array, size_t count, const void* value);
+
+
+static size_t PtrScanScalar (void* const* array, size_t count, const void* value)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (array[i] == value)
+            return i;
+    }
+
+    return count;
+}
+
+#ifdef PTRSCAN_X86
+/* SSE2 has no compare of 64-bit numbers - both halves must be equal */
+static size_t PtrScanSse2 (void* const* array, size_t count, const void* value)
+{
+    __m128i needle = _mm_set1_epi64x((long long)(uintptr_t)value);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(array + i)),     needle);
+        __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(array + i + 2)), needle);
+        __m128i c = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(array + i + 4)), needle);
+        __m128i d = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(array + i + 6)), needle);
+        a = _mm_and_si128(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+        b = _mm_and_si128(b, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 3, 0, 1)));
+        c = _mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+        d = _mm_and_si128(d, _mm_shuffle_epi32(d, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (_mm_movemask_epi8(any))
+        {
+            unsigned mask = _mm_movemask_pd(_mm_castsi128_pd(a))
+                          | _mm_movemask_pd(_mm_castsi128_pd(b)) << 2
+                          | _mm_movemask_pd(_mm_castsi128_pd(c)) << 4
+                          | _mm_movemask_pd(_mm_castsi128_pd(d)) << 6;
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    size_t rest = PtrScanScalar(array + i, count - i, value);
+    return i + rest;
+}
+
+__attribute__((target("avx2")))
+static size_t PtrScanAvx2 (void* const* array, size_t count, const void* value)
+{
+    __m256i needle = _mm256_set1_epi64x((long long)(uintptr_t)value);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i a = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(array + i)),      needle);
+        __m256i b = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(array + i + 4)),  needle);
+        __m256i c = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(array + i + 8)),  needle);
+        __m256i d = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(array + i + 12)), needle);
+
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if (!_mm256_testz_si256(any, any))
+        {
+            unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(a))
+                          | _mm256_movemask_pd(_mm256_castsi256_pd(b)) << 4
+                          | _mm256_movemask_pd(_mm256_castsi256_pd(c)) << 8
+                          | _mm256_movemask_pd(_mm256_castsi256_pd(d)) << 12;
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    size_t rest = PtrScanSse2(array + i, count - i, value);
+    return i + rest;
+}
+#endif // PTRSCAN_X86
+
+static PtrScanKernel PtrScanChoose (const char** name)
+{
+#ifdef PTRSCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        *name = "avx2";
+        return PtrScanAvx2;
+    }
+
+    /* SSE2 is always there on x86-64 */
+    *name = "sse2";
+    return PtrScanSse2;
+#else
+    *name = "scalar";
+    return PtrScanScalar;
+#endif // PTRSCAN_X86
+}
+
+static PtrScanKernel ptrScanKernel     = NULL;
+static const char*   ptrScanKernelName = "scalar";
+
+static PtrScanKernel PtrScanGet ()
+{
+    /* every thread chooses the same kernel, so race is harmless */
+    PtrScanKernel kernel = __atomic_load_n(&ptrScanKernel, __ATOMIC_ACQUIRE);
+    if (kernel == NULL)
+    {
+        const char* name;
+        kernel = PtrScanChoose(&name);
+        __atomic_store_n(&ptrScanKernelName, name, __ATOMIC_RELAXED);
+        __atomic_store_n(&ptrScanKernel, kernel, __ATOMIC_RELEASE);
+    }
+
+    return kernel;
+}
+
+size_t PtrScanFind (void* const* array, size_t count, const void* value)
+{
+    if (!array)
+        return count;
+
+    return PtrScanGet()(array, count, value);
+}
+
+const char* PtrScanGetKernel ()
+{
+    PtrScanGet();
+
+    return __atomic_load_n(&ptrScanKernelName, __ATOMIC_RELAXED);
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#define MAX_PTRSCAN_SIZE 1000
+
+void PtrScanTest()
+{
+    printf ("Pointer scan's tests started!!!\n");
+
+    void** array = malloc(MAX_PTRSCAN_SIZE * sizeof(void*));
+    for (size_t i = 0; i < MAX_PTRSCAN_SIZE; ++i)
+        array[i] = (void*)(uintptr_t)(i + 1);
+
+    /* test1 : every position and tail of every length with all kernels */
+    printf ("--------test1--------\n");
+    PtrScanKernel kernels[] =
+    {
+        PtrScanScalar,
+#ifdef PTRSCAN_X86
+        PtrScanSse2,
+        PtrScanFind,
+#endif // PTRSCAN_X86
+    };
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); ++k)
+    {
+        for (size_t i = 0; i < 40; ++i)
+        {
+            for (size_t count = 0; count < 40; ++count)
+            {
+                size_t found = kernels[k]((void* const*)array, count, array[i]);
+                assert(found == ((i < count) ? i : count));
+            }
+        }
+        assert(kernels[k]((void* const*)array, MAX_PTRSCAN_SIZE, array[MAX_PTRSCAN_SIZE - 1]) == MAX_PTRSCAN_SIZE - 1);
+        assert(kernels[k]((void* const*)array, MAX_PTRSCAN_SIZE, NULL) == MAX_PTRSCAN_SIZE);
+    }
+    /* same low half, other high half */
+    array[5] = (void*)(((uintptr_t)1 << 40) | 7);
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); ++k)
+        assert(kernels[k]((void* const*)array, MAX_PTRSCAN_SIZE, (void*)(uintptr_t)7) == 6);
+    printf ("kernel : %s\n", PtrScanGetKernel());
+    printf ("passed!\n");
+
+    free(array);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all pointer scan's tests are passed!\n");
+}
+#endif // _DEBUG
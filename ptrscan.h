@@ -0,0 +1,38 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+#ifndef __PTRSCAN_H
+#define __PTRSCAN_H
+
+#include <stddef.h>
+
+/** return position of first value in array of count pointers, count if there is no such value.
+    Kernel for AVX2, SSE2 or plain C is chosen by CPU on first call */
+size_t PtrScanFind (void* const* array, size_t count, const void* value);
+/** name of chosen kernel: "avx2", "sse2" or "scalar" */
+const char* PtrScanGetKernel ();
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void PtrScanTest();
+#endif // _DEBUG
+
+#endif // __PTRSCAN_H
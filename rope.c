@@ -0,0 +1,727 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rope.h"
+#include "alloc.h"
+
+
+#define ROPE_CHECK_VALID                            \
+                if (!rope) return 0;                \
+                unsigned id = *(unsigned*)rope;     \
+                if (id != __ROPE_ID) return 0;
+
+
+/* leaf with text in the same memory */
+static RopeNode* RopeNodeCreateLeaf (const char* chars, size_t length)
+{
+    size_t capacity = (length < ROPE_LEAF_SIZE) ? ROPE_LEAF_SIZE : length;
+
+    RopeNode* leaf = malloc(sizeof(RopeNode) + capacity);
+    if (leaf == NULL)
+        return NULL;
+
+    leaf->length   = length;
+    leaf->depth    = 0;
+    leaf->left     = NULL;
+    leaf->right    = NULL;
+    leaf->chars    = (char*)(leaf + 1);
+    leaf->capacity = capacity;
+
+    memcpy(leaf->chars, chars, length);
+
+    return leaf;
+}
+
+static RopeNode* RopeNodeCreateInner ()
+{
+    return calloc(1, sizeof(RopeNode));
+}
+
+static void RopeNodeDestroy (RopeNode* node)
+{
+    if (node == NULL)
+        return;
+
+    RopeNodeDestroy(node->left);
+    RopeNodeDestroy(node->right);
+    free (node);
+}
+
+/* make node parent of left and right */
+static RopeNode* RopeNodeJoin (RopeNode* node, RopeNode* left, RopeNode* right)
+{
+    node->left   = left;
+    node->right  = right;
+    node->length = left->length + right->length;
+    node->depth  = ((left->depth > right->depth) ? left->depth : right->depth) + 1;
+
+    return node;
+}
+
+/* join with spare node, NULL sides are skipped and spare is freed */
+static RopeNode* RopeNodeJoinSpare (RopeNode* spare, RopeNode* left, RopeNode* right)
+{
+    if (left == NULL || right == NULL)
+    {
+        free (spare);
+        return (left) ? left : right;
+    }
+
+    return RopeNodeJoin(spare, left, right);
+}
+
+/* right side of tree is complete binary tree, leaves of left side are not checked */
+static bool RopeNodeIsFull (RopeNode* node)
+{
+    for (; node->depth > 0; node = node->right)
+    {
+        if (node->left->depth != node->right->depth)
+            return false;
+    }
+
+    return true;
+}
+
+/* add leaf to the right side like binary counter, so depth grows as log of leaves */
+static RopeNode* RopeNodeAppend (RopeNode* node, RopeNode* leaf, RopeNode* spare)
+{
+    if (RopeNodeIsFull(node))
+        return RopeNodeJoin(spare, node, leaf);
+
+    node->right = RopeNodeAppend(node->right, leaf, spare);
+    return RopeNodeJoin(node, node->left, node->right);
+}
+
+/* put chars into leaf with free room, return false if leaf is full */
+static bool RopeNodeInsertInPlace (RopeNode* node, size_t position, const char* chars, size_t length)
+{
+    if (node->depth == 0)
+    {
+        if (node->capacity - node->length < length)
+            return false;
+
+        memmove(node->chars + position + length, node->chars + position, node->length - position);
+        memcpy(node->chars + position, chars, length);
+        node->length += length;
+        return true;
+    }
+
+    size_t leftLength = node->left->length;
+    bool done = (position <= leftLength) ?
+                RopeNodeInsertInPlace(node->left,  position,              chars, length) :
+                RopeNodeInsertInPlace(node->right, position - leftLength, chars, length);
+    if (done)
+        node->length += length;
+
+    return done;
+}
+
+/* cut tree into [0, position) and [position, length), nothing is changed if there is no memory */
+static bool RopeNodeSplit (RopeNode* node, size_t position, RopeNode** left, RopeNode** right)
+{
+    if (node == NULL || position == 0 || position >= node->length)
+    {
+        *left  = (node && position > 0) ? node : NULL;
+        *right = (node && position == 0) ? node : NULL;
+        return true;
+    }
+
+    /* only split of leaf needs memory, it is done before any change */
+    if (node->depth == 0)
+    {
+        RopeNode* tail = RopeNodeCreateLeaf(node->chars + position, node->length - position);
+        if (tail == NULL)
+            return false;
+
+        node->length = position;
+        *left  = node;
+        *right = tail;
+        return true;
+    }
+
+    RopeNode* a;
+    RopeNode* b;
+    size_t leftLength = node->left->length;
+    if (position < leftLength)
+    {
+        if (!RopeNodeSplit(node->left, position, &a, &b))
+            return false;
+
+        *left  = a;
+        *right = RopeNodeJoin(node, b, node->right);
+    }
+    else
+    {
+        if (!RopeNodeSplit(node->right, position - leftLength, &a, &b))
+            return false;
+
+        if (a == NULL)
+        {
+            /* cut is between children */
+            *left  = node->left;
+            *right = b;
+            free (node);
+        }
+        else
+        {
+            *left  = RopeNodeJoin(node, node->left, a);
+            *right = b;
+        }
+    }
+
+    return true;
+}
+
+/* delete chars without memory, return NULL if nothing is left */
+static RopeNode* RopeNodeDelete (RopeNode* node, size_t position, size_t length)
+{
+    if (node->depth == 0)
+    {
+        memmove(node->chars + position, node->chars + position + length, node->length - position - length);
+        node->length -= length;
+        if (node->length > 0)
+            return node;
+
+        free (node);
+        return NULL;
+    }
+
+    size_t leftLength = node->left->length;
+    if (position < leftLength)
+    {
+        size_t count = (length < leftLength - position) ? length : leftLength - position;
+        node->left = RopeNodeDelete(node->left, position, count);
+        length -= count;
+        position = 0;
+    }
+    else
+        position -= leftLength;
+
+    if (length > 0)
+        node->right = RopeNodeDelete(node->right, position, length);
+
+    if (node->left == NULL || node->right == NULL)
+    {
+        RopeNode* child = (node->left) ? node->left : node->right;
+        free (node);
+        return child;
+    }
+
+    return RopeNodeJoin(node, node->left, node->right);
+}
+
+static size_t RopeNodeCountLeaves (RopeNode* node)
+{
+    return (node->depth == 0) ? 1 : RopeNodeCountLeaves(node->left) + RopeNodeCountLeaves(node->right);
+}
+
+/* leaves in order, small neighbours are merged, inner nodes are kept for reuse */
+static void RopeNodeCollect (RopeNode* node, RopeNode** leaves, size_t* leafCount,
+                                             RopeNode** inners, size_t* innerCount)
+{
+    if (node->depth > 0)
+    {
+        RopeNodeCollect(node->left,  leaves, leafCount, inners, innerCount);
+        RopeNodeCollect(node->right, leaves, leafCount, inners, innerCount);
+        inners[(*innerCount)++] = node;
+        return;
+    }
+
+    RopeNode* last = (*leafCount) ? leaves[*leafCount - 1] : NULL;
+    if (last && last->capacity - last->length >= node->length)
+    {
+        memcpy(last->chars + last->length, node->chars, node->length);
+        last->length += node->length;
+        free (node);
+        return;
+    }
+
+    leaves[(*leafCount)++] = node;
+}
+
+static RopeNode* RopeNodeBuild (RopeNode** leaves, size_t count, RopeNode** inners, size_t* innerCount)
+{
+    if (count == 1)
+        return leaves[0];
+
+    size_t half = count / 2;
+    RopeNode* left  = RopeNodeBuild(leaves,        half,         inners, innerCount);
+    RopeNode* right = RopeNodeBuild(leaves + half, count - half, inners, innerCount);
+
+    return RopeNodeJoin(inners[--(*innerCount)], left, right);
+}
+
+/* rebuild tree with depth log2 of leaves, tree is only kept deep if there is no memory */
+static void RopeBalance (Rope* rope)
+{
+    if (rope->root == NULL || rope->root->depth <= ROPE_MAX_DEPTH)
+        return;
+
+    size_t count = RopeNodeCountLeaves(rope->root);
+    RopeNode** leaves = malloc(count * sizeof(RopeNode*));
+    RopeNode** inners = malloc(count * sizeof(RopeNode*));
+    if (leaves == NULL || inners == NULL)
+    {
+        free (leaves);
+        free (inners);
+        return;
+    }
+
+    size_t leafCount  = 0;
+    size_t innerCount = 0;
+    RopeNodeCollect(rope->root, leaves, &leafCount, inners, &innerCount);
+
+    /* merged leaves left extra inner nodes */
+    while (innerCount > leafCount - 1)
+        free (inners[--innerCount]);
+
+    rope->root = RopeNodeBuild(leaves, leafCount, inners, &innerCount);
+
+    free (leaves);
+    free (inners);
+}
+
+static size_t RopeNodeCopy (RopeNode* node, size_t position, size_t length, char* buf)
+{
+    if (node->depth == 0)
+    {
+        memcpy(buf, node->chars + position, length);
+        return length;
+    }
+
+    size_t copied     = 0;
+    size_t leftLength = node->left->length;
+    if (position < leftLength)
+    {
+        size_t count = (length < leftLength - position) ? length : leftLength - position;
+        copied = RopeNodeCopy(node->left, position, count, buf);
+        position = 0;
+    }
+    else
+        position -= leftLength;
+
+    if (length > copied)
+        copied += RopeNodeCopy(node->right, position, length - copied, buf + copied);
+
+    return copied;
+}
+
+
+void RopeInit(void* mem)
+{
+    if (mem)
+    {
+        Rope* rope = mem;
+
+        /* already initialized? */
+        if (rope->__id == __ROPE_ID)
+        {
+            RopeClear(rope);
+        }
+        else
+        {
+            memset(rope, 0, sizeof(Rope));
+
+            rope->__id   = __ROPE_ID;
+
+            rope->append = &RopeAppend;
+            rope->size   = &RopeGetLength;
+            rope->clear  = &RopeClear;
+        }
+    }
+}
+
+Rope* RopeCreate()
+{
+    Rope* rope = AllocMemory(ALLOC_TYPE_ROPE, sizeof(Rope), 1);
+    if (rope == NULL)
+        return NULL;
+
+    rope->__id = 0;
+    RopeInit(rope);
+    rope->__alloc = true;
+
+    return rope;
+}
+
+void RopeClear (Rope* rope)
+{
+    ROPE_CHECK_VALID
+
+    RopeNodeDestroy(rope->root);
+    rope->root = NULL;
+}
+
+/* release tree of rope, called by delete() */
+static void RopeFinalize (void* object)
+{
+    Rope* rope = object;
+
+    RopeClear(rope);
+
+    rope->__id = 0;
+}
+
+static void __attribute__((constructor)) RopeRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_ROPE, RopeFinalize);
+}
+
+void RopeDestroy (Rope** rope)
+{
+    if (!rope || !(*rope))
+        return;
+
+    /* memory of RopeInit is released by free() */
+    bool alloc = (*rope)->__alloc;
+    RopeFinalize(*rope);
+
+    if (alloc)
+        AllocFree(*rope);
+    else
+        free (*rope);
+    *rope = NULL;
+}
+
+bool RopeAppendChars (Rope* rope, const char* chars, size_t length)
+{
+    ROPE_CHECK_VALID
+
+    if (length == 0)
+        return true;
+    if (chars == NULL)
+        return false;
+
+    /* last leaf has room */
+    if (rope->root && RopeNodeInsertInPlace(rope->root, rope->root->length, chars, length))
+        return true;
+
+    RopeNode* leaf = RopeNodeCreateLeaf(chars, length);
+    if (leaf == NULL)
+        return false;
+
+    if (rope->root == NULL)
+    {
+        rope->root = leaf;
+        return true;
+    }
+
+    RopeNode* spare = RopeNodeCreateInner();
+    if (spare == NULL)
+    {
+        free (leaf);
+        return false;
+    }
+
+    rope->root = RopeNodeAppend(rope->root, leaf, spare);
+    RopeBalance(rope);
+
+    return true;
+}
+
+bool RopeAppend (Rope* rope, const char* chars)
+{
+    ROPE_CHECK_VALID
+
+    if (chars == NULL)
+        return true;
+
+    return RopeAppendChars(rope, chars, strlen(chars));
+}
+
+bool RopeInsert (Rope* rope, size_t position, const char* chars, size_t length)
+{
+    ROPE_CHECK_VALID
+
+    size_t size = RopeGetLength(rope);
+    if (position > size)
+        return false;
+    if (position == size)
+        return RopeAppendChars(rope, chars, length);
+    if (length == 0)
+        return true;
+    if (chars == NULL)
+        return false;
+
+    /* leaf has room, chars are moved only inside of it */
+    if (RopeNodeInsertInPlace(rope->root, position, chars, length))
+        return true;
+
+    RopeNode* leaf   = RopeNodeCreateLeaf(chars, length);
+    RopeNode* spare0 = RopeNodeCreateInner();
+    RopeNode* spare1 = RopeNodeCreateInner();
+    RopeNode* left;
+    RopeNode* right;
+    if (leaf == NULL || spare0 == NULL || spare1 == NULL ||
+        !RopeNodeSplit(rope->root, position, &left, &right))
+    {
+        free (leaf);
+        free (spare0);
+        free (spare1);
+        return false;
+    }
+
+    rope->root = RopeNodeJoinSpare(spare1, RopeNodeJoinSpare(spare0, left, leaf), right);
+    RopeBalance(rope);
+
+    return true;
+}
+
+bool RopeConcat (Rope* rope, Rope* other)
+{
+    ROPE_CHECK_VALID
+
+    if (other == rope)
+        return false;
+    if (other == NULL || other->__id != __ROPE_ID || other->root == NULL)
+        return true;
+
+    if (rope->root == NULL)
+    {
+        rope->root  = other->root;
+        other->root = NULL;
+        return true;
+    }
+
+    RopeNode* spare = RopeNodeCreateInner();
+    if (spare == NULL)
+        return false;
+
+    rope->root  = RopeNodeJoin(spare, rope->root, other->root);
+    other->root = NULL;
+    RopeBalance(rope);
+
+    return true;
+}
+
+bool RopeDelete (Rope* rope, size_t position, size_t length)
+{
+    ROPE_CHECK_VALID
+
+    size_t size = RopeGetLength(rope);
+    if (position >= size)
+        return (position == size);
+    if (length > size - position)
+        length = size - position;
+    if (length == 0)
+        return true;
+
+    rope->root = RopeNodeDelete(rope->root, position, length);
+
+    return true;
+}
+
+size_t RopeGetLength (Rope* rope)
+{
+    ROPE_CHECK_VALID
+
+    return (rope->root) ? rope->root->length : 0;
+}
+
+char RopeGetChar (Rope* rope, size_t position)
+{
+    ROPE_CHECK_VALID
+
+    RopeNode* node = rope->root;
+    if (node == NULL || position >= node->length)
+        return '\0';
+
+    while (node->depth > 0)
+    {
+        if (position < node->left->length)
+            node = node->left;
+        else
+        {
+            position -= node->left->length;
+            node = node->right;
+        }
+    }
+
+    return node->chars[position];
+}
+
+size_t RopeCopyChars (Rope* rope, size_t position, size_t length, char* buf)
+{
+    ROPE_CHECK_VALID
+
+    size_t size = RopeGetLength(rope);
+    if (buf == NULL || position >= size)
+        return 0;
+    if (length > size - position)
+        length = size - position;
+    if (length == 0)
+        return 0;
+
+    return RopeNodeCopy(rope->root, position, length, buf);
+}
+
+char* RopeFlatten (Rope* rope)
+{
+    ROPE_CHECK_VALID
+
+    size_t size = RopeGetLength(rope);
+    char* text = malloc(size + 1);
+    if (text == NULL)
+        return NULL;
+
+    RopeCopyChars(rope, 0, size, text);
+    text[size] = '\0';
+
+    return text;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#define MAX_ROPE_TEXT 200000
+
+/* same change on rope and plain text, then compare them */
+static void RopeTestCompare (Rope* rope, const char* text, size_t length)
+{
+    assert(RopeGetLength(rope) == length);
+    char* flat = RopeFlatten(rope);
+    assert(memcmp(flat, text, length) == 0 && flat[length] == '\0');
+    free(flat);
+}
+
+void RopeTest()
+{
+    printf ("Rope's tests started!!!\n");
+
+    /* test1 : append, insert, delete of short text */
+    printf ("--------test1--------\n");
+    Rope* rope = RopeCreate();
+    assert(RopeGetLength(rope) == 0);
+    assert(RopeAppend(rope, "hello world"));
+    assert(RopeInsert(rope, 5, ",", 1));
+    assert(RopeInsert(rope, 0, ">> ", 3));
+    assert(RopeInsert(rope, RopeGetLength(rope), "!", 1));
+    RopeTestCompare(rope, ">> hello, world!", 16);
+    assert(RopeGetChar(rope, 3) == 'h');
+    assert(RopeGetChar(rope, 100) == '\0');
+    assert(RopeDelete(rope, 0, 3));
+    assert(RopeDelete(rope, 5, 100));
+    RopeTestCompare(rope, "hello", 5);
+    assert(RopeDelete(rope, 0, 5));
+    assert(rope->root == NULL);
+    assert(!RopeInsert(rope, 1, "x", 1));
+    printf ("passed!\n");
+
+    /* test2 : random changes of long text against array */
+    printf ("--------test2--------\n");
+    char* text  = malloc(MAX_ROPE_TEXT + ROPE_LEAF_SIZE * 4);
+    char* piece = malloc(ROPE_LEAF_SIZE * 3);
+    size_t length = 0;
+    uint32_t seed = 2463534242u;
+    for (unsigned step = 0; step < 3000; ++step)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        size_t count = (seed >> 8) % ((seed & 1) ? 16 : ROPE_LEAF_SIZE * 3);
+        size_t position = (length) ? (seed >> 4) % (length + 1) : 0;
+        for (size_t i = 0; i < count; ++i)
+            piece[i] = 'a' + (step + i) % 26;
+
+        if ((seed >> 28) < 6 || length + count > MAX_ROPE_TEXT)
+        {
+            /* delete */
+            size_t cut = (length - position < count) ? length - position : count;
+            assert(RopeDelete(rope, position, count));
+            memmove(text + position, text + position + cut, length - position - cut);
+            length -= cut;
+        }
+        else
+        {
+            assert(RopeInsert(rope, position, piece, count));
+            memmove(text + position + count, text + position, length - position);
+            memcpy(text + position, piece, count);
+            length += count;
+        }
+
+        assert(RopeGetLength(rope) == length);
+        if (length)
+            assert(RopeGetChar(rope, position % length) == text[position % length]);
+        if (rope->root)
+            assert(rope->root->depth <= ROPE_MAX_DEPTH + 2);
+        if (step % 100 == 0)
+            RopeTestCompare(rope, text, length);
+    }
+    RopeTestCompare(rope, text, length);
+
+    char part[100];
+    if (length > 150)
+    {
+        assert(RopeCopyChars(rope, 50, 100, part) == 100);
+        assert(memcmp(part, text + 50, 100) == 0);
+    }
+    printf ("passed!\n");
+
+    /* test3 : many appends stay balanced, concatenation moves text */
+    printf ("--------test3--------\n");
+    RopeClear(rope);
+    Rope* other = RopeCreate();
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        assert(RopeAppendChars(rope, piece, ROPE_LEAF_SIZE));
+        assert(RopeAppendChars(other, "xy", 2));
+    }
+    assert(RopeGetLength(rope) == 5000 * ROPE_LEAF_SIZE);
+    assert(rope->root->depth <= 14);
+    assert(RopeConcat(rope, other));
+    assert(RopeGetLength(other) == 0);
+    assert(RopeGetLength(rope) == 5000 * ROPE_LEAF_SIZE + 10000);
+    assert(RopeGetChar(rope, 5000 * ROPE_LEAF_SIZE) == 'x');
+    assert(RopeGetChar(rope, 5000 * ROPE_LEAF_SIZE + 9999) == 'y');
+    assert(RopeGetChar(rope, 5 * ROPE_LEAF_SIZE + 1) == piece[1]);
+    RopeDestroy(&other);
+    printf ("passed!\n");
+
+    /* test4 : inserts at the front make tree deep, it is rebuilt */
+    printf ("--------test4--------\n");
+    RopeClear(rope);
+    for (unsigned i = 0; i < 200; ++i)
+    {
+        memset(piece, 'a' + i % 26, ROPE_LEAF_SIZE);
+        assert(RopeInsert(rope, 0, piece, ROPE_LEAF_SIZE));
+        assert(rope->root->depth <= ROPE_MAX_DEPTH);
+    }
+    for (unsigned i = 0; i < 200; ++i)
+        assert(RopeGetChar(rope, (size_t)i * ROPE_LEAF_SIZE + 7) == (char)('a' + (199 - i) % 26));
+    AllocDelete((void**)&rope);
+    assert(rope == NULL);
+    free(text);
+    free(piece);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all rope's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,95 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#ifndef __ROPE_H
+#define __ROPE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define __ROPE_ID 1701867346    /* 'R' 'o' 'p' 'e' */
+
+#define ROPE_LEAF_SIZE 1024      /* bytes of new leaf, small appends and inserts fill it */
+#define ROPE_MAX_DEPTH 48        /* deeper tree is rebuilt balanced */
+
+/* node of rope, leaf keeps text, inner node joins two ropes */
+typedef struct RopeNode_tag
+{
+    size_t   length;                /* chars of all leaves below */
+    unsigned depth;                 /* 0 for leaf */
+
+    struct RopeNode_tag* left;      /* inner node */
+    struct RopeNode_tag* right;
+
+    char*  chars;                   /* leaf, without terminating zero */
+    size_t capacity;
+} RopeNode;
+
+/* text as tree of pieces: insert, delete and concatenation don't move whole text */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of RopeCreate from AllocMemory, else of malloc */
+
+    RopeNode* root;
+
+    bool   (*append)(void* this, const char* chars);
+    size_t (*size)  (void* this);
+    void   (*clear) (void* this);
+} Rope;
+
+/** init memory as rope */
+void RopeInit(void* mem);
+/** create empty rope and return pointer to rope */
+Rope* RopeCreate ();
+/** delete text of rope */
+void RopeClear (Rope* rope);
+/** clear and destroy rope */
+void RopeDestroy (Rope** rope);
+
+/** add chars to end of rope, return false if not */
+bool RopeAppend (Rope* rope, const char* chars);
+/** add length chars to end of rope, return false if not */
+bool RopeAppendChars (Rope* rope, const char* chars, size_t length);
+/** insert length chars before position (length of rope - to the end), return false if not */
+bool RopeInsert (Rope* rope, size_t position, const char* chars, size_t length);
+/** move all text of other to the end of rope in O(log n), other becomes empty */
+bool RopeConcat (Rope* rope, Rope* other);
+/** delete length chars from position, return false if not */
+bool RopeDelete (Rope* rope, size_t position, size_t length);
+
+/* GETTERS */
+/** count of chars in rope */
+size_t RopeGetLength (Rope* rope);
+/** char by position, '\0' for wrong position */
+char RopeGetChar (Rope* rope, size_t position);
+/** copy up to length chars from position to buf, return count of copied chars */
+size_t RopeCopyChars (Rope* rope, size_t position, size_t length, char* buf);
+/** whole text with terminating zero in new memory, caller frees it with free() */
+char* RopeFlatten (Rope* rope);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void RopeTest();
+#endif // _DEBUG
+
+#endif // __ROPE_H
@@ -0,0 +1,868 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#include "str.h"
+#include "alloc.h"
+
+
+/* vswprintf does not tell needed size, wide text grows until it fits or this room is reached */
+#define WSTRING_FORMAT_LIMIT (1u << 24)
+
+/* formatted text of this size is printed on stack, longer one in temporary memory */
+#define STRING_FORMAT_STACK 256
+
+#define STRING_CHECK_VALID                          \
+                if (!str) return 0;                 \
+                unsigned id = *(unsigned*)str;      \
+                if (id != __STRING_ID) return 0;
+
+/* getters read immutable strings too */
+#define STRING_CHECK_READ                           \
+                if (!str) return 0;                 \
+                unsigned id = *(unsigned*)str;      \
+                if (id != __STRING_ID && id != __STRING_CONST_ID) return 0;
+
+#define WSTRING_CHECK_VALID                         \
+                if (!str) return 0;                 \
+                unsigned id = *(unsigned*)str;      \
+                if (id != __WSTRING_ID) return 0;
+
+
+/* chars which fit inside of buffer without heap */
+static inline unsigned StringBufferLocalCapacity (size_t charSize)
+{
+    return STRING_INLINE_SIZE / charSize - 1;
+}
+
+static inline void* StringBufferData (StringBuffer* buffer, size_t charSize)
+{
+    return (buffer->capacity <= StringBufferLocalCapacity(charSize)) ? buffer->local : buffer->heap;
+}
+
+static void StringBufferInit (StringBuffer* buffer, size_t charSize)
+{
+    memset(buffer, 0, sizeof(StringBuffer));
+    buffer->capacity = StringBufferLocalCapacity(charSize);
+}
+
+static void StringBufferRelease (StringBuffer* buffer, size_t charSize)
+{
+    if (buffer->capacity > StringBufferLocalCapacity(charSize))
+        free (buffer->heap);
+
+    StringBufferInit(buffer, charSize);
+}
+
+/* set room of buffer to capacity chars, capacity is not less than length */
+static bool StringBufferResize (StringBuffer* buffer, size_t charSize, unsigned capacity)
+{
+    unsigned localCapacity = StringBufferLocalCapacity(charSize);
+    bool     local         = (buffer->capacity <= localCapacity);
+
+    /* short text goes back inside */
+    if (capacity <= localCapacity)
+    {
+        if (!local)
+        {
+            void* heap = buffer->heap;
+            memcpy(buffer->local, heap, (buffer->length + 1) * charSize);
+            free (heap);
+            buffer->capacity = localCapacity;
+        }
+        return true;
+    }
+
+    void* heap;
+    if (local)
+    {
+        heap = malloc(((size_t)capacity + 1) * charSize);
+        if (heap == NULL)
+            return false;
+        memcpy(heap, buffer->local, (buffer->length + 1) * charSize);
+    }
+    else
+    {
+        heap = realloc(buffer->heap, ((size_t)capacity + 1) * charSize);
+        if (heap == NULL)
+            return false;
+    }
+
+    buffer->heap     = heap;
+    buffer->capacity = capacity;
+
+    return true;
+}
+
+/* make room for length chars, grow twice so append takes amortized O(1) */
+static bool StringBufferGrow (StringBuffer* buffer, size_t charSize, unsigned length)
+{
+    if (length <= buffer->capacity)
+        return true;
+
+    unsigned capacity = (buffer->capacity > UINT_MAX / 2) ? UINT_MAX - 1 : buffer->capacity * 2;
+    if (capacity < length)
+        capacity = length;
+
+    return StringBufferResize(buffer, charSize, capacity);
+}
+
+static void StringBufferSetLength (StringBuffer* buffer, size_t charSize, unsigned length)
+{
+    buffer->length = length;
+    memset((char*)StringBufferData(buffer, charSize) + (size_t)length * charSize, 0, charSize);
+}
+
+static bool StringBufferAppend (StringBuffer* buffer, size_t charSize, const void* chars, unsigned length)
+{
+    if (length == 0)
+        return true;
+    if (length >= UINT_MAX - buffer->length)
+        return false;
+
+    /* chars may be part of this string and move on grow */
+    const char* data   = StringBufferData(buffer, charSize);
+    size_t      offset = (const char*)chars - data;
+    bool        inside = ((const char*)chars >= data &&
+                          (const char*)chars <  data + ((size_t)buffer->length + 1) * charSize);
+
+    if (!StringBufferGrow(buffer, charSize, buffer->length + length))
+        return false;
+
+    data = StringBufferData(buffer, charSize);
+    if (inside)
+        chars = data + offset;
+
+    memcpy((char*)data + (size_t)buffer->length * charSize, chars, (size_t)length * charSize);
+    StringBufferSetLength(buffer, charSize, buffer->length + length);
+
+    return true;
+}
+
+static bool StringBufferShrinkToFit (StringBuffer* buffer, size_t charSize)
+{
+    if (buffer->capacity <= StringBufferLocalCapacity(charSize) || buffer->length == buffer->capacity)
+        return true;
+
+    return StringBufferResize(buffer, charSize, buffer->length);
+}
+
+
+
+void StringInit(void* mem)
+{
+    if (mem)
+    {
+        String* str = mem;
+
+        /* already initialized? */
+        if (str->__id == __STRING_ID)
+        {
+            StringClear(str);
+        }
+        else
+        {
+            memset(str, 0, sizeof(String));
+
+            str->__id      = __STRING_ID;
+            StringBufferInit(&str->buffer, sizeof(char));
+
+            str->c_str     = &StringGetChars;
+            str->size      = &StringGetLength;
+            str->append    = &StringAppend;
+            str->push_back = &StringAddChar;
+            str->empty     = &StringIsEmpty;
+            str->clear     = &StringClear;
+            str->reserve   = &StringReserve;
+        }
+    }
+}
+
+String* StringCreate()
+{
+    String* str = AllocMemory(ALLOC_TYPE_STRING, sizeof(String), 1);
+    if (str == NULL)
+        return NULL;
+
+    str->__id = 0;
+    StringInit(str);
+    str->__alloc = true;
+
+    return str;
+}
+
+String* StringCreateFrom (const char* chars)
+{
+    String* str = StringCreate();
+    if (str == NULL)
+        return NULL;
+
+    if (!StringAssign(str, chars))
+        StringDestroy(&str);
+
+    return str;
+}
+
+void StringClear (String* str)
+{
+    STRING_CHECK_VALID
+
+    StringBufferSetLength(&str->buffer, sizeof(char), 0);
+}
+
+/* release heap of string, called by delete() */
+static void StringFinalize (void* object)
+{
+    String* str = object;
+
+    StringBufferRelease(&str->buffer, sizeof(char));
+
+    str->__id = 0;
+}
+
+static void __attribute__((constructor)) StringRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_STRING, StringFinalize);
+}
+
+void StringDestroy (String** str)
+{
+    if (!str || !(*str))
+        return;
+
+    /* immutable string belongs to its owner */
+    if (StringIsConst(*str))
+    {
+        *str = NULL;
+        return;
+    }
+
+    /* memory of StringInit is released by free() */
+    bool alloc = (*str)->__alloc;
+    StringFinalize(*str);
+
+    if (alloc)
+        AllocFree(*str);
+    else
+        free (*str);
+    *str = NULL;
+}
+
+bool StringReserve (String* str, unsigned capacity)
+{
+    STRING_CHECK_VALID
+
+    if (capacity <= str->buffer.capacity)
+        return true;
+
+    return StringBufferResize(&str->buffer, sizeof(char), capacity);
+}
+
+bool StringShrinkToFit (String* str)
+{
+    STRING_CHECK_VALID
+
+    return StringBufferShrinkToFit(&str->buffer, sizeof(char));
+}
+
+bool StringAssign (String* str, const char* chars)
+{
+    STRING_CHECK_VALID
+
+    if (chars == NULL)
+        chars = "";
+
+    /* chars may be tail of this string */
+    const char* data = StringGetChars(str);
+    if (chars > data && chars <= data + str->buffer.length)
+    {
+        unsigned length = strlen(chars);
+        memmove((char*)data, chars, length);
+        StringBufferSetLength(&str->buffer, sizeof(char), length);
+        return true;
+    }
+    if (chars == data)
+        return true;
+
+    StringBufferSetLength(&str->buffer, sizeof(char), 0);
+    return StringAppend(str, chars);
+}
+
+bool StringAppend (String* str, const char* chars)
+{
+    STRING_CHECK_VALID
+
+    if (chars == NULL)
+        return true;
+
+    size_t length = strlen(chars);
+    if (length > UINT_MAX)
+        return false;
+
+    return StringBufferAppend(&str->buffer, sizeof(char), chars, length);
+}
+
+bool StringAppendChars (String* str, const char* chars, unsigned length)
+{
+    STRING_CHECK_VALID
+
+    if (chars == NULL)
+        return (length == 0);
+
+    return StringBufferAppend(&str->buffer, sizeof(char), chars, length);
+}
+
+bool StringAddChar (String* str, char c)
+{
+    STRING_CHECK_VALID
+
+    return StringBufferAppend(&str->buffer, sizeof(char), &c, 1);
+}
+
+/* print text to buf, or to malloc memory if it is longer, return NULL if not */
+static char* StringPrintV (char* buf, size_t size, int* length, const char* format, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+    *length = vsnprintf(buf, size, format, copy);
+    va_end(copy);
+
+    if (*length < 0)
+        return NULL;
+    if ((size_t)*length < size)
+        return buf;
+
+    char* text = malloc((size_t)*length + 1);
+    if (text)
+        vsnprintf(text, (size_t)*length + 1, format, args);
+
+    return text;
+}
+
+/* arguments may point into the string, so text is printed aside and then copied */
+static bool StringFormatV (String* str, bool replace, const char* format, va_list args)
+{
+    if (format == NULL)
+        return false;
+
+    char buf[STRING_FORMAT_STACK];
+    int  length = 0;
+    char* text = StringPrintV(buf, sizeof(buf), &length, format, args);
+    if (text == NULL)
+        return false;
+
+    if (replace)
+        StringBufferSetLength(&str->buffer, sizeof(char), 0);
+    bool result = StringBufferAppend(&str->buffer, sizeof(char), text, length);
+
+    if (text != buf)
+        free (text);
+
+    return result;
+}
+
+bool StringAppendFormatV (String* str, const char* format, va_list args)
+{
+    STRING_CHECK_VALID
+
+    return StringFormatV(str, false, format, args);
+}
+
+bool StringAppendFormat (String* str, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    bool result = StringAppendFormatV(str, format, args);
+    va_end(args);
+
+    return result;
+}
+
+bool StringFormat (String* str, const char* format, ...)
+{
+    STRING_CHECK_VALID
+
+    va_list args;
+    va_start(args, format);
+    bool result = StringFormatV(str, true, format, args);
+    va_end(args);
+
+    return result;
+}
+
+void StringTruncate (String* str, unsigned length)
+{
+    STRING_CHECK_VALID
+
+    if (length < str->buffer.length)
+        StringBufferSetLength(&str->buffer, sizeof(char), length);
+}
+
+const char* StringGetChars (String* str)
+{
+    STRING_CHECK_READ
+
+    return StringBufferData(&str->buffer, sizeof(char));
+}
+
+unsigned StringGetLength (String* str)
+{
+    STRING_CHECK_READ
+
+    return str->buffer.length;
+}
+
+bool StringIsEmpty (String* str)
+{
+    STRING_CHECK_READ
+
+    return (str->buffer.length == 0);
+}
+
+int StringCompare (String* str, const char* chars)
+{
+    STRING_CHECK_READ
+
+    return strcmp(StringGetChars(str), (chars) ? chars : "");
+}
+
+String* StringInitConst (void* mem, const char* chars, unsigned length)
+{
+    if (!mem || !chars)
+        return NULL;
+
+    String* str = mem;
+    str->__id = 0;
+    StringInit(str);
+
+    /* chars are kept right after string, inside if they fit */
+    if (length > StringBufferLocalCapacity(sizeof(char)))
+    {
+        str->buffer.heap     = str + 1;
+        str->buffer.capacity = length;
+    }
+    memcpy(StringBufferData(&str->buffer, sizeof(char)), chars, length);
+    StringBufferSetLength(&str->buffer, sizeof(char), length);
+
+    str->__id = __STRING_CONST_ID;
+
+    return str;
+}
+
+bool StringIsConst (String* str)
+{
+    return (str && str->__id == __STRING_CONST_ID);
+}
+
+uint64_t StringHashChars (const char* chars, size_t length)
+{
+    /* 8 bytes per multiply, tail is read as one short word */
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ (length * 0xC2B2AE3D27D4EB4Full);
+    for (; length >= 8; chars += 8, length -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, chars, 8);
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, chars, length);
+    hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 29;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+
+
+void WStringInit(void* mem)
+{
+    if (mem)
+    {
+        WString* str = mem;
+
+        /* already initialized? */
+        if (str->__id == __WSTRING_ID)
+        {
+            WStringClear(str);
+        }
+        else
+        {
+            memset(str, 0, sizeof(WString));
+
+            str->__id      = __WSTRING_ID;
+            StringBufferInit(&str->buffer, sizeof(wchar_t));
+
+            str->c_str     = &WStringGetChars;
+            str->size      = &WStringGetLength;
+            str->append    = &WStringAppend;
+            str->push_back = &WStringAddChar;
+            str->empty     = &WStringIsEmpty;
+            str->clear     = &WStringClear;
+            str->reserve   = &WStringReserve;
+        }
+    }
+}
+
+WString* WStringCreate()
+{
+    WString* str = AllocMemory(ALLOC_TYPE_WSTRING, sizeof(WString), 1);
+    if (str == NULL)
+        return NULL;
+
+    str->__id = 0;
+    WStringInit(str);
+    str->__alloc = true;
+
+    return str;
+}
+
+WString* WStringCreateFrom (const wchar_t* chars)
+{
+    WString* str = WStringCreate();
+    if (str == NULL)
+        return NULL;
+
+    if (!WStringAssign(str, chars))
+        WStringDestroy(&str);
+
+    return str;
+}
+
+void WStringClear (WString* str)
+{
+    WSTRING_CHECK_VALID
+
+    StringBufferSetLength(&str->buffer, sizeof(wchar_t), 0);
+}
+
+/* release heap of wide string, called by delete() */
+static void WStringFinalize (void* object)
+{
+    WString* str = object;
+
+    StringBufferRelease(&str->buffer, sizeof(wchar_t));
+
+    str->__id = 0;
+}
+
+static void __attribute__((constructor)) WStringRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_WSTRING, WStringFinalize);
+}
+
+void WStringDestroy (WString** str)
+{
+    if (!str || !(*str))
+        return;
+
+    /* memory of WStringInit is released by free() */
+    bool alloc = (*str)->__alloc;
+    WStringFinalize(*str);
+
+    if (alloc)
+        AllocFree(*str);
+    else
+        free (*str);
+    *str = NULL;
+}
+
+bool WStringReserve (WString* str, unsigned capacity)
+{
+    WSTRING_CHECK_VALID
+
+    if (capacity <= str->buffer.capacity)
+        return true;
+
+    return StringBufferResize(&str->buffer, sizeof(wchar_t), capacity);
+}
+
+bool WStringShrinkToFit (WString* str)
+{
+    WSTRING_CHECK_VALID
+
+    return StringBufferShrinkToFit(&str->buffer, sizeof(wchar_t));
+}
+
+bool WStringAssign (WString* str, const wchar_t* chars)
+{
+    WSTRING_CHECK_VALID
+
+    if (chars == NULL)
+        chars = L"";
+
+    /* chars may be tail of this string */
+    const wchar_t* data = WStringGetChars(str);
+    if (chars > data && chars <= data + str->buffer.length)
+    {
+        unsigned length = wcslen(chars);
+        memmove((wchar_t*)data, chars, length * sizeof(wchar_t));
+        StringBufferSetLength(&str->buffer, sizeof(wchar_t), length);
+        return true;
+    }
+    if (chars == data)
+        return true;
+
+    StringBufferSetLength(&str->buffer, sizeof(wchar_t), 0);
+    return WStringAppend(str, chars);
+}
+
+bool WStringAppend (WString* str, const wchar_t* chars)
+{
+    WSTRING_CHECK_VALID
+
+    if (chars == NULL)
+        return true;
+
+    size_t length = wcslen(chars);
+    if (length > UINT_MAX)
+        return false;
+
+    return StringBufferAppend(&str->buffer, sizeof(wchar_t), chars, length);
+}
+
+bool WStringAppendChars (WString* str, const wchar_t* chars, unsigned length)
+{
+    WSTRING_CHECK_VALID
+
+    if (chars == NULL)
+        return (length == 0);
+
+    return StringBufferAppend(&str->buffer, sizeof(wchar_t), chars, length);
+}
+
+bool WStringAddChar (WString* str, wchar_t c)
+{
+    WSTRING_CHECK_VALID
+
+    return StringBufferAppend(&str->buffer, sizeof(wchar_t), &c, 1);
+}
+
+/* same as StringFormatV, printed text grows twice until it fits */
+static bool WStringFormatV (WString* str, bool replace, const wchar_t* format, va_list args)
+{
+    if (format == NULL)
+        return false;
+
+    wchar_t  buf[STRING_FORMAT_STACK];
+    wchar_t* text = buf;
+    size_t   size = STRING_FORMAT_STACK;
+    int      length;
+    for (;;)
+    {
+        va_list copy;
+        va_copy(copy, args);
+        length = vswprintf(text, size, format, copy);
+        va_end(copy);
+
+        if (length >= 0 && (size_t)length < size)
+            break;
+
+        if (text != buf)
+            free (text);
+        size *= 2;
+        text = (size <= WSTRING_FORMAT_LIMIT) ? malloc(size * sizeof(wchar_t)) : NULL;
+        if (text == NULL)
+            return false;
+    }
+
+    if (replace)
+        StringBufferSetLength(&str->buffer, sizeof(wchar_t), 0);
+    bool result = StringBufferAppend(&str->buffer, sizeof(wchar_t), text, length);
+
+    if (text != buf)
+        free (text);
+
+    return result;
+}
+
+bool WStringAppendFormat (WString* str, const wchar_t* format, ...)
+{
+    WSTRING_CHECK_VALID
+
+    va_list args;
+    va_start(args, format);
+    bool result = WStringFormatV(str, false, format, args);
+    va_end(args);
+
+    return result;
+}
+
+bool WStringFormat (WString* str, const wchar_t* format, ...)
+{
+    WSTRING_CHECK_VALID
+
+    va_list args;
+    va_start(args, format);
+    bool result = WStringFormatV(str, true, format, args);
+    va_end(args);
+
+    return result;
+}
+
+void WStringTruncate (WString* str, unsigned length)
+{
+    WSTRING_CHECK_VALID
+
+    if (length < str->buffer.length)
+        StringBufferSetLength(&str->buffer, sizeof(wchar_t), length);
+}
+
+const wchar_t* WStringGetChars (WString* str)
+{
+    WSTRING_CHECK_VALID
+
+    return StringBufferData(&str->buffer, sizeof(wchar_t));
+}
+
+unsigned WStringGetLength (WString* str)
+{
+    WSTRING_CHECK_VALID
+
+    return str->buffer.length;
+}
+
+bool WStringIsEmpty (WString* str)
+{
+    WSTRING_CHECK_VALID
+
+    return (str->buffer.length == 0);
+}
+
+int WStringCompare (WString* str, const wchar_t* chars)
+{
+    WSTRING_CHECK_VALID
+
+    return wcscmp(WStringGetChars(str), (chars) ? chars : L"");
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+void StringTest()
+{
+    printf ("String's tests started!!!\n");
+
+    /* test1 : short string stays inside */
+    printf ("--------test1--------\n");
+    String* str = StringCreate();
+    assert(StringIsEmpty(str));
+    assert(StringGetChars(str)[0] == '\0');
+    assert(StringAssign(str, "hello"));
+    assert(StringGetLength(str) == 5);
+    assert(StringGetChars(str) == str->buffer.local);
+    assert(StringAddChar(str, ','));
+    assert(StringAppend(str, " world"));
+    assert(StringCompare(str, "hello, world") == 0);
+    assert(StringGetChars(str) == str->buffer.local);
+    assert(sizeof(String) < 128);
+    printf ("passed!\n");
+
+    /* test2 : growth to heap, append of itself, back inside */
+    printf ("--------test2--------\n");
+    assert(StringAppend(str, " and more words than fit inside"));
+    assert(StringGetChars(str) != str->buffer.local);
+    assert(StringGetLength(str) == strlen(StringGetChars(str)));
+    unsigned length = StringGetLength(str);
+    assert(StringAppend(str, StringGetChars(str)));
+    assert(StringGetLength(str) == length * 2);
+    assert(strncmp(StringGetChars(str), StringGetChars(str) + length, length) == 0);
+    for (unsigned i = 0; i < 10000; ++i)
+        assert(StringAddChar(str, 'a' + i % 26));
+    assert(StringGetLength(str) == length * 2 + 10000);
+    assert(str->buffer.capacity < (length * 2 + 10000) * 2);
+    StringTruncate(str, 3);
+    assert(StringCompare(str, "hel") == 0);
+    assert(StringShrinkToFit(str));
+    assert(StringGetChars(str) == str->buffer.local);
+    assert(StringCompare(str, "hel") == 0);
+    assert(StringAssign(str, StringGetChars(str) + 1));
+    assert(StringCompare(str, "el") == 0);
+    printf ("passed!\n");
+
+    /* test3 : formatted text longer than old string_t */
+    printf ("--------test3--------\n");
+    assert(StringFormat(str, "%d-%s", 42, "x"));
+    assert(StringCompare(str, "42-x") == 0);
+    for (unsigned i = 0; i < 500; ++i)
+        assert(StringAppendFormat(str, "[%04u]", i));
+    assert(StringGetLength(str) == 4 + 500 * 6);
+    assert(strncmp(StringGetChars(str) + 4 + 499 * 6, "[0499]", 6) == 0);
+    /* text of string itself as argument */
+    assert(StringFormat(str, "<%.3s>", StringGetChars(str)));
+    assert(StringCompare(str, "<42->") == 0);
+    assert(StringAppendFormat(str, "%s%s", StringGetChars(str), StringGetChars(str)));
+    assert(StringCompare(str, "<42-><42-><42->") == 0);
+    StringClear(str);
+    assert(StringIsEmpty(str));
+    assert(str->reserve(str, 5000));
+    assert(str->buffer.capacity >= 5000);
+    str->append(str, "abc");
+    assert(str->size(str) == 3);
+    StringDestroy(&str);
+    assert(str == NULL);
+
+    str = StringCreateFrom("copy");
+    assert(StringCompare(str, "copy") == 0);
+    AllocDelete((void**)&str);
+    assert(str == NULL);
+    printf ("passed!\n");
+
+    /* test4 : wide string */
+    printf ("--------test4--------\n");
+    WString* wstr = WStringCreateFrom(L"abc");
+    assert(WStringGetLength(wstr) == 3);
+    assert(WStringGetChars(wstr) == (wchar_t*)wstr->buffer.local);
+    assert(WStringAppend(wstr, L" - long wide text on heap"));
+    assert(WStringGetChars(wstr) != (wchar_t*)wstr->buffer.local);
+    assert(WStringCompare(wstr, L"abc - long wide text on heap") == 0);
+    assert(WStringFormat(wstr, L"%d", 7));
+    assert(WStringCompare(wstr, L"7") == 0);
+    for (unsigned i = 0; i < 300; ++i)
+        assert(WStringAppendFormat(wstr, L"<%03u>", i));
+    assert(WStringGetLength(wstr) == 1 + 300 * 5);
+    assert(wcsncmp(WStringGetChars(wstr) + 1 + 299 * 5, L"<299>", 5) == 0);
+    assert(WStringAppendFormat(wstr, L"%ls", WStringGetChars(wstr)));
+    assert(WStringGetLength(wstr) == 2 * (1 + 300 * 5));
+    WStringTruncate(wstr, 1);
+    assert(WStringShrinkToFit(wstr));
+    assert(WStringCompare(wstr, L"7") == 0);
+    assert(WStringAddChar(wstr, L'!'));
+    assert(WStringCompare(wstr, L"7!") == 0);
+    AllocDelete((void**)&wstr);
+    assert(wstr == NULL);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all string's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,183 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#ifndef __STR_H
+#define __STR_H
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <wchar.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define __STRING_ID  1769108563   /* 'S' 't' 'r' 'i' */
+#define __WSTRING_ID 1920226135   /* 'W' 'S' 't' 'r' */
+#define __STRING_CONST_ID 1852785491   /* 'S' 'C' 'o' 'n' - immutable string */
+
+/* bytes inside of string, short text lives there without heap */
+#define STRING_INLINE_SIZE 24
+
+/* chars of string, shared by String and WString */
+typedef struct
+{
+    unsigned length;              /* chars without terminating zero */
+    unsigned capacity;            /* chars which fit without terminating zero */
+    union
+    {
+        void* heap;               /* capacity is bigger than inline room */
+        char  local[STRING_INLINE_SIZE];
+    };
+} StringBuffer;
+
+/* growable string of char, always ends with zero */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of StringCreate from AllocMemory, else of malloc */
+
+    StringBuffer buffer;
+
+    const char* (*c_str)(void* this);
+    unsigned    (*size) (void* this);
+    bool        (*append)(void* this, const char* chars);
+    bool        (*push_back)(void* this, char c);
+    bool        (*empty)(void* this);
+    void        (*clear)(void* this);
+    bool        (*reserve)(void* this, unsigned capacity);
+} String;
+
+/* growable string of wchar_t, always ends with zero */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of WStringCreate from AllocMemory, else of malloc */
+
+    StringBuffer buffer;
+
+    const wchar_t* (*c_str)(void* this);
+    unsigned       (*size) (void* this);
+    bool           (*append)(void* this, const wchar_t* chars);
+    bool           (*push_back)(void* this, wchar_t c);
+    bool           (*empty)(void* this);
+    void           (*clear)(void* this);
+    bool           (*reserve)(void* this, unsigned capacity);
+} WString;
+
+/** init memory as string */
+void StringInit(void* mem);
+/** create empty string and return pointer to string */
+String* StringCreate ();
+/** create string with copy of chars */
+String* StringCreateFrom (const char* chars);
+/** make string empty, memory is kept */
+void StringClear (String* str);
+/** free memory of string and string itself */
+void StringDestroy (String** str);
+
+/** make room for capacity chars, return false if not */
+bool StringReserve (String* str, unsigned capacity);
+/** free unused memory, short string goes back inside, return false if not */
+bool StringShrinkToFit (String* str);
+
+/** replace text of string with chars, return false if not */
+bool StringAssign (String* str, const char* chars);
+/** add chars to end of string, return false if not */
+bool StringAppend (String* str, const char* chars);
+/** add length chars to end of string, chars may have no zero, return false if not */
+bool StringAppendChars (String* str, const char* chars, unsigned length);
+/** add one char to end of string, return false if not */
+bool StringAddChar (String* str, char c);
+/** replace text of string with printf-formatted text, return false if not.
+    Arguments may point into the string itself, text is printed aside and then copied */
+bool StringFormat (String* str, const char* format, ...) __attribute__((format(printf, 2, 3)));
+/** add printf-formatted text to end of string, arguments may point into it. Return false if not */
+bool StringAppendFormat (String* str, const char* format, ...) __attribute__((format(printf, 2, 3)));
+/** same as StringAppendFormat with list of arguments */
+bool StringAppendFormatV (String* str, const char* format, va_list args);
+/** cut string to length chars, longer length does nothing */
+void StringTruncate (String* str, unsigned length);
+
+/* GETTERS */
+/** text of string with terminating zero, valid until next change */
+const char* StringGetChars (String* str);
+/** count of chars without terminating zero */
+unsigned StringGetLength (String* str);
+/** check empty string */
+bool StringIsEmpty (String* str);
+/** compare strings like strcmp */
+int StringCompare (String* str, const char* chars);
+
+/** init memory of sizeof(String) + length + 1 bytes as immutable string with copy of chars.
+    Only getters work with it, changes return false */
+String* StringInitConst (void* mem, const char* chars, unsigned length);
+/** check immutable string */
+bool StringIsConst (String* str);
+/** 64-bit hash of length chars */
+uint64_t StringHashChars (const char* chars, size_t length);
+
+/** init memory as wide string */
+void WStringInit(void* mem);
+/** create empty wide string and return pointer to string */
+WString* WStringCreate ();
+/** create wide string with copy of chars */
+WString* WStringCreateFrom (const wchar_t* chars);
+/** make wide string empty, memory is kept */
+void WStringClear (WString* str);
+/** free memory of wide string and string itself */
+void WStringDestroy (WString** str);
+
+/** make room for capacity chars, return false if not */
+bool WStringReserve (WString* str, unsigned capacity);
+/** free unused memory, short string goes back inside, return false if not */
+bool WStringShrinkToFit (WString* str);
+
+/** replace text of wide string with chars, return false if not */
+bool WStringAssign (WString* str, const wchar_t* chars);
+/** add chars to end of wide string, return false if not */
+bool WStringAppend (WString* str, const wchar_t* chars);
+/** add length chars to end of wide string, chars may have no zero, return false if not */
+bool WStringAppendChars (WString* str, const wchar_t* chars, unsigned length);
+/** add one char to end of wide string, return false if not */
+bool WStringAddChar (WString* str, wchar_t c);
+/** replace text of wide string with wprintf-formatted text, arguments may point into it. Return false if not */
+bool WStringFormat (WString* str, const wchar_t* format, ...);
+/** add wprintf-formatted text to end of wide string, arguments may point into it. Return false if not */
+bool WStringAppendFormat (WString* str, const wchar_t* format, ...);
+/** cut wide string to length chars, longer length does nothing */
+void WStringTruncate (WString* str, unsigned length);
+
+/* GETTERS */
+/** text of wide string with terminating zero, valid until next change */
+const wchar_t* WStringGetChars (WString* str);
+/** count of chars without terminating zero */
+unsigned WStringGetLength (WString* str);
+/** check empty wide string */
+bool WStringIsEmpty (WString* str);
+/** compare wide strings like wcscmp */
+int WStringCompare (WString* str, const wchar_t* chars);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void StringTest();
+#endif // _DEBUG
+
+#endif // __STR_H
@@ -0,0 +1,454 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "strbuilder.h"
+#include "alloc.h"
+
+
+/* formatted text of this size is printed on stack, longer one in temporary memory */
+#define STRBUILDER_FORMAT_STACK 256
+
+#define STRBUILDER_CHECK_VALID                          \
+                if (!builder) return 0;                 \
+                unsigned id = *(unsigned*)builder;      \
+                if (id != __STRBUILDER_ID) return 0;
+
+/* pairs of digits 00..99, number is printed by two digits at once */
+static const char strBuilderDigits[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+static bool StringBuilderResize (StringBuilder* builder, size_t capacity)
+{
+    char* data = realloc(builder->data, capacity + 1);
+    if (data == NULL)
+        return false;
+
+    /* text is ended with zero even before first append */
+    if (builder->data == NULL)
+        data[0] = '\0';
+
+    builder->data     = data;
+    builder->capacity = capacity;
+
+    return true;
+}
+
+/* make room for count more bytes, grow twice so append takes amortized O(1) */
+static inline bool StringBuilderGrow (StringBuilder* builder, size_t count)
+{
+    if (count <= builder->capacity - builder->length && builder->data)
+        return true;
+    if (count > SIZE_MAX / 2 - builder->length)
+        return false;
+
+    size_t capacity = (builder->capacity) ? builder->capacity * 2 : STRBUILDER_MIN_CAPACITY;
+    if (capacity < builder->length + count)
+        capacity = builder->length + count;
+
+    return StringBuilderResize(builder, capacity);
+}
+
+/* print number to the end of buf, return first digit */
+static char* StringBuilderPrintUnsigned (char* end, unsigned long long value)
+{
+    char* p = end;
+    while (value >= 100)
+    {
+        unsigned pair = (value % 100) * 2;
+        value /= 100;
+        *--p = strBuilderDigits[pair + 1];
+        *--p = strBuilderDigits[pair];
+    }
+
+    if (value >= 10)
+    {
+        *--p = strBuilderDigits[value * 2 + 1];
+        *--p = strBuilderDigits[value * 2];
+    }
+    else
+        *--p = '0' + value;
+
+    return p;
+}
+
+
+void StringBuilderInit(void* mem)
+{
+    if (mem)
+    {
+        StringBuilder* builder = mem;
+
+        /* already initialized? */
+        if (builder->__id == __STRBUILDER_ID)
+        {
+            StringBuilderClear(builder);
+        }
+        else
+        {
+            memset(builder, 0, sizeof(StringBuilder));
+
+            builder->__id      = __STRBUILDER_ID;
+
+            builder->append    = &StringBuilderAppend;
+            builder->push_back = &StringBuilderAddChar;
+            builder->clear     = &StringBuilderClear;
+        }
+    }
+}
+
+StringBuilder* StringBuilderCreate()
+{
+    StringBuilder* builder = AllocMemory(ALLOC_TYPE_STRBUILDER, sizeof(StringBuilder), 1);
+    if (builder == NULL)
+        return NULL;
+
+    builder->__id = 0;
+    StringBuilderInit(builder);
+    builder->__alloc = true;
+
+    return builder;
+}
+
+void StringBuilderClear (StringBuilder* builder)
+{
+    STRBUILDER_CHECK_VALID
+
+    builder->length = 0;
+    if (builder->data)
+        builder->data[0] = '\0';
+}
+
+/* release text of builder, called by delete() */
+static void StringBuilderFinalize (void* object)
+{
+    StringBuilder* builder = object;
+
+    free (builder->data);
+
+    builder->__id = 0;
+}
+
+static void __attribute__((constructor)) StringBuilderRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_STRBUILDER, StringBuilderFinalize);
+}
+
+void StringBuilderDestroy (StringBuilder** builder)
+{
+    if (!builder || !(*builder))
+        return;
+
+    /* memory of StringBuilderInit is released by free() */
+    bool alloc = (*builder)->__alloc;
+    StringBuilderFinalize(*builder);
+
+    if (alloc)
+        AllocFree(*builder);
+    else
+        free (*builder);
+    *builder = NULL;
+}
+
+bool StringBuilderReserve (StringBuilder* builder, size_t capacity)
+{
+    STRBUILDER_CHECK_VALID
+
+    if (capacity <= builder->capacity && builder->data)
+        return true;
+
+    return StringBuilderResize(builder, capacity);
+}
+
+bool StringBuilderAppendChars (StringBuilder* builder, const char* chars, size_t length)
+{
+    STRBUILDER_CHECK_VALID
+
+    if (chars == NULL)
+        return (length == 0);
+
+    /* chars may be part of this builder and move on grow */
+    bool   inside = (builder->data && chars >= builder->data && chars <= builder->data + builder->length);
+    size_t offset = (inside) ? (size_t)(chars - builder->data) : 0;
+
+    if (!StringBuilderGrow(builder, length))
+        return false;
+    if (inside)
+        chars = builder->data + offset;
+
+    memcpy(builder->data + builder->length, chars, length);
+    builder->length += length;
+    builder->data[builder->length] = '\0';
+
+    return true;
+}
+
+bool StringBuilderAppend (StringBuilder* builder, const char* chars)
+{
+    STRBUILDER_CHECK_VALID
+
+    if (chars == NULL)
+        return true;
+
+    return StringBuilderAppendChars(builder, chars, strlen(chars));
+}
+
+bool StringBuilderAppendString (StringBuilder* builder, String* str)
+{
+    STRBUILDER_CHECK_VALID
+
+    if (str == NULL)
+        return true;
+
+    /* length is known, no strlen */
+    return StringBuilderAppendChars(builder, StringGetChars(str), StringGetLength(str));
+}
+
+bool StringBuilderAddChar (StringBuilder* builder, char c)
+{
+    STRBUILDER_CHECK_VALID
+
+    if (!StringBuilderGrow(builder, 1))
+        return false;
+
+    builder->data[builder->length++] = c;
+    builder->data[builder->length]   = '\0';
+
+    return true;
+}
+
+bool StringBuilderAppendUnsigned (StringBuilder* builder, unsigned long long value)
+{
+    STRBUILDER_CHECK_VALID
+
+    char  buf[24];
+    char* end   = buf + sizeof(buf);
+    char* first = StringBuilderPrintUnsigned(end, value);
+
+    return StringBuilderAppendChars(builder, first, end - first);
+}
+
+bool StringBuilderAppendInt (StringBuilder* builder, long long value)
+{
+    STRBUILDER_CHECK_VALID
+
+    char  buf[24];
+    char* end = buf + sizeof(buf);
+
+    /* minimal number has no positive pair, so negate unsigned */
+    unsigned long long magnitude = (value < 0) ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    char* first = StringBuilderPrintUnsigned(end, magnitude);
+    if (value < 0)
+        *--first = '-';
+
+    return StringBuilderAppendChars(builder, first, end - first);
+}
+
+bool StringBuilderAppendDouble (StringBuilder* builder, double value, int precision)
+{
+    STRBUILDER_CHECK_VALID
+
+    return StringBuilderAppendFormat(builder, "%.*f", precision, value);
+}
+
+bool StringBuilderAppendFormat (StringBuilder* builder, const char* format, ...)
+{
+    STRBUILDER_CHECK_VALID
+
+    if (format == NULL)
+        return false;
+
+    /* arguments may point into builder, so text is printed aside - on stack if it is short */
+    char  buf[STRBUILDER_FORMAT_STACK];
+    char* text = buf;
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if (length < 0)
+        return false;
+
+    if ((size_t)length >= sizeof(buf))
+    {
+        text = malloc((size_t)length + 1);
+        if (text == NULL)
+            return false;
+
+        va_start(args, format);
+        vsnprintf(text, (size_t)length + 1, format, args);
+        va_end(args);
+    }
+
+    bool result = StringBuilderAppendChars(builder, text, length);
+
+    if (text != buf)
+        free (text);
+
+    return result;
+}
+
+const char* StringBuilderGetChars (StringBuilder* builder)
+{
+    STRBUILDER_CHECK_VALID
+
+    return (builder->data) ? builder->data : "";
+}
+
+size_t StringBuilderGetLength (StringBuilder* builder)
+{
+    STRBUILDER_CHECK_VALID
+
+    return builder->length;
+}
+
+char* StringBuilderDetach (StringBuilder* builder, size_t* length)
+{
+    STRBUILDER_CHECK_VALID
+
+    char* data = builder->data;
+    if (data == NULL)
+        data = calloc(1, 1);
+    else if (builder->capacity - builder->length > builder->length)
+    {
+        /* half of buffer is empty, give it back */
+        char* fit = realloc(data, builder->length + 1);
+        if (fit)
+            data = fit;
+    }
+
+    if (length)
+        *length = (data) ? builder->length : 0;
+
+    builder->data     = NULL;
+    builder->length   = 0;
+    builder->capacity = 0;
+
+    return data;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+void StringBuilderTest()
+{
+    printf ("StringBuilder's tests started!!!\n");
+
+    /* test1 : appends of chars, strings and numbers */
+    printf ("--------test1--------\n");
+    StringBuilder* builder = StringBuilderCreate();
+    assert(StringBuilderGetLength(builder) == 0);
+    assert(strcmp(StringBuilderGetChars(builder), "") == 0);
+    assert(StringBuilderAppend(builder, "a="));
+    assert(StringBuilderAppendInt(builder, -42));
+    assert(StringBuilderAddChar(builder, ' '));
+    assert(StringBuilderAppendUnsigned(builder, 18446744073709551615ull));
+    assert(StringBuilderAddChar(builder, ' '));
+    assert(StringBuilderAppendInt(builder, INT64_MIN));
+    assert(StringBuilderAddChar(builder, ' '));
+    assert(StringBuilderAppendInt(builder, 0));
+    assert(StringBuilderAddChar(builder, ' '));
+    assert(StringBuilderAppendDouble(builder, 2.5, 2));
+    assert(strcmp(StringBuilderGetChars(builder), "a=-42 18446744073709551615 -9223372036854775808 0 2.50") == 0);
+    assert(StringBuilderGetLength(builder) == strlen(StringBuilderGetChars(builder)));
+
+    String* str = StringCreateFrom("|str|");
+    assert(StringBuilderAppendString(builder, str));
+    StringDestroy(&str);
+    assert(StringBuilderAppendFormat(builder, "%s-%03d", "f", 7));
+    assert(strcmp(StringBuilderGetChars(builder) + StringBuilderGetLength(builder) - 10, "|str|f-007") == 0);
+    printf ("passed!\n");
+
+    /* test2 : long text, numbers checked against printf */
+    printf ("--------test2--------\n");
+    StringBuilderClear(builder);
+    char check[32];
+    size_t total = 0;
+    for (int i = -50000; i < 50000; i += 7)
+    {
+        assert(StringBuilderAppendInt(builder, i * 1234567ll));
+        assert(StringBuilderAddChar(builder, ';'));
+        total += sprintf(check, "%lld;", i * 1234567ll);
+    }
+    assert(StringBuilderGetLength(builder) == total);
+    assert(strncmp(StringBuilderGetChars(builder), "-61728350000;", 13) == 0);
+    assert(builder->capacity < total * 2 + STRBUILDER_MIN_CAPACITY);
+
+    /* append of own text */
+    StringBuilderClear(builder);
+    StringBuilderAppend(builder, "abc");
+    for (unsigned i = 0; i < 10; ++i)
+        assert(StringBuilderAppendChars(builder, StringBuilderGetChars(builder), StringBuilderGetLength(builder)));
+    assert(StringBuilderGetLength(builder) == 3 * 1024);
+    assert(strncmp(builder->data + 3 * 1023, "abc", 3) == 0);
+
+    /* text of builder itself as argument */
+    StringBuilderClear(builder);
+    StringBuilderAppend(builder, "xy");
+    assert(StringBuilderAppendFormat(builder, "%s%s", StringBuilderGetChars(builder), StringBuilderGetChars(builder)));
+    assert(strcmp(StringBuilderGetChars(builder), "xyxyxy") == 0);
+
+    /* formatted text bigger than free room */
+    StringBuilderClear(builder);
+    assert(StringBuilderAppendFormat(builder, "%2000d", 1));
+    assert(StringBuilderGetLength(builder) == 2000);
+    assert(StringBuilderGetChars(builder)[1999] == '1');
+    printf ("passed!\n");
+
+    /* test3 : detach without copy */
+    printf ("--------test3--------\n");
+    size_t length = 0;
+    char* text = StringBuilderDetach(builder, &length);
+    assert(length == 2000 && strlen(text) == 2000);
+    free(text);
+    /* full enough buffer is given as is */
+    assert(StringBuilderReserve(builder, 100));
+    for (unsigned i = 0; i < 60; ++i)
+        StringBuilderAddChar(builder, 'z');
+    const char* before = StringBuilderGetChars(builder);
+    text = StringBuilderDetach(builder, &length);
+    assert(text == before && length == 60 && text[60] == '\0');
+    free(text);
+    assert(StringBuilderGetLength(builder) == 0);
+    text = StringBuilderDetach(builder, &length);
+    assert(length == 0 && text[0] == '\0');
+    free(text);
+    assert(StringBuilderAppend(builder, "again"));
+    assert(strcmp(StringBuilderGetChars(builder), "again") == 0);
+    AllocDelete((void**)&builder);
+    assert(builder == NULL);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all string builder's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,92 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#ifndef __STRBUILDER_H
+#define __STRBUILDER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#include "str.h"
+
+#define __STRBUILDER_ID 1684816467   /* 'S' 'B' 'l' 'd' */
+
+#define STRBUILDER_MIN_CAPACITY 64   /* bytes after first append */
+
+/* buffer for building of long text by appends */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of StringBuilderCreate from AllocMemory, else of malloc */
+
+    char*  data;               /* text with terminating zero, NULL before first append */
+    size_t length;
+    size_t capacity;           /* bytes of data without terminating zero */
+
+    bool (*append)(void* this, const char* chars);
+    bool (*push_back)(void* this, char c);
+    void (*clear)(void* this);
+} StringBuilder;
+
+/** init memory as string builder */
+void StringBuilderInit(void* mem);
+/** create string builder and return pointer to it */
+StringBuilder* StringBuilderCreate ();
+/** forget text, memory is kept */
+void StringBuilderClear (StringBuilder* builder);
+/** free memory of builder and builder itself */
+void StringBuilderDestroy (StringBuilder** builder);
+
+/** make room for capacity bytes, return false if not */
+bool StringBuilderReserve (StringBuilder* builder, size_t capacity);
+
+/** add chars to end, return false if not */
+bool StringBuilderAppend (StringBuilder* builder, const char* chars);
+/** add length chars to end, chars may have no zero, return false if not */
+bool StringBuilderAppendChars (StringBuilder* builder, const char* chars, size_t length);
+/** add text of string to end, return false if not */
+bool StringBuilderAppendString (StringBuilder* builder, String* str);
+/** add one char to end, return false if not */
+bool StringBuilderAddChar (StringBuilder* builder, char c);
+/** add decimal number without printf, return false if not */
+bool StringBuilderAppendInt (StringBuilder* builder, long long value);
+/** add decimal unsigned number without printf, return false if not */
+bool StringBuilderAppendUnsigned (StringBuilder* builder, unsigned long long value);
+/** add number with precision digits after point, return false if not */
+bool StringBuilderAppendDouble (StringBuilder* builder, double value, int precision);
+/** add printf-formatted text to end, arguments may point into builder itself. Return false if not */
+bool StringBuilderAppendFormat (StringBuilder* builder, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+/** text with terminating zero, valid until next append */
+const char* StringBuilderGetChars (StringBuilder* builder);
+/** count of bytes without terminating zero */
+size_t StringBuilderGetLength (StringBuilder* builder);
+/** give text to caller without copy, caller frees it with free(), builder becomes empty */
+char* StringBuilderDetach (StringBuilder* builder, size_t* length);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void StringBuilderTest();
+#endif // _DEBUG
+
+#endif // __STRBUILDER_H
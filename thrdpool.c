@@ -0,0 +1,319 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "thrdpool.h"
+
+#ifdef __MULTITHREADS
+
+#ifdef __USE_SDL_THREADS
+    #include "SDL2/SDL.h"
+    typedef SDL_mutex*  ThreadPoolMutex;
+    typedef SDL_cond*   ThreadPoolCond;
+    typedef SDL_Thread* ThreadPoolThread;
+#else  // NOT __USE_SDL_THREADS
+    #include "tinycthread.h"
+    typedef mtx_t       ThreadPoolMutex;
+    typedef cnd_t       ThreadPoolCond;
+    typedef thrd_t      ThreadPoolThread;
+    #ifdef _WIN32
+        #include <windows.h>
+    #else
+        #include <unistd.h>
+        #include <time.h>
+    #endif // _WIN32
+#endif // __USE_SDL_THREADS
+
+#define THREAD_POOL_MAX_THREADS 64
+
+struct ThreadPool_tag
+{
+    ThreadPoolMutex  lock;
+    ThreadPoolCond   wake;          /* new job or stop */
+    ThreadPoolCond   done;          /* all parts of job are finished */
+
+    ThreadPoolThread threads[THREAD_POOL_MAX_THREADS];
+    unsigned         count;         /* worker threads */
+    unsigned         overhead;      /* nanoseconds to run empty job */
+
+    unsigned         generation;    /* number of job, changed under lock */
+    bool             stop;
+    int              busy;          /* some thread runs a job now */
+
+    /* current job */
+    ThreadPoolTask   task;
+    void*            arg;
+    unsigned         parts;
+    uint64_t         ticket;        /* generation << 32 | next part to take, atomic */
+    unsigned         pending;       /* parts not finished yet, atomic */
+};
+
+static ThreadPool threadPool;
+static int        threadPoolState = 0;  /* 0 - not started, 1 - starting, 2 - ready */
+
+
+/* wrappers over threads of SDL or tinycthread */
+#ifdef __USE_SDL_THREADS
+static inline void ThreadPoolLock   (ThreadPool* pool) { SDL_LockMutex(pool->lock); }
+static inline void ThreadPoolUnlock (ThreadPool* pool) { SDL_UnlockMutex(pool->lock); }
+static inline void ThreadPoolWait   (ThreadPool* pool, ThreadPoolCond* cond) { SDL_CondWait(*cond, pool->lock); }
+static inline void ThreadPoolWakeAll(ThreadPoolCond* cond) { SDL_CondBroadcast(*cond); }
+static inline void ThreadPoolYield  () { SDL_Delay(0); }
+#else  // NOT __USE_SDL_THREADS
+static inline void ThreadPoolLock   (ThreadPool* pool) { mtx_lock(&pool->lock); }
+static inline void ThreadPoolUnlock (ThreadPool* pool) { mtx_unlock(&pool->lock); }
+static inline void ThreadPoolWait   (ThreadPool* pool, ThreadPoolCond* cond) { cnd_wait(cond, &pool->lock); }
+static inline void ThreadPoolWakeAll(ThreadPoolCond* cond) { cnd_broadcast(cond); }
+static inline void ThreadPoolYield  () { thrd_yield(); }
+#endif // __USE_SDL_THREADS
+
+uint64_t ThreadPoolTime ()
+{
+#ifdef __USE_SDL_THREADS
+    return (uint64_t)((double)SDL_GetPerformanceCounter() * 1e9 / SDL_GetPerformanceFrequency());
+#elif defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / frequency.QuadPart);
+#else
+    /* wall clock may jump, calibration needs steady one */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif // __USE_SDL_THREADS
+}
+
+static void ThreadPoolEmptyTask (void* arg, unsigned part)
+{
+    (void)arg;
+    (void)part;
+}
+
+static unsigned ThreadPoolCountCPU ()
+{
+#ifdef __USE_SDL_THREADS
+    int count = SDL_GetCPUCount();
+#elif defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = info.dwNumberOfProcessors;
+#else
+    int count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif // __USE_SDL_THREADS
+    return (count > 0) ? count : 1;
+}
+
+/* take parts of job until they are over, late thread never takes parts of next job */
+static void ThreadPoolWork (ThreadPool* pool, unsigned generation, ThreadPoolTask task, void* arg, unsigned parts)
+{
+    uint64_t ticket = __atomic_load_n(&pool->ticket, __ATOMIC_ACQUIRE);
+    for (;;)
+    {
+        if ((unsigned)(ticket >> 32) != generation || (unsigned)ticket >= parts)
+            break;
+
+        if (!__atomic_compare_exchange_n(&pool->ticket, &ticket, ticket + 1, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            continue;
+
+        task(arg, (unsigned)ticket);
+
+        if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL) == 0)
+        {
+            ThreadPoolLock(pool);
+            ThreadPoolWakeAll(&pool->done);
+            ThreadPoolUnlock(pool);
+        }
+
+        ticket = __atomic_load_n(&pool->ticket, __ATOMIC_ACQUIRE);
+    }
+}
+
+static int ThreadPoolWorker (void* arg)
+{
+    ThreadPool* pool = arg;
+
+    ThreadPoolLock(pool);
+    unsigned generation = pool->generation;
+    for (;;)
+    {
+        while (pool->generation == generation && !pool->stop)
+            ThreadPoolWait(pool, &pool->wake);
+        if (pool->stop)
+            break;
+
+        /* take job while it can't be changed */
+        generation = pool->generation;
+        ThreadPoolTask task = pool->task;
+        void*     taskArg   = pool->arg;
+        unsigned  parts     = pool->parts;
+
+        ThreadPoolUnlock(pool);
+        ThreadPoolWork(pool, generation, task, taskArg, parts);
+        ThreadPoolLock(pool);
+    }
+    ThreadPoolUnlock(pool);
+
+    return 0;
+}
+
+static void ThreadPoolStop ()
+{
+    ThreadPool* pool = &threadPool;
+
+    ThreadPoolLock(pool);
+    pool->stop = true;
+    ThreadPoolWakeAll(&pool->wake);
+    ThreadPoolUnlock(pool);
+
+    for (unsigned i = 0; i < pool->count; ++i)
+    {
+#ifdef __USE_SDL_THREADS
+        SDL_WaitThread(pool->threads[i], NULL);
+#else
+        thrd_join(pool->threads[i], NULL);
+#endif // __USE_SDL_THREADS
+    }
+    pool->count = 0;
+}
+
+static void ThreadPoolStart (ThreadPool* pool)
+{
+    memset(pool, 0, sizeof(ThreadPool));
+
+#ifdef __USE_SDL_THREADS
+    pool->lock = SDL_CreateMutex();
+    pool->wake = SDL_CreateCond();
+    pool->done = SDL_CreateCond();
+#else
+    mtx_init(&pool->lock, mtx_plain);
+    cnd_init(&pool->wake);
+    cnd_init(&pool->done);
+#endif // __USE_SDL_THREADS
+
+    /* caller thread works too */
+    unsigned count = ThreadPoolCountCPU() - 1;
+    if (count > THREAD_POOL_MAX_THREADS)
+        count = THREAD_POOL_MAX_THREADS;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+#ifdef __USE_SDL_THREADS
+        pool->threads[pool->count] = SDL_CreateThread(ThreadPoolWorker, "worker", pool);
+        if (pool->threads[pool->count] == NULL)
+            break;
+#else
+        if (thrd_create(&pool->threads[pool->count], ThreadPoolWorker, pool) != thrd_success)
+            break;
+#endif // __USE_SDL_THREADS
+        ++pool->count;
+    }
+
+    atexit(ThreadPoolStop);
+
+    /* the best of several runs, first ones wake up threads */
+    pool->overhead = UINT32_MAX;
+    for (unsigned i = 0; i < 16 && pool->count > 0; ++i)
+    {
+        uint64_t start = ThreadPoolTime();
+        ThreadPoolRun(pool, ThreadPoolEmptyTask, NULL, pool->count + 1);
+        uint64_t elapsed = ThreadPoolTime() - start;
+        if (elapsed < pool->overhead)
+            pool->overhead = elapsed;
+    }
+}
+
+ThreadPool* ThreadPoolGet ()
+{
+    int state = __atomic_load_n(&threadPoolState, __ATOMIC_ACQUIRE);
+    if (state == 2)
+        return &threadPool;
+
+    state = 0;
+    if (__atomic_compare_exchange_n(&threadPoolState, &state, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        ThreadPoolStart(&threadPool);
+        __atomic_store_n(&threadPoolState, 2, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        /* other thread starts pool now */
+        while (__atomic_load_n(&threadPoolState, __ATOMIC_ACQUIRE) != 2)
+            ThreadPoolYield();
+    }
+
+    return &threadPool;
+}
+
+unsigned ThreadPoolGetSize (ThreadPool* pool)
+{
+    if (!pool)
+        return 1;
+
+    return pool->count + 1;
+}
+
+unsigned ThreadPoolGetOverhead (ThreadPool* pool)
+{
+    if (!pool || pool->count == 0)
+        return UINT32_MAX;
+
+    return pool->overhead;
+}
+
+void ThreadPoolRun (ThreadPool* pool, ThreadPoolTask task, void* arg, unsigned parts)
+{
+    if (!task || parts == 0)
+        return;
+
+    /* no workers, nested or concurrent job - do it here */
+    if (!pool || pool->count == 0 || parts == 1 ||
+        __atomic_exchange_n(&pool->busy, 1, __ATOMIC_ACQUIRE))
+    {
+        for (unsigned i = 0; i < parts; ++i)
+            task(arg, i);
+        return;
+    }
+
+    ThreadPoolLock(pool);
+    unsigned generation = ++pool->generation;
+    pool->task  = task;
+    pool->arg   = arg;
+    pool->parts = parts;
+    __atomic_store_n(&pool->pending, parts, __ATOMIC_RELEASE);
+    __atomic_store_n(&pool->ticket,  (uint64_t)generation << 32, __ATOMIC_RELEASE);
+    ThreadPoolWakeAll(&pool->wake);
+    ThreadPoolUnlock(pool);
+
+    ThreadPoolWork(pool, generation, task, arg, parts);
+
+    ThreadPoolLock(pool);
+    while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) != 0)
+        ThreadPoolWait(pool, &pool->done);
+    ThreadPoolUnlock(pool);
+
+    __atomic_store_n(&pool->busy, 0, __ATOMIC_RELEASE);
+}
+
+#endif // __MULTITHREADS
@@ -0,0 +1,49 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __THRDPOOL_H
+#define __THRDPOOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+
+#ifdef __MULTITHREADS
+
+/* part of work, parts of one job are numbered from 0 */
+typedef void (*ThreadPoolTask)(void* arg, unsigned part);
+
+typedef struct ThreadPool_tag ThreadPool;
+
+/** get shared pool, threads are started on first call and stopped at exit */
+ThreadPool* ThreadPoolGet ();
+/** count of threads doing a job, caller thread included */
+unsigned ThreadPoolGetSize (ThreadPool* pool);
+/** time of empty job in nanoseconds, measured when pool is started */
+unsigned ThreadPoolGetOverhead (ThreadPool* pool);
+/** monotonic time in nanoseconds */
+uint64_t ThreadPoolTime ();
+/** run task for every part in [0, parts) and wait for all of them.
+    If pool is busy with another job, all parts run in caller thread */
+void ThreadPoolRun (ThreadPool* pool, ThreadPoolTask task, void* arg, unsigned parts);
+
+#endif // __MULTITHREADS
+
+#endif // __THRDPOOL_H
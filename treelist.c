@@ -0,0 +1,510 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "treelist.h"
+#include "alloc.h"
+
+
+#define TREELIST_CHECK_VALID                        \
+                if (!list) return 0;                \
+                unsigned id = *(unsigned*)list;     \
+                if (id != __TREELIST_ID) return 0;
+
+/* AVL-tree of 2^32 nodes is never higher than this */
+#define TREELIST_MAX_HEIGHT 48
+
+
+static inline unsigned TreeListNodeCount (TreeListNode* node)
+{
+    return (node) ? node->count : 0;
+}
+
+static inline int TreeListNodeHeight (TreeListNode* node)
+{
+    return (node) ? node->height : 0;
+}
+
+static inline void TreeListNodeUpdate (TreeListNode* node)
+{
+    int left  = TreeListNodeHeight(node->left);
+    int right = TreeListNodeHeight(node->right);
+
+    node->height = ((left > right) ? left : right) + 1;
+    node->count  = TreeListNodeCount(node->left) + TreeListNodeCount(node->right) + 1;
+}
+
+static TreeListNode* TreeListRotateRight (TreeListNode* node)
+{
+    TreeListNode* left = node->left;
+    node->left  = left->right;
+    left->right = node;
+
+    TreeListNodeUpdate(node);
+    TreeListNodeUpdate(left);
+
+    return left;
+}
+
+static TreeListNode* TreeListRotateLeft (TreeListNode* node)
+{
+    TreeListNode* right = node->right;
+    node->right = right->left;
+    right->left = node;
+
+    TreeListNodeUpdate(node);
+    TreeListNodeUpdate(right);
+
+    return right;
+}
+
+/* restore AVL balance of subtree and return new root of it */
+static TreeListNode* TreeListBalance (TreeListNode* node)
+{
+    TreeListNodeUpdate(node);
+
+    int balance = TreeListNodeHeight(node->left) - TreeListNodeHeight(node->right);
+    if (balance > 1)
+    {
+        if (TreeListNodeHeight(node->left->left) < TreeListNodeHeight(node->left->right))
+            node->left = TreeListRotateLeft(node->left);
+        return TreeListRotateRight(node);
+    }
+    if (balance < -1)
+    {
+        if (TreeListNodeHeight(node->right->right) < TreeListNodeHeight(node->right->left))
+            node->right = TreeListRotateRight(node->right);
+        return TreeListRotateLeft(node);
+    }
+
+    return node;
+}
+
+static TreeListNode* TreeListNodeInsert (TreeListNode* node, unsigned numOfElement, TreeListNode* newNode)
+{
+    if (node == NULL)
+        return newNode;
+
+    unsigned leftCount = TreeListNodeCount(node->left);
+    if (numOfElement <= leftCount)
+        node->left  = TreeListNodeInsert(node->left,  numOfElement, newNode);
+    else
+        node->right = TreeListNodeInsert(node->right, numOfElement - leftCount - 1, newNode);
+
+    return TreeListBalance(node);
+}
+
+/* unlink leftmost node of subtree to *min */
+static TreeListNode* TreeListNodeRemoveMin (TreeListNode* node, TreeListNode** min)
+{
+    if (node->left == NULL)
+    {
+        *min = node;
+        return node->right;
+    }
+
+    node->left = TreeListNodeRemoveMin(node->left, min);
+    return TreeListBalance(node);
+}
+
+/* unlink node by position to *removed */
+static TreeListNode* TreeListNodeRemove (TreeListNode* node, unsigned numOfElement, TreeListNode** removed)
+{
+    unsigned leftCount = TreeListNodeCount(node->left);
+    if (numOfElement < leftCount)
+    {
+        node->left  = TreeListNodeRemove(node->left, numOfElement, removed);
+        return TreeListBalance(node);
+    }
+    if (numOfElement > leftCount)
+    {
+        node->right = TreeListNodeRemove(node->right, numOfElement - leftCount - 1, removed);
+        return TreeListBalance(node);
+    }
+
+    *removed = node;
+    if (node->left == NULL)
+        return node->right;
+    if (node->right == NULL)
+        return node->left;
+
+    /* node with two children is replaced by the next one */
+    TreeListNode* next = NULL;
+    TreeListNode* right = TreeListNodeRemoveMin(node->right, &next);
+    next->left  = node->left;
+    next->right = right;
+
+    return TreeListBalance(next);
+}
+
+static TreeListNode* TreeListGetNodeByNumber (TreeList* list, unsigned numOfElement)
+{
+    if (numOfElement >= list->size)
+        return NULL;
+
+    TreeListNode* node = list->root;
+    while (node)
+    {
+        unsigned leftCount = TreeListNodeCount(node->left);
+        if (numOfElement == leftCount)
+            break;
+
+        if (numOfElement < leftCount)
+            node = node->left;
+        else
+        {
+            numOfElement -= leftCount + 1;
+            node = node->right;
+        }
+    }
+
+    return node;
+}
+
+static void TreeListNodeFree (TreeListNode* node)
+{
+    if (node == NULL)
+        return;
+
+    TreeListNodeFree(node->left);
+    TreeListNodeFree(node->right);
+    free (node);
+}
+
+
+void TreeListInit(void* mem)
+{
+    if (mem)
+    {
+        TreeList* list = mem;
+
+        /* already initialized? */
+        if (list->__id == __TREELIST_ID)
+        {
+            TreeListClear(list);
+        }
+        else
+        {
+            memset(list, 0, sizeof(TreeList));
+
+            list->__id      = __TREELIST_ID;
+
+            list->front     = &TreeListGetFirstValue;
+            list->back      = &TreeListGetLastValue;
+            list->push_back = &TreeListAddElement;
+            list->pop_back  = &TreeListPopBack;
+            list->at        = &TreeListGetValueByNumber;
+            list->clear     = &TreeListClear;
+            list->empty     = &TreeListIsEmpty;
+        }
+    }
+}
+
+TreeList* TreeListCreate()
+{
+    TreeList* list = AllocMemory(ALLOC_TYPE_TREELIST, sizeof(TreeList), 1);
+    if (list == NULL)
+        return NULL;
+
+    list->__id = 0;
+    TreeListInit(list);
+    list->__alloc = true;
+
+    return list;
+}
+
+void TreeListClear(TreeList* list)
+{
+    TREELIST_CHECK_VALID
+
+    TreeListNodeFree(list->root);
+
+    list->root = NULL;
+    list->size = 0;
+}
+
+/* release nodes of tree, called by delete() */
+static void TreeListFinalize (void* object)
+{
+    TreeList* list = object;
+
+    TreeListClear(list);
+
+    list->__id = 0;
+}
+
+static void __attribute__((constructor)) TreeListRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_TREELIST, TreeListFinalize);
+}
+
+void TreeListDestroy (TreeList** list)
+{
+    if (!list || !(*list))
+        return;
+
+    /* memory of TreeListInit is released by free() */
+    bool alloc = (*list)->__alloc;
+    TreeListFinalize(*list);
+
+    if (alloc)
+        AllocFree(*list);
+    else
+        free (*list);
+    *list = NULL;
+}
+
+bool TreeListAddElement (TreeList* list, void* value)
+{
+    TREELIST_CHECK_VALID
+
+    return TreeListInsertElement(list, list->size, value);
+}
+
+bool TreeListInsertElement (TreeList* list, unsigned numOfElement, void* value)
+{
+    TREELIST_CHECK_VALID
+
+    if (numOfElement > list->size)
+        return false;
+
+    TreeListNode* node = malloc(sizeof(TreeListNode));
+    if (node == NULL)
+        return false;
+
+    node->value  = value;
+    node->left   = NULL;
+    node->right  = NULL;
+    node->count  = 1;
+    node->height = 1;
+
+    list->root = TreeListNodeInsert(list->root, numOfElement, node);
+    ++list->size;
+
+    return true;
+}
+
+void TreeListDeleteElementByValue (TreeList* list, void* value)
+{
+    TREELIST_CHECK_VALID
+
+    if (value == NULL)
+        return;
+
+    int num = TreeListGetNumberByValue(list, value);
+    if (num >= 0)
+        TreeListDeleteElementByNumber(list, num);
+}
+
+void TreeListDeleteElementByNumber (TreeList* list, unsigned numOfElement)
+{
+    TREELIST_CHECK_VALID
+
+    if (numOfElement >= list->size)
+        return;
+
+    TreeListNode* removed = NULL;
+    list->root = TreeListNodeRemove(list->root, numOfElement, &removed);
+    --list->size;
+
+    free (removed);
+}
+
+void TreeListPopBack(TreeList* list)
+{
+    TREELIST_CHECK_VALID
+
+    if (list->size > 0)
+        TreeListDeleteElementByNumber(list, list->size - 1);
+}
+
+void* TreeListGetFirstValue(TreeList* list)
+{
+    TREELIST_CHECK_VALID
+
+    TreeListNode* node = list->root;
+    while (node && node->left)
+        node = node->left;
+
+    return (node) ? node->value : NULL;
+}
+
+void* TreeListGetLastValue(TreeList* list)
+{
+    TREELIST_CHECK_VALID
+
+    TreeListNode* node = list->root;
+    while (node && node->right)
+        node = node->right;
+
+    return (node) ? node->value : NULL;
+}
+
+void* TreeListGetValueByNumber (TreeList* list, unsigned numOfElement)
+{
+    TREELIST_CHECK_VALID
+
+    TreeListNode* node = TreeListGetNodeByNumber(list, numOfElement);
+    if (!node)
+        return NULL;
+
+    return node->value;
+}
+
+int TreeListGetNumberByValue (TreeList* list, const void* value)
+{
+    if (!list || !value)
+        return -1;
+
+    /* walk the tree in order */
+    TreeListNode* stack[TREELIST_MAX_HEIGHT];
+    int top = 0;
+    int num = 0;
+    TreeListNode* node = list->root;
+    while (node || top > 0)
+    {
+        while (node)
+        {
+            stack[top++] = node;
+            node = node->left;
+        }
+
+        node = stack[--top];
+        if (node->value == value)
+            return num;
+        ++num;
+
+        node = node->right;
+    }
+
+    return -1;
+}
+
+unsigned TreeListGetSize (TreeList* list)
+{
+    TREELIST_CHECK_VALID
+
+    return list->size;
+}
+
+bool TreeListIsEmpty(TreeList* list)
+{
+    TREELIST_CHECK_VALID
+
+    return (list->size == 0);
+}
+
+void TreeListSetValueByNumber(TreeList* list, unsigned numOfElement, void* value)
+{
+    TREELIST_CHECK_VALID
+
+    if (value == NULL)
+        return;
+
+    TreeListNode* node = TreeListGetNodeByNumber(list, numOfElement);
+    if (node)
+        node->value = value;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#define MAX_TREELIST_SIZE 6000
+void TreeListTest()
+{
+    printf ("TreeList's tests started!!!\n");
+
+    int* array = malloc(MAX_TREELIST_SIZE*sizeof(int));
+    TreeList* list = TreeListCreate();
+
+    /* test1 : fill list */
+    printf ("--------test1--------\n");
+    for (unsigned i = 0; i < MAX_TREELIST_SIZE; ++i)
+    {
+        array[i] = i;
+        assert(TreeListAddElement(list, &array[i]));
+    }
+    assert(TreeListGetSize(list) == MAX_TREELIST_SIZE);
+    assert(TreeListGetFirstValue(list) == &array[0]);
+    assert(TreeListGetLastValue(list)  == &array[MAX_TREELIST_SIZE - 1]);
+    /* tree is balanced */
+    assert(list->root->height <= 18);
+    printf ("size of list : %d\n", TreeListGetSize(list));
+
+    /* test2 : get value by number */
+    printf ("--------test2--------\n");
+    for (unsigned i = 0; i < MAX_TREELIST_SIZE; ++i)
+        assert(TreeListGetValueByNumber(list, i) == &array[i]);
+    assert(TreeListGetValueByNumber(list, MAX_TREELIST_SIZE) == NULL);
+    printf ("passed!\n");
+
+    /* test3 : insert in the middle and at the head */
+    printf ("--------test3--------\n");
+    int extra[2] = {-1, -2};
+    assert(TreeListInsertElement(list, 100, &extra[0]));
+    assert(TreeListInsertElement(list, 0,   &extra[1]));
+    assert(TreeListGetValueByNumber(list, 0)   == &extra[1]);
+    assert(TreeListGetValueByNumber(list, 101) == &extra[0]);
+    assert(TreeListGetValueByNumber(list, 102) == &array[100]);
+    assert(TreeListGetNumberByValue(list, &extra[0]) == 101);
+    assert(!TreeListInsertElement(list, MAX_TREELIST_SIZE + 10, &extra[0]));
+    printf ("passed!\n");
+
+    /* test4 : delete values */
+    printf ("--------test4--------\n");
+    TreeListDeleteElementByNumber(list, 0);
+    TreeListDeleteElementByValue(list, &extra[0]);
+    TreeListPopBack(list);
+    assert(TreeListGetSize(list) == MAX_TREELIST_SIZE - 1);
+    for (unsigned i = 0; i < MAX_TREELIST_SIZE - 1; ++i)
+        assert(TreeListGetValueByNumber(list, i) == &array[i]);
+    printf ("passed!\n");
+
+    /* test5 : delete every second value from the head */
+    printf ("--------test5--------\n");
+    for (unsigned i = 0; i < TreeListGetSize(list); ++i)
+        TreeListDeleteElementByNumber(list, i);
+    for (unsigned i = 0; i < TreeListGetSize(list); ++i)
+        assert(TreeListGetValueByNumber(list, i) == &array[2 * i + 1]);
+    printf ("passed!\n");
+
+    /* test6 : set value, clear and destroy */
+    printf ("--------test6--------\n");
+    TreeListSetValueByNumber(list, 3, &array[0]);
+    assert(TreeListGetValueByNumber(list, 3) == &array[0]);
+    TreeListClear(list);
+    assert(TreeListIsEmpty(list));
+    assert(TreeListGetFirstValue(list) == NULL);
+    TreeListDestroy(&list);
+    assert(list == NULL);
+    printf ("passed!\n");
+
+    free(array);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all tree list's tests are passed!\n");
+}
+#endif // _DEBUG
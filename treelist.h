@@ -0,0 +1,101 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __TREELIST_H
+#define __TREELIST_H
+
+#define __TREELIST_ID 1953720660   /* 'T' 'L' 'i' 's' */
+
+/* node of balanced tree, position of node is count of nodes on the left */
+typedef struct TreeListNode_tag
+{
+    void* value;
+
+    struct TreeListNode_tag* left;
+    struct TreeListNode_tag* right;
+
+    unsigned count;     /* nodes in subtree */
+    int      height;    /* height of subtree */
+} TreeListNode;
+
+/* list as AVL-tree with counts of subtrees - access, insertion and deletion by position take O(log n) */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of TreeListCreate from AllocMemory, else of malloc */
+
+    unsigned size;
+
+    TreeListNode* root;
+
+    void* (*front)(void* this);
+    void* (*back) (void* this);
+    bool  (*push_back)(void* this, void* value);
+    void  (*pop_back) (void* this);
+    bool  (*empty)(void* this);
+    void  (*clear)(void* this);
+    void* (*at)(void* this, unsigned position);
+} TreeList;
+
+/** init memory as tree list */
+void TreeListInit(void* mem);
+/** create tree list and return pointer to list */
+TreeList* TreeListCreate ();
+/** delete all values in list */
+void TreeListClear (TreeList* list);
+/** clear and destroy list */
+void TreeListDestroy (TreeList** list);
+
+/** add value to end of list, return false if not */
+bool TreeListAddElement (TreeList* list, void* value);
+/** insert value before position (size - to the end), return false if not */
+bool TreeListInsertElement (TreeList* list, unsigned numOfElement, void* value);
+/** delete value from list */
+void TreeListDeleteElementByValue (TreeList* list, void* value);
+/** delete value from list by position in list */
+void TreeListDeleteElementByNumber (TreeList* list, unsigned numOfElement);
+/** delete last value from list */
+void TreeListPopBack(TreeList* list);
+
+/* GETTERS */
+/** get first value from list */
+void* TreeListGetFirstValue(TreeList* list);
+/** get last value from list */
+void* TreeListGetLastValue(TreeList* list);
+/** return value by number in list */
+void* TreeListGetValueByNumber (TreeList* list, unsigned numOfElement);
+/** return number of value in list (if exists), else return -1 */
+int TreeListGetNumberByValue (TreeList* list, const void* value);
+
+/** get count of values in list */
+unsigned TreeListGetSize (TreeList* list);
+/** check empty list */
+bool TreeListIsEmpty(TreeList* list);
+
+/* SETTERS */
+/** set value by position in list */
+void TreeListSetValueByNumber(TreeList* list, unsigned numOfElement, void* value);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void TreeListTest();
+#endif // _DEBUG
+
+#endif // __TREELIST_H
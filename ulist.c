@@ -0,0 +1,428 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ulist.h"
+#include "alloc.h"
+
+
+#define ULIST_CHECK_VALID                           \
+                if (!list) return 0;                \
+                unsigned id = *(unsigned*)list;     \
+                if (id != __ULIST_ID) return 0;
+
+
+/* find node with value by position, offset - position in node */
+static UListNode* UListGetNodeByNumber (UList* list, unsigned numOfElement, unsigned* offset)
+{
+    if (numOfElement >= list->size)
+        return NULL;
+
+    UListNode* node = NULL;
+    /* check which way is faster - from the head or from the tail */
+    if ((list->size - numOfElement) >= numOfElement)
+    {
+        /* go from head */
+        node = list->first;
+        while (node && numOfElement >= node->count)
+        {
+            numOfElement -= node->count;
+            node = node->next;
+        }
+    }
+    else
+    {
+        /* go from tail, count positions from the end */
+        unsigned fromEnd = list->size - 1 - numOfElement;
+        node = list->last;
+        while (node && fromEnd >= node->count)
+        {
+            fromEnd -= node->count;
+            node = node->prev;
+        }
+        if (node)
+            numOfElement = node->count - 1 - fromEnd;
+    }
+
+    if (node && offset)
+        *offset = numOfElement;
+
+    return node;
+}
+
+static void UListUnlinkNode (UList* list, UListNode* node)
+{
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        list->first = node->next;
+
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        list->last = node->prev;
+
+    free (node);
+}
+
+/* delete value from node and keep nodes at least half full */
+static void UListDeleteFromNode (UList* list, UListNode* node, unsigned offset)
+{
+    --node->count;
+    --list->size;
+    memmove(&node->values[offset],
+            &node->values[offset + 1],
+            (node->count - offset) * sizeof(void*));
+
+    if (node->count == 0)
+    {
+        UListUnlinkNode(list, node);
+        return;
+    }
+
+    /* merge with next node if both fit in one */
+    UListNode* next = node->next;
+    if (next &&
+        node->count < ULIST_NODE_CAPACITY / 2 &&
+        node->count + next->count <= ULIST_NODE_CAPACITY)
+    {
+        memcpy(&node->values[node->count], next->values, next->count * sizeof(void*));
+        node->count += next->count;
+        UListUnlinkNode(list, next);
+    }
+}
+
+
+void UListInit(void* mem)
+{
+    if (mem)
+    {
+        UList* list = mem;
+
+        /* already initialized? */
+        if (list->__id == __ULIST_ID)
+        {
+            UListClear(list);
+        }
+        else
+        {
+            memset(list, 0, sizeof(UList));
+
+            list->__id      = __ULIST_ID;
+
+            list->front     = &UListGetFirstValue;
+            list->back      = &UListGetLastValue;
+            list->push_back = &UListAddElement;
+            list->pop_back  = &UListPopBack;
+            list->at        = &UListGetValueByNumber;
+            list->clear     = &UListClear;
+            list->empty     = &UListIsEmpty;
+        }
+    }
+}
+
+UList* UListCreate()
+{
+    UList* list = AllocMemory(ALLOC_TYPE_ULIST, sizeof(UList), 1);
+    if (list == NULL)
+        return NULL;
+
+    list->__id = 0;
+    UListInit(list);
+    list->__alloc = true;
+
+    return list;
+}
+
+void UListClear(UList* list)
+{
+    ULIST_CHECK_VALID
+
+    UListNode* node = list->first;
+    while (node)
+    {
+        UListNode* next = node->next;
+        free (node);
+        node = next;
+    }
+
+    list->first = NULL;
+    list->last  = NULL;
+    list->size  = 0;
+}
+
+/* release nodes of list, called by delete() */
+static void UListFinalize (void* object)
+{
+    UList* list = object;
+
+    UListClear(list);
+
+    list->__id = 0;
+}
+
+static void __attribute__((constructor)) UListRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_ULIST, UListFinalize);
+}
+
+void UListDestroy (UList** list)
+{
+    if (!list || !(*list))
+        return;
+
+    /* memory of UListInit is released by free() */
+    bool alloc = (*list)->__alloc;
+    UListFinalize(*list);
+
+    if (alloc)
+        AllocFree(*list);
+    else
+        free (*list);
+    *list = NULL;
+}
+
+bool UListAddElement (UList* list, void* value)
+{
+    ULIST_CHECK_VALID
+
+    UListNode* node = list->last;
+    if (node == NULL || node->count == ULIST_NODE_CAPACITY)
+    {
+        node = malloc(sizeof(UListNode));
+        if (node == NULL)
+            return false;
+
+        node->count = 0;
+        node->next  = NULL;
+        node->prev  = list->last;
+
+        /* if it is first node */
+        if (list->last == NULL)
+            list->first = node;
+        else
+            list->last->next = node;
+        list->last = node;
+    }
+
+    node->values[node->count++] = value;
+    ++list->size;
+
+    return true;
+}
+
+void UListDeleteElementByValue (UList* list, void* value)
+{
+    ULIST_CHECK_VALID
+
+    if (value == NULL)
+        return;
+
+    for (UListNode* node = list->first; node; node = node->next)
+    {
+        for (unsigned i = 0; i < node->count; ++i)
+        {
+            if (node->values[i] == value)
+            {
+                UListDeleteFromNode(list, node, i);
+                return;
+            }
+        }
+    }
+}
+
+void UListDeleteElementByNumber (UList* list, unsigned numOfElement)
+{
+    ULIST_CHECK_VALID
+
+    unsigned offset = 0;
+    UListNode* node = UListGetNodeByNumber(list, numOfElement, &offset);
+    if (node)
+        UListDeleteFromNode(list, node, offset);
+}
+
+void UListPopBack(UList* list)
+{
+    ULIST_CHECK_VALID
+
+    if (list->size > 0)
+        UListDeleteFromNode(list, list->last, list->last->count - 1);
+}
+
+void* UListGetFirstValue(UList* list)
+{
+    ULIST_CHECK_VALID
+
+    if (list->first)
+        return list->first->values[0];
+    return NULL;
+}
+
+void* UListGetLastValue(UList* list)
+{
+    ULIST_CHECK_VALID
+
+    if (list->last)
+        return list->last->values[list->last->count - 1];
+    return NULL;
+}
+
+void* UListGetValueByNumber (UList* list, unsigned numOfElement)
+{
+    ULIST_CHECK_VALID
+
+    unsigned offset = 0;
+    UListNode* node = UListGetNodeByNumber(list, numOfElement, &offset);
+    if (!node)
+        return NULL;
+
+    return node->values[offset];
+}
+
+int UListGetNumberByValue (UList* list, const void* value)
+{
+    if (!list || !value)
+        return -1;
+
+    int num = 0;
+    for (UListNode* node = list->first; node; node = node->next)
+    {
+        /* values of node lie in one array - scan it without pointer chasing */
+        for (unsigned i = 0; i < node->count; ++i)
+        {
+            if (node->values[i] == value)
+                return num + i;
+        }
+        num += node->count;
+    }
+
+    return -1;
+}
+
+unsigned UListGetSize (UList* list)
+{
+    ULIST_CHECK_VALID
+
+    return list->size;
+}
+
+bool UListIsEmpty(UList* list)
+{
+    ULIST_CHECK_VALID
+
+    return (list->size == 0);
+}
+
+void UListSetValueByNumber(UList* list, unsigned numOfElement, void* value)
+{
+    ULIST_CHECK_VALID
+
+    if (value == NULL)
+        return;
+
+    unsigned offset = 0;
+    UListNode* node = UListGetNodeByNumber(list, numOfElement, &offset);
+    if (node)
+        node->values[offset] = value;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#define MAX_ULIST_SIZE 6000
+void UListTest()
+{
+    printf ("UList's tests started!!!\n");
+
+    int* array = malloc(MAX_ULIST_SIZE*sizeof(int));
+    UList* list = UListCreate();
+
+    /* test1 : fill list */
+    printf ("--------test1--------\n");
+    for (unsigned i = 0; i < MAX_ULIST_SIZE; ++i)
+    {
+        array[i] = i;
+        assert(UListAddElement(list, &array[i]));
+    }
+    assert(UListGetSize(list) == MAX_ULIST_SIZE);
+    assert(UListGetFirstValue(list) == &array[0]);
+    assert(UListGetLastValue(list)  == &array[MAX_ULIST_SIZE - 1]);
+    printf ("size of list : %d\n", UListGetSize(list));
+
+    /* test2 : get value by number from head and tail */
+    printf ("--------test2--------\n");
+    for (unsigned i = 0; i < MAX_ULIST_SIZE; ++i)
+        assert(UListGetValueByNumber(list, i) == &array[i]);
+    assert(UListGetValueByNumber(list, MAX_ULIST_SIZE) == NULL);
+    printf ("passed!\n");
+
+    /* test3 : get number by value */
+    printf ("--------test3--------\n");
+    for (unsigned i = 0; i < MAX_ULIST_SIZE; i += 7)
+        assert(UListGetNumberByValue(list, &array[i]) == (int)i);
+    printf ("passed!\n");
+
+    /* test4 : delete values */
+    printf ("--------test4--------\n");
+    UListDeleteElementByNumber(list, 0);
+    UListDeleteElementByValue(list, &array[100]);
+    UListPopBack(list);
+    assert(UListGetSize(list) == MAX_ULIST_SIZE - 3);
+    assert(UListGetFirstValue(list) == &array[1]);
+    assert(UListGetLastValue(list)  == &array[MAX_ULIST_SIZE - 2]);
+    assert(UListGetNumberByValue(list, &array[100]) == -1);
+    assert(UListGetValueByNumber(list, 99) == &array[101]);
+    printf ("passed!\n");
+
+    /* test5 : delete every second value */
+    printf ("--------test5--------\n");
+    for (unsigned i = 1; i < MAX_ULIST_SIZE - 1; i += 2)
+        UListDeleteElementByValue(list, &array[i]);
+    for (unsigned i = 0; i < UListGetSize(list); ++i)
+        assert(*(int*)UListGetValueByNumber(list, i) % 2 == 0);
+    printf ("passed!\n");
+
+    /* test6 : set value */
+    printf ("--------test6--------\n");
+    UListSetValueByNumber(list, 3, &array[1]);
+    assert(UListGetValueByNumber(list, 3) == &array[1]);
+    printf ("passed!\n");
+
+    /* test7 : clear and destroy */
+    printf ("--------test7--------\n");
+    UListClear(list);
+    assert(UListIsEmpty(list));
+    assert(UListGetFirstValue(list) == NULL);
+    UListDestroy(&list);
+    assert(list == NULL);
+    printf ("passed!\n");
+
+    free(array);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all unrolled list's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,102 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __ULIST_H
+#define __ULIST_H
+
+#define __ULIST_ID 1953720661   /* 'U' 'L' 'i' 's' */
+
+/* count of values in one node, node with 29 values takes 256 bytes */
+#ifndef ULIST_NODE_CAPACITY
+    #define ULIST_NODE_CAPACITY 29
+#endif // ULIST_NODE_CAPACITY
+
+typedef struct UListNode_tag
+{
+    struct UListNode_tag* prev;
+    struct UListNode_tag* next;
+
+    unsigned count;                         /* used values in node */
+    void* values[ULIST_NODE_CAPACITY];
+} UListNode;
+
+/* unrolled doubly-linked list - each node keeps several values */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of UListCreate from AllocMemory, else of malloc */
+
+    unsigned size;
+
+    UListNode* first;          /* head */
+    UListNode* last;           /* tail */
+
+    void* (*front)(void* this);
+    void* (*back) (void* this);
+    bool  (*push_back)(void* this, void* value);
+    void  (*pop_back) (void* this);
+    bool  (*empty)(void* this);
+    void  (*clear)(void* this);
+    void* (*at)(void* this, unsigned position);
+} UList;
+
+/** init memory as unrolled list */
+void UListInit(void* mem);
+/** create unrolled list and return pointer to list */
+UList* UListCreate ();
+/** delete all values in list */
+void UListClear (UList* list);
+/** clear and destroy list */
+void UListDestroy (UList** list);
+
+/** add value to end of list, return false if not */
+bool UListAddElement (UList* list, void* value);
+/** delete value from list */
+void UListDeleteElementByValue (UList* list, void* value);
+/** delete value from list by position in list */
+void UListDeleteElementByNumber (UList* list, unsigned numOfElement);
+/** delete last value from list */
+void UListPopBack(UList* list);
+
+/* GETTERS */
+/** get first value from list */
+void* UListGetFirstValue(UList* list);
+/** get last value from list */
+void* UListGetLastValue(UList* list);
+/** return value by number in list */
+void* UListGetValueByNumber (UList* list, unsigned numOfElement);
+/** return number of value in list (if exists), else return -1 */
+int UListGetNumberByValue (UList* list, const void* value);
+
+/** get count of values in list */
+unsigned UListGetSize (UList* list);
+/** check empty list */
+bool UListIsEmpty(UList* list);
+
+/* SETTERS */
+/** set value by position in list */
+void UListSetValueByNumber(UList* list, unsigned numOfElement, void* value);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void UListTest();
+#endif // _DEBUG
+
+#endif // __ULIST_H
@@ -0,0 +1,771 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utf8.h"
+
+/* UTF-32 in wchar_t (Linux), else UTF-16 with surrogate pairs (Windows) */
+#if WCHAR_MAX > 0xFFFF
+    #define UTF8_WIDE32
+#endif
+
+/* ASCII runs are converted by 16 chars, SSE2 is always there on x86-64 */
+#if defined(__GNUC__) && defined(__SSE2__) && defined(UTF8_WIDE32)
+    #define UTF8_SSE2
+    #include <emmintrin.h>
+#endif
+
+#define UTF8_CHUNK 256      /* wide chars converted at once for strings */
+
+
+/* check 16 bytes for ASCII */
+static inline bool Utf8IsAscii16 (const unsigned char* s)
+{
+#ifdef UTF8_SSE2
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)s)) == 0;
+#else
+    uint64_t a, b;
+    memcpy(&a, s, 8);
+    memcpy(&b, s + 8, 8);
+    return ((a | b) & 0x8080808080808080ull) == 0;
+#endif // UTF8_SSE2
+}
+
+/* 16 ASCII bytes to 16 wide chars */
+static inline void Utf8WidenAscii16 (const unsigned char* s, wchar_t* d)
+{
+#ifdef UTF8_SSE2
+    __m128i zero  = _mm_setzero_si128();
+    __m128i bytes = _mm_loadu_si128((const __m128i*)s);
+    __m128i lo    = _mm_unpacklo_epi8(bytes, zero);
+    __m128i hi    = _mm_unpackhi_epi8(bytes, zero);
+    _mm_storeu_si128((__m128i*)(d),      _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(d + 4),  _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(d + 8),  _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128((__m128i*)(d + 12), _mm_unpackhi_epi16(hi, zero));
+#else
+    for (unsigned i = 0; i < 16; ++i)
+        d[i] = s[i];
+#endif // UTF8_SSE2
+}
+
+/* 16 wide chars to 16 bytes if all of them are ASCII */
+static inline bool Utf8NarrowAscii16 (const wchar_t* s, unsigned char* d)
+{
+#ifdef UTF8_SSE2
+    __m128i a = _mm_loadu_si128((const __m128i*)(s));
+    __m128i b = _mm_loadu_si128((const __m128i*)(s + 4));
+    __m128i c = _mm_loadu_si128((const __m128i*)(s + 8));
+    __m128i e = _mm_loadu_si128((const __m128i*)(s + 12));
+
+    /* any bit above 7 - not ASCII, negative values too */
+    __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, e)), _mm_set1_epi32(~0x7F));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF)
+        return false;
+
+    __m128i words = _mm_packs_epi32(a, b);
+    __m128i rest  = _mm_packs_epi32(c, e);
+    _mm_storeu_si128((__m128i*)d, _mm_packus_epi16(words, rest));
+    return true;
+#else
+    uint32_t high = 0;
+    for (unsigned i = 0; i < 16; ++i)
+        high |= (uint32_t)s[i];
+    if (high & ~0x7Fu)
+        return false;
+
+    for (unsigned i = 0; i < 16; ++i)
+        d[i] = (unsigned char)s[i];
+    return true;
+#endif // UTF8_SSE2
+}
+
+/* return length of sequence, 0 - correct start of sequence is cut by end of text,
+   -n - wrong sequence, n bytes of it must be skipped */
+static int Utf8DecodeSequence (const unsigned char* s, size_t avail, uint32_t* cp)
+{
+    unsigned c = s[0];
+    int n;
+    if (c < 0x80)
+    {
+        *cp = c;
+        return 1;
+    }
+    else if (c >= 0xC2 && c <= 0xDF)
+    {
+        n   = 2;
+        *cp = c & 0x1F;
+    }
+    else if (c >= 0xE0 && c <= 0xEF)
+    {
+        n   = 3;
+        *cp = c & 0x0F;
+    }
+    else if (c >= 0xF0 && c <= 0xF4)
+    {
+        n   = 4;
+        *cp = c & 0x07;
+    }
+    else
+        return -1;
+
+    for (int i = 1; i < n; ++i)
+    {
+        if ((size_t)i >= avail)
+            return 0;
+
+        /* second byte excludes overlong forms, surrogates and chars above U+10FFFF */
+        unsigned lo = 0x80, hi = 0xBF;
+        if (i == 1)
+        {
+            if      (c == 0xE0) lo = 0xA0;
+            else if (c == 0xED) hi = 0x9F;
+            else if (c == 0xF0) lo = 0x90;
+            else if (c == 0xF4) hi = 0x8F;
+        }
+
+        unsigned b = s[i];
+        if (b < lo || b > hi)
+            return -i;
+        *cp = (*cp << 6) | (b & 0x3F);
+    }
+
+    return n;
+}
+
+static inline unsigned Utf8WideLength (uint32_t cp)
+{
+#ifdef UTF8_WIDE32
+    (void)cp;
+    return 1;
+#else
+    return (cp > 0xFFFF) ? 2 : 1;
+#endif // UTF8_WIDE32
+}
+
+static inline wchar_t* Utf8PutWide (wchar_t* d, uint32_t cp)
+{
+#ifndef UTF8_WIDE32
+    if (cp > 0xFFFF)
+    {
+        cp -= 0x10000;
+        *d++ = 0xD800 + (cp >> 10);
+        *d++ = 0xDC00 + (cp & 0x3FF);
+        return d;
+    }
+#endif // UTF8_WIDE32
+    *d++ = cp;
+    return d;
+}
+
+static inline unsigned Utf8SequenceLength (uint32_t cp)
+{
+    return (cp < 0x80) ? 1 : (cp < 0x800) ? 2 : (cp < 0x10000) ? 3 : 4;
+}
+
+static inline char* Utf8PutSequence (char* d, uint32_t cp)
+{
+    if (cp < 0x80)
+        *d++ = cp;
+    else if (cp < 0x800)
+    {
+        *d++ = 0xC0 | (cp >> 6);
+        *d++ = 0x80 | (cp & 0x3F);
+    }
+    else if (cp < 0x10000)
+    {
+        *d++ = 0xE0 | (cp >> 12);
+        *d++ = 0x80 | ((cp >> 6) & 0x3F);
+        *d++ = 0x80 | (cp & 0x3F);
+    }
+    else
+    {
+        *d++ = 0xF0 | (cp >> 18);
+        *d++ = 0x80 | ((cp >> 12) & 0x3F);
+        *d++ = 0x80 | ((cp >> 6) & 0x3F);
+        *d++ = 0x80 | (cp & 0x3F);
+    }
+
+    return d;
+}
+
+
+void Utf8DecoderInit (Utf8Decoder* decoder, bool replace)
+{
+    if (!decoder)
+        return;
+
+    memset(decoder, 0, sizeof(Utf8Decoder));
+    decoder->replace = replace;
+}
+
+/* finish sequence of previous part, return UTF8_OK if decoding can go on */
+static Utf8Result Utf8DecodePending (Utf8Decoder* decoder, const unsigned char** src, const unsigned char* end,
+                                     wchar_t** dst, wchar_t* dstEnd, bool last)
+{
+    unsigned char seq[4];
+    unsigned count = decoder->pendingCount;
+    memcpy(seq, decoder->pending, count);
+
+    unsigned taken = 0;
+    while (count < 4 && *src + taken < end)
+        seq[count++] = (*src)[taken++];
+
+    uint32_t cp;
+    int n = Utf8DecodeSequence(seq, count, &cp);
+    if (n == 0)
+    {
+        /* still cut, wait for next part */
+        if (!last)
+        {
+            memcpy(decoder->pending, seq, count);
+            decoder->pendingCount = count;
+            *src += taken;
+            return UTF8_OK;
+        }
+        n = -(int)count;
+    }
+
+    if (n < 0)
+    {
+        if (!decoder->replace)
+        {
+            decoder->pendingCount = 0;
+            return UTF8_INVALID;
+        }
+        cp = UTF8_REPLACEMENT;
+        n  = -n;
+    }
+
+    if ((size_t)(dstEnd - *dst) < Utf8WideLength(cp))
+        return UTF8_NO_ROOM;
+
+    /* pending bytes are valid start, so sequence always takes all of them */
+    *dst = Utf8PutWide(*dst, cp);
+    *src += n - decoder->pendingCount;
+    decoder->pendingCount = 0;
+
+    return UTF8_OK;
+}
+
+Utf8Result Utf8Decode (Utf8Decoder* decoder, const char** src, const char* srcEnd,
+                       wchar_t** dst, wchar_t* dstEnd, bool last)
+{
+    if (!decoder || !src || !*src || !dst || !*dst)
+        return UTF8_INVALID;
+
+    const unsigned char* s   = (const unsigned char*)*src;
+    const unsigned char* end = (const unsigned char*)srcEnd;
+    wchar_t* d = *dst;
+
+    Utf8Result result = UTF8_OK;
+    if (decoder->pendingCount)
+    {
+        result = Utf8DecodePending(decoder, &s, end, &d, dstEnd, last);
+        if (result != UTF8_OK || decoder->pendingCount)
+        {
+            *src = (const char*)s;
+            *dst = d;
+            return result;
+        }
+    }
+
+    while (s < end)
+    {
+        unsigned c = *s;
+        if (c < 0x80)
+        {
+            /* ASCII runs, single ASCII char between letters is not worth a check */
+            if (end - s >= 16 && s[1] < 0x80 && dstEnd - d >= 16 && Utf8IsAscii16(s))
+            {
+                Utf8WidenAscii16(s, d);
+                s += 16;
+                d += 16;
+                continue;
+            }
+
+            if (d == dstEnd)
+            {
+                result = UTF8_NO_ROOM;
+                break;
+            }
+            *d++ = c;
+            ++s;
+            continue;
+        }
+
+        /* 2 and 3 bytes of Cyrillic, Greek, CJK etc. without checks of general case */
+        if (end - s >= 3 && d < dstEnd)
+        {
+            unsigned b1 = s[1];
+            if (c >= 0xC2 && c <= 0xDF && (b1 & 0xC0) == 0x80)
+            {
+                *d++ = ((c & 0x1F) << 6) | (b1 & 0x3F);
+                s += 2;
+                continue;
+            }
+
+            unsigned b2 = s[2];
+            if (c >= 0xE1 && c <= 0xEC && (b1 & 0xC0) == 0x80 && (b2 & 0xC0) == 0x80)
+            {
+                *d++ = ((c & 0x0F) << 12) | ((b1 & 0x3F) << 6) | (b2 & 0x3F);
+                s += 3;
+                continue;
+            }
+        }
+
+        uint32_t cp;
+        int n = Utf8DecodeSequence(s, end - s, &cp);
+        if (n == 0)
+        {
+            /* sequence is cut by end of part */
+            if (!last)
+            {
+                decoder->pendingCount = end - s;
+                memcpy(decoder->pending, s, decoder->pendingCount);
+                s = end;
+                break;
+            }
+            n = -(int)(end - s);
+        }
+
+        if (n < 0)
+        {
+            if (!decoder->replace)
+            {
+                result = UTF8_INVALID;
+                break;
+            }
+            cp = UTF8_REPLACEMENT;
+            n  = -n;
+        }
+
+        if ((size_t)(dstEnd - d) < Utf8WideLength(cp))
+        {
+            result = UTF8_NO_ROOM;
+            break;
+        }
+        d  = Utf8PutWide(d, cp);
+        s += n;
+    }
+
+    *src = (const char*)s;
+    *dst = d;
+
+    return result;
+}
+
+void Utf8EncoderInit (Utf8Encoder* encoder, bool replace)
+{
+    if (!encoder)
+        return;
+
+    memset(encoder, 0, sizeof(Utf8Encoder));
+    encoder->replace = replace;
+}
+
+Utf8Result Utf8Encode (Utf8Encoder* encoder, const wchar_t** src, const wchar_t* srcEnd,
+                       char** dst, char* dstEnd, bool last)
+{
+    if (!encoder || !src || !*src || !dst || !*dst)
+        return UTF8_INVALID;
+#ifdef UTF8_WIDE32
+    (void)last;     /* only surrogate pairs may be cut between parts */
+#endif // UTF8_WIDE32
+
+    const wchar_t* s = *src;
+    char* d = *dst;
+    Utf8Result result = UTF8_OK;
+
+    while (s < srcEnd || encoder->pendingHigh)
+    {
+        if (!encoder->pendingHigh)
+        {
+            uint32_t c = (uint32_t)*s;
+
+            /* ASCII runs */
+            if (c < 0x80 && srcEnd - s >= 16 && (uint32_t)s[1] < 0x80 &&
+                dstEnd - d >= 16 && Utf8NarrowAscii16(s, (unsigned char*)d))
+            {
+                s += 16;
+                d += 16;
+                continue;
+            }
+
+            /* plain chars of BMP without checks of general case */
+            if (dstEnd - d >= 3)
+            {
+                if (c < 0x80)
+                {
+                    *d++ = c;
+                    ++s;
+                    continue;
+                }
+                if (c < 0x800)
+                {
+                    *d++ = 0xC0 | (c >> 6);
+                    *d++ = 0x80 | (c & 0x3F);
+                    ++s;
+                    continue;
+                }
+                if (c < 0xD800 || (c > 0xDFFF && c < 0x10000))
+                {
+                    *d++ = 0xE0 | (c >> 12);
+                    *d++ = 0x80 | ((c >> 6) & 0x3F);
+                    *d++ = 0x80 | (c & 0x3F);
+                    ++s;
+                    continue;
+                }
+            }
+        }
+
+        uint32_t cp;
+        unsigned used = 1;
+        bool valid;
+#ifdef UTF8_WIDE32
+        cp    = (uint32_t)*s;
+        valid = (cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF));
+#else
+        /* high surrogate of previous part is waiting for low one */
+        uint32_t high = encoder->pendingHigh;
+        if (high)
+            used = 0;
+        else
+        {
+            high = (uint16_t)*s;
+            if (high < 0xD800 || high > 0xDBFF)
+                high = 0;
+        }
+
+        if (high)
+        {
+            if (s + used < srcEnd)
+            {
+                uint32_t low = (uint16_t)s[used];
+                valid = (low >= 0xDC00 && low <= 0xDFFF);
+                cp    = (valid) ? 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00) : high;
+                if (valid)
+                    ++used;
+            }
+            else if (!last)
+            {
+                /* wait for next part */
+                encoder->pendingHigh = high;
+                s += used;
+                break;
+            }
+            else
+            {
+                cp    = high;
+                valid = false;
+            }
+        }
+        else
+        {
+            cp    = (uint16_t)*s;
+            valid = (cp < 0xDC00 || cp > 0xDFFF);
+        }
+#endif // UTF8_WIDE32
+
+        if (!valid)
+        {
+            if (!encoder->replace)
+            {
+                result = UTF8_INVALID;
+                break;
+            }
+            cp = UTF8_REPLACEMENT;
+        }
+
+        if ((size_t)(dstEnd - d) < Utf8SequenceLength(cp))
+        {
+            result = UTF8_NO_ROOM;
+            break;
+        }
+        d  = Utf8PutSequence(d, cp);
+        s += used;
+        encoder->pendingHigh = 0;
+    }
+
+    *src = s;
+    *dst = d;
+
+    return result;
+}
+
+size_t Utf8Validate (const char* chars, size_t length)
+{
+    if (!chars)
+        return 0;
+
+    const unsigned char* s   = (const unsigned char*)chars;
+    const unsigned char* end = s + length;
+    while (s < end)
+    {
+        while (end - s >= 16 && Utf8IsAscii16(s))
+            s += 16;
+        if (s == end)
+            break;
+
+        if (*s < 0x80)
+        {
+            ++s;
+            continue;
+        }
+
+        uint32_t cp;
+        int n = Utf8DecodeSequence(s, end - s, &cp);
+        if (n <= 0)
+            break;
+        s += n;
+    }
+
+    return s - (const unsigned char*)chars;
+}
+
+bool Utf8ToWString (WString* str, const char* chars, size_t length)
+{
+    if (!str || !chars)
+        return false;
+
+    /* wide text is never longer than UTF-8 one */
+    if (length < UINT32_MAX - WStringGetLength(str))
+        WStringReserve(str, WStringGetLength(str) + length);
+
+    Utf8Decoder decoder;
+    Utf8DecoderInit(&decoder, true);
+
+    const char* end = chars + length;
+    for (;;)
+    {
+        wchar_t buf[UTF8_CHUNK];
+        wchar_t* d = buf;
+        Utf8Result result = Utf8Decode(&decoder, &chars, end, &d, buf + UTF8_CHUNK, true);
+        if (!WStringAppendChars(str, buf, d - buf))
+            return false;
+        if (result != UTF8_NO_ROOM)
+            return true;
+    }
+}
+
+bool Utf8FromWString (String* str, const wchar_t* chars, size_t length)
+{
+    if (!str || !chars)
+        return false;
+
+    Utf8Encoder encoder;
+    Utf8EncoderInit(&encoder, true);
+
+    const wchar_t* end = chars + length;
+    for (;;)
+    {
+        char buf[UTF8_CHUNK * 4];
+        char* d = buf;
+        Utf8Result result = Utf8Encode(&encoder, &chars, end, &d, buf + sizeof(buf), true);
+        if (!StringAppendChars(str, buf, d - buf))
+            return false;
+        if (result != UTF8_NO_ROOM)
+            return true;
+    }
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+/* decode whole text at once, return count of wide chars or -1 */
+static int Utf8TestDecode (const char* text, size_t length, wchar_t* out, size_t capacity, bool replace)
+{
+    Utf8Decoder decoder;
+    Utf8DecoderInit(&decoder, replace);
+    wchar_t* d = out;
+    if (Utf8Decode(&decoder, &text, text + length, &d, out + capacity, true) != UTF8_OK)
+        return -1;
+    return d - out;
+}
+
+void Utf8Test()
+{
+    printf ("UTF-8's tests started!!!\n");
+
+    /* test1 : every char there and back */
+    printf ("--------test1--------\n");
+    wchar_t* wide = malloc(0x110000 * sizeof(wchar_t) * 2);
+    char*    text = malloc(0x110000 * 4);
+    size_t count = 0;
+    for (uint32_t cp = 1; cp < 0x110000; ++cp)
+    {
+        if (cp >= 0xD800 && cp <= 0xDFFF)
+            continue;
+        wide[count] = 0;
+        count = Utf8PutWide(wide + count, cp) - wide;
+    }
+
+    Utf8Encoder encoder;
+    Utf8EncoderInit(&encoder, false);
+    const wchar_t* ws = wide;
+    char* d = text;
+    assert(Utf8Encode(&encoder, &ws, wide + count, &d, text + 0x110000 * 4, true) == UTF8_OK);
+    size_t length = d - text;
+    assert(Utf8Validate(text, length) == length);
+
+    wchar_t* back = malloc(0x110000 * sizeof(wchar_t) * 2);
+    assert(Utf8TestDecode(text, length, back, 0x110000 * 2, false) == (int)count);
+    assert(memcmp(back, wide, count * sizeof(wchar_t)) == 0);
+    printf ("passed!\n");
+
+    /* test2 : wrong sequences */
+    printf ("--------test2--------\n");
+    struct
+    {
+        const char* text;
+        int         count;      /* wide chars with replace */
+        size_t      valid;      /* correct bytes at start */
+    } wrong[] =
+    {
+        {"\xC0\x80",          2, 0},      /* overlong */
+        {"\xE0\x80\x80",      3, 0},      /* overlong */
+        {"\xED\xA0\x80",      3, 0},      /* surrogate */
+        {"\xF4\x90\x80\x80",  4, 0},      /* above U+10FFFF */
+        {"a\x80" "b",         3, 1},      /* lone continuation */
+        {"ab\xE2\x82",        3, 2},      /* cut at the end */
+        {"\xE2\x82" "a",      2, 0},      /* cut by ASCII */
+        {"\xFF",              1, 0},
+    };
+    wchar_t out[16];
+    for (unsigned i = 0; i < sizeof(wrong) / sizeof(wrong[0]); ++i)
+    {
+        size_t len = strlen(wrong[i].text);
+        assert(Utf8Validate(wrong[i].text, len) == wrong[i].valid);
+        assert(Utf8TestDecode(wrong[i].text, len, out, 16, false) == -1);
+        assert(Utf8TestDecode(wrong[i].text, len, out, 16, true) == wrong[i].count);
+    }
+    assert(Utf8TestDecode("\xE2\x82" "a", 3, out, 16, true) == 2 && out[0] == UTF8_REPLACEMENT && out[1] == L'a');
+
+    /* wrong wide chars */
+    wchar_t bad[] = {L'a', (wchar_t)0xDC00, L'b'};
+    Utf8EncoderInit(&encoder, false);
+    ws = bad;
+    char bytes[16];
+    d = bytes;
+    assert(Utf8Encode(&encoder, &ws, bad + 3, &d, bytes + 16, true) == UTF8_INVALID);
+    assert(ws == bad + 1 && d == bytes + 1);
+    Utf8EncoderInit(&encoder, true);
+    ws = bad;
+    d = bytes;
+    assert(Utf8Encode(&encoder, &ws, bad + 3, &d, bytes + 16, true) == UTF8_OK);
+    assert(d - bytes == 5 && memcmp(bytes, "a\xEF\xBF\xBD" "b", 5) == 0);
+    printf ("passed!\n");
+
+    /* test3 : parts of one byte and output of one char give the same text */
+    printf ("--------test3--------\n");
+    const char* mixed = "ASCII text long enough for fast path, Привет мир, 日本語, \xF0\x9F\x98\x80 and more ASCII at the end!!";
+    size_t mixedLength = strlen(mixed);
+    wchar_t whole[128];
+    int wholeCount = Utf8TestDecode(mixed, mixedLength, whole, 128, false);
+    assert(wholeCount > 0);
+
+    Utf8Decoder decoder;
+    Utf8DecoderInit(&decoder, false);
+    wchar_t parts[128];
+    wchar_t* pd = parts;
+    for (size_t i = 0; i < mixedLength; ++i)
+    {
+        const char* s = mixed + i;
+        assert(Utf8Decode(&decoder, &s, mixed + i + 1, &pd, parts + 128, i + 1 == mixedLength) == UTF8_OK);
+        assert(s == mixed + i + 1);
+    }
+    assert(pd - parts == wholeCount);
+    assert(memcmp(parts, whole, wholeCount * sizeof(wchar_t)) == 0);
+
+    /* output with room for one char at once */
+    Utf8DecoderInit(&decoder, false);
+    const char* s = mixed;
+    pd = parts;
+    Utf8Result result;
+    do
+    {
+        wchar_t* limit = pd + 1;
+        result = Utf8Decode(&decoder, &s, mixed + mixedLength, &pd, limit, true);
+        assert(result != UTF8_INVALID);
+    }
+    while (result == UTF8_NO_ROOM);
+    assert(pd - parts == wholeCount);
+    assert(memcmp(parts, whole, wholeCount * sizeof(wchar_t)) == 0);
+
+    /* and back by parts of one wide char */
+    Utf8EncoderInit(&encoder, false);
+    char again[256];
+    d = again;
+    for (int i = 0; i < wholeCount; ++i)
+    {
+        ws = whole + i;
+        assert(Utf8Encode(&encoder, &ws, whole + i + 1, &d, again + 256, i + 1 == wholeCount) == UTF8_OK);
+    }
+    assert((size_t)(d - again) == mixedLength && memcmp(again, mixed, mixedLength) == 0);
+
+    /* non-ASCII char at every place of ASCII run */
+    for (unsigned pos = 0; pos < 39; ++pos)
+    {
+        char run[48];
+        memset(run, 'x', 41);
+        memcpy(run + pos, "\xC3\xA9", 2);
+        wchar_t w[48];
+        assert(Utf8TestDecode(run, 41, w, 48, false) == 40);
+        assert(w[pos] == 0xE9 && w[pos + 1] == L'x' && (pos == 0 || w[pos - 1] == L'x'));
+    }
+    printf ("passed!\n");
+
+    /* test4 : strings */
+    printf ("--------test4--------\n");
+    WString* wstr = WStringCreate();
+    assert(Utf8ToWString(wstr, mixed, mixedLength));
+    assert(WStringGetLength(wstr) == (unsigned)wholeCount);
+    assert(wmemcmp(WStringGetChars(wstr), whole, wholeCount) == 0);
+    String* str = StringCreate();
+    assert(Utf8FromWString(str, WStringGetChars(wstr), WStringGetLength(wstr)));
+    assert(StringCompare(str, mixed) == 0);
+
+    /* text longer than one chunk */
+    StringClear(str);
+    WStringClear(wstr);
+    assert(Utf8ToWString(wstr, text, length));
+    assert(WStringGetLength(wstr) == count);
+    assert(Utf8FromWString(str, WStringGetChars(wstr), WStringGetLength(wstr)));
+    assert(StringGetLength(str) == length && memcmp(StringGetChars(str), text, length) == 0);
+    StringDestroy(&str);
+    WStringDestroy(&wstr);
+
+    free(wide);
+    free(back);
+    free(text);
+    printf ("passed!\n");
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all UTF-8's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,84 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+
+
+#ifndef __UTF8_H
+#define __UTF8_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <wchar.h>
+
+#include "str.h"
+
+#define UTF8_REPLACEMENT 0xFFFD     /* written instead of wrong sequence */
+
+/* result of conversion of part of text */
+typedef enum
+{
+    UTF8_OK = 0,                    /* all input is converted or kept in state */
+    UTF8_NO_ROOM,                   /* output is full, call again with more room */
+    UTF8_INVALID                    /* wrong sequence at *src, only without replace */
+} Utf8Result;
+
+/* state of UTF-8 decoding between parts of text */
+typedef struct
+{
+    unsigned char pending[4];       /* start of sequence cut by end of part */
+    unsigned      pendingCount;
+    bool          replace;          /* wrong sequences become UTF8_REPLACEMENT */
+} Utf8Decoder;
+
+/* state of UTF-8 encoding between parts of text */
+typedef struct
+{
+    uint32_t pendingHigh;           /* high surrogate, waits for low one (16-bit wchar_t) */
+    bool     replace;               /* wrong chars become UTF8_REPLACEMENT */
+} Utf8Encoder;
+
+/** reset decoder before new text */
+void Utf8DecoderInit (Utf8Decoder* decoder, bool replace);
+/** convert UTF-8 from [*src, srcEnd) to wchar_t in [*dst, dstEnd), pointers are moved after done part.
+    Sequence cut by srcEnd is kept in decoder until next part, last - no more parts */
+Utf8Result Utf8Decode (Utf8Decoder* decoder, const char** src, const char* srcEnd,
+                       wchar_t** dst, wchar_t* dstEnd, bool last);
+
+/** reset encoder before new text */
+void Utf8EncoderInit (Utf8Encoder* encoder, bool replace);
+/** convert wchar_t from [*src, srcEnd) to UTF-8 in [*dst, dstEnd), pointers are moved after done part */
+Utf8Result Utf8Encode (Utf8Encoder* encoder, const wchar_t** src, const wchar_t* srcEnd,
+                       char** dst, char* dstEnd, bool last);
+
+/** position of first wrong byte, length if all text is correct UTF-8 */
+size_t Utf8Validate (const char* chars, size_t length);
+
+/** add UTF-8 text to end of wide string, wrong sequences are replaced, return false if no memory */
+bool Utf8ToWString (WString* str, const char* chars, size_t length);
+/** add wide text to end of string as UTF-8, wrong chars are replaced, return false if no memory */
+bool Utf8FromWString (String* str, const wchar_t* chars, size_t length);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void Utf8Test();
+#endif // _DEBUG
+
+#endif // __UTF8_H
@@ -0,0 +1,352 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vector.h"
+#include "alloc.h"
+#include "ptrscan.h"
+
+
+#define VECTOR_CHECK_VALID                          \
+                if (!vector) return 0;              \
+                unsigned id = *(unsigned*)vector;   \
+                if (id != __VECTOR_ID) return 0;
+
+
+static bool VectorResize (Vector* vector, unsigned capacity)
+{
+    void** data = realloc(vector->data, capacity * sizeof(void*));
+    if (data == NULL && capacity > 0)
+        return false;
+
+    vector->data     = data;
+    vector->capacity = capacity;
+
+    return true;
+}
+
+/* grow twice, so push_back takes amortized O(1) */
+static bool VectorGrow (Vector* vector)
+{
+    if (vector->size < vector->capacity)
+        return true;
+
+    unsigned capacity = (vector->capacity) ? vector->capacity * 2 : VECTOR_MIN_CAPACITY;
+    return VectorResize(vector, capacity);
+}
+
+
+void VectorInit(void* mem)
+{
+    if (mem)
+    {
+        Vector* vector = mem;
+
+        /* already initialized? */
+        if (vector->__id == __VECTOR_ID)
+        {
+            VectorClear(vector);
+        }
+        else
+        {
+            memset(vector, 0, sizeof(Vector));
+
+            vector->__id          = __VECTOR_ID;
+
+            vector->front         = &VectorGetFirstValue;
+            vector->back          = &VectorGetLastValue;
+            vector->push_back     = &VectorAddElement;
+            vector->pop_back      = &VectorPopBack;
+            vector->at            = &VectorGetValueByNumber;
+            vector->clear         = &VectorClear;
+            vector->empty         = &VectorIsEmpty;
+            vector->reserve       = &VectorReserve;
+            vector->shrink_to_fit = &VectorShrinkToFit;
+        }
+    }
+}
+
+Vector* VectorCreate()
+{
+    Vector* vector = AllocMemory(ALLOC_TYPE_VECTOR, sizeof(Vector), 1);
+    if (vector == NULL)
+        return NULL;
+
+    vector->__id = 0;
+    VectorInit(vector);
+    vector->__alloc = true;
+
+    return vector;
+}
+
+void VectorClear(Vector* vector)
+{
+    VECTOR_CHECK_VALID
+
+    vector->size = 0;
+}
+
+/* release data of vector, called by delete() */
+static void VectorFinalize (void* object)
+{
+    Vector* vector = object;
+
+    free (vector->data);
+
+    vector->__id = 0;
+}
+
+static void __attribute__((constructor)) VectorRegister()
+{
+    AllocSetDestructor(ALLOC_TYPE_VECTOR, VectorFinalize);
+}
+
+void VectorDestroy (Vector** vector)
+{
+    if (!vector || !(*vector))
+        return;
+
+    /* memory of VectorInit is released by free() */
+    bool alloc = (*vector)->__alloc;
+    VectorFinalize(*vector);
+
+    if (alloc)
+        AllocFree(*vector);
+    else
+        free (*vector);
+    *vector = NULL;
+}
+
+bool VectorReserve (Vector* vector, unsigned capacity)
+{
+    VECTOR_CHECK_VALID
+
+    if (capacity <= vector->capacity)
+        return true;
+
+    return VectorResize(vector, capacity);
+}
+
+bool VectorShrinkToFit (Vector* vector)
+{
+    VECTOR_CHECK_VALID
+
+    if (vector->size == vector->capacity)
+        return true;
+
+    return VectorResize(vector, vector->size);
+}
+
+bool VectorAddElement (Vector* vector, void* value)
+{
+    VECTOR_CHECK_VALID
+
+    if (!VectorGrow(vector))
+        return false;
+
+    vector->data[vector->size++] = value;
+
+    return true;
+}
+
+bool VectorInsertElement (Vector* vector, unsigned numOfElement, void* value)
+{
+    VECTOR_CHECK_VALID
+
+    if (numOfElement > vector->size || !VectorGrow(vector))
+        return false;
+
+    memmove(&vector->data[numOfElement + 1],
+            &vector->data[numOfElement],
+            (vector->size - numOfElement) * sizeof(void*));
+    vector->data[numOfElement] = value;
+    ++vector->size;
+
+    return true;
+}
+
+void VectorDeleteElementByValue (Vector* vector, void* value)
+{
+    VECTOR_CHECK_VALID
+
+    if (value == NULL)
+        return;
+
+    int num = VectorGetNumberByValue(vector, value);
+    if (num >= 0)
+        VectorDeleteElementByNumber(vector, num);
+}
+
+void VectorDeleteElementByNumber (Vector* vector, unsigned numOfElement)
+{
+    VECTOR_CHECK_VALID
+
+    if (numOfElement >= vector->size)
+        return;
+
+    --vector->size;
+    memmove(&vector->data[numOfElement],
+            &vector->data[numOfElement + 1],
+            (vector->size - numOfElement) * sizeof(void*));
+}
+
+void VectorPopBack(Vector* vector)
+{
+    VECTOR_CHECK_VALID
+
+    if (vector->size > 0)
+        --vector->size;
+}
+
+void* VectorGetFirstValue(Vector* vector)
+{
+    VECTOR_CHECK_VALID
+
+    if (vector->size)
+        return vector->data[0];
+    return NULL;
+}
+
+void* VectorGetLastValue(Vector* vector)
+{
+    VECTOR_CHECK_VALID
+
+    if (vector->size)
+        return vector->data[vector->size - 1];
+    return NULL;
+}
+
+void* VectorGetValueByNumber (Vector* vector, unsigned numOfElement)
+{
+    VECTOR_CHECK_VALID
+
+    if (numOfElement >= vector->size)
+        return NULL;
+
+    return vector->data[numOfElement];
+}
+
+int VectorGetNumberByValue (Vector* vector, const void* value)
+{
+    if (!vector || !value)
+        return -1;
+
+    size_t i = PtrScanFind((void* const*)vector->data, vector->size, value);
+    return (i < vector->size) ? (int)i : -1;
+}
+
+unsigned VectorGetSize (Vector* vector)
+{
+    VECTOR_CHECK_VALID
+
+    return vector->size;
+}
+
+bool VectorIsEmpty(Vector* vector)
+{
+    VECTOR_CHECK_VALID
+
+    return (vector->size == 0);
+}
+
+void VectorSetValueByNumber(Vector* vector, unsigned numOfElement, void* value)
+{
+    VECTOR_CHECK_VALID
+
+    if (value == NULL || numOfElement >= vector->size)
+        return;
+
+    vector->data[numOfElement] = value;
+}
+
+
+
+/*  TESTS!!! */
+#ifdef _DEBUG
+#define MAX_VECTOR_SIZE 6000
+void VectorTest()
+{
+    printf ("Vector's tests started!!!\n");
+
+    int* array = malloc(MAX_VECTOR_SIZE*sizeof(int));
+    Vector* vector = VectorCreate();
+
+    /* test1 : fill vector */
+    printf ("--------test1--------\n");
+    for (unsigned i = 0; i < MAX_VECTOR_SIZE; ++i)
+    {
+        array[i] = i;
+        assert(VectorAddElement(vector, &array[i]));
+    }
+    assert(VectorGetSize(vector) == MAX_VECTOR_SIZE);
+    assert(vector->capacity >= MAX_VECTOR_SIZE);
+    assert(VectorGetFirstValue(vector) == &array[0]);
+    assert(VectorGetLastValue(vector)  == &array[MAX_VECTOR_SIZE - 1]);
+    printf ("size of vector : %d\n", VectorGetSize(vector));
+
+    /* test2 : get value by number */
+    printf ("--------test2--------\n");
+    for (unsigned i = 0; i < MAX_VECTOR_SIZE; ++i)
+        assert(VectorAt(vector, i) == &array[i]);
+    assert(VectorGetValueByNumber(vector, MAX_VECTOR_SIZE) == NULL);
+    assert(VectorGetNumberByValue(vector, &array[77]) == 77);
+    printf ("passed!\n");
+
+    /* test3 : insert and delete */
+    printf ("--------test3--------\n");
+    assert(VectorInsertElement(vector, 0, &array[5]));
+    assert(VectorGetFirstValue(vector) == &array[5]);
+    VectorDeleteElementByNumber(vector, 0);
+    VectorDeleteElementByValue(vector, &array[10]);
+    VectorPopBack(vector);
+    assert(VectorGetSize(vector) == MAX_VECTOR_SIZE - 2);
+    assert(VectorGetValueByNumber(vector, 10) == &array[11]);
+    assert(VectorGetNumberByValue(vector, &array[10]) == -1);
+    printf ("passed!\n");
+
+    /* test4 : reserve and shrink */
+    printf ("--------test4--------\n");
+    assert(VectorReserve(vector, 2 * MAX_VECTOR_SIZE));
+    assert(vector->capacity == 2 * MAX_VECTOR_SIZE);
+    assert(VectorShrinkToFit(vector));
+    assert(vector->capacity == vector->size);
+    assert(VectorGetValueByNumber(vector, 10) == &array[11]);
+    printf ("passed!\n");
+
+    /* test5 : clear and destroy */
+    printf ("--------test5--------\n");
+    VectorClear(vector);
+    assert(VectorIsEmpty(vector));
+    assert(VectorGetFirstValue(vector) == NULL);
+    VectorDestroy(&vector);
+    assert(vector == NULL);
+    printf ("passed!\n");
+
+    free(array);
+
+    /* passed */
+    printf ("--------result-------\n");
+    printf ("all vector's tests are passed!\n");
+}
+#endif // _DEBUG
@@ -0,0 +1,102 @@
+/*  
+    =============================================================================
+    Copyright [2017-2018] [Anton "Vuvk" Shcherbatykh]
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+    ==============================================================================
+*/
+
+
+#ifndef __VECTOR_H
+#define __VECTOR_H
+
+#define __VECTOR_ID 1952671062   /* 'V' 'e' 'c' 't' */
+
+#define VECTOR_MIN_CAPACITY 8    /* capacity after first push_back */
+
+/* dynamic array of values */
+typedef struct
+{
+    unsigned __id;
+    bool     __alloc;          /* memory of VectorCreate from AllocMemory, else of malloc */
+
+    unsigned size;
+    unsigned capacity;
+
+    void** data;               /* values, data[i] is value by number i */
+
+    void* (*front)(void* this);
+    void* (*back) (void* this);
+    bool  (*push_back)(void* this, void* value);
+    void  (*pop_back) (void* this);
+    bool  (*empty)(void* this);
+    void  (*clear)(void* this);
+    void* (*at)(void* this, unsigned position);
+    bool  (*reserve)(void* this, unsigned capacity);
+    bool  (*shrink_to_fit)(void* this);
+} Vector;
+
+/** value by number without checks, number must be less than size */
+#define VectorAt(vector, numOfElement) ((vector)->data[(numOfElement)])
+
+/** init memory as vector */
+void VectorInit(void* mem);
+/** create vector and return pointer to vector */
+Vector* VectorCreate ();
+/** delete all values in vector, memory is kept */
+void VectorClear (Vector* vector);
+/** clear and destroy vector */
+void VectorDestroy (Vector** vector);
+
+/** make room for capacity values, return false if not */
+bool VectorReserve (Vector* vector, unsigned capacity);
+/** free unused memory, return false if not */
+bool VectorShrinkToFit (Vector* vector);
+
+/** add value to end of vector, return false if not */
+bool VectorAddElement (Vector* vector, void* value);
+/** insert value before position (size - to the end), return false if not */
+bool VectorInsertElement (Vector* vector, unsigned numOfElement, void* value);
+/** delete value from vector */
+void VectorDeleteElementByValue (Vector* vector, void* value);
+/** delete value from vector by position in vector */
+void VectorDeleteElementByNumber (Vector* vector, unsigned numOfElement);
+/** delete last value from vector */
+void VectorPopBack(Vector* vector);
+
+/* GETTERS */
+/** get first value from vector */
+void* VectorGetFirstValue(Vector* vector);
+/** get last value from vector */
+void* VectorGetLastValue(Vector* vector);
+/** return value by number in vector */
+void* VectorGetValueByNumber (Vector* vector, unsigned numOfElement);
+/** return number of value in vector (if exists), else return -1 */
+int VectorGetNumberByValue (Vector* vector, const void* value);
+
+/** get count of values in vector */
+unsigned VectorGetSize (Vector* vector);
+/** check empty vector */
+bool VectorIsEmpty(Vector* vector);
+
+/* SETTERS */
+/** set value by position in vector */
+void VectorSetValueByNumber(Vector* vector, unsigned numOfElement, void* value);
+
+/* tests */
+#ifdef _DEBUG
+#include <assert.h>
+void VectorTest();
+#endif // _DEBUG
+
+#endif // __VECTOR_H